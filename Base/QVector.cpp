@@ -152,4 +152,43 @@ QVector QVector::DeNormal() const {
   return c;
 }
 
-}
\ No newline at end of file
+
+/**
+ * Copies a Q vector into the array, placing each harmonic at the position of its harmonic number.
+ * @param qvector Q vector
+ * @return reference to this Q vector array
+ */
+QVectorArray &QVectorArray::operator=(const QVector &qvector) {
+  norm_ = qvector.norm_;
+  n_ = qvector.n_;
+  sum_weights_ = qvector.sum_weights_;
+  bits_ = qvector.bits_;
+  unsigned int iq = 0;
+  for (unsigned int i = 0; i < kMaxNHarmonics; ++i) {
+    if (bits_.test(i) && iq < qvector.q_.size()) {
+      q_[i] = qvector.q_[iq];
+      ++iq;
+    } else {
+      q_[i] = QVec{0., 0.};
+    }
+  }
+  return *this;
+}
+
+/**
+ * Converts the array back into a Q vector.
+ * @return Q vector with the harmonics of the array
+ */
+QVector QVectorArray::ToQVector() const {
+  QVector qvector;
+  qvector.norm_ = norm_;
+  qvector.n_ = n_;
+  qvector.sum_weights_ = sum_weights_;
+  qvector.bits_ = bits_;
+  qvector.q_.reserve(bits_.count());
+  for (unsigned int i = 0; i < kMaxNHarmonics; ++i) {
+    if (bits_.test(i)) qvector.q_.push_back(q_[i]);
+  }
+  return qvector;
+}
+}
@@ -0,0 +1,89 @@
+// Flow Vector Correction Framework
+//
+// Copyright (C) 2018  Lukas Kreis, Ilya Selyuzhenkov
+// Contact: l.kreis@gsi.de; ilya.selyuzhenkov@gmail.com
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "StatsAccumulator.h"
+
+namespace Qn {
+
+StatsAccumulator::StatsAccumulator(const std::vector<Axis> &axes, size_type nsamples, Stats::Status status) :
+    axes_(axes),
+    status_(status),
+    n_samples_(nsamples) {
+  for (const auto &axis : axes_) {
+    n_bins_ *= axis.size();
+  }
+  sumwy_.resize(n_bins_, 0.);
+  sumwy2_.resize(n_bins_, 0.);
+  sumw_.resize(n_bins_, 0.);
+  sumw2_.resize(n_bins_, 0.);
+  entries_.resize(n_bins_, 0);
+  sample_sumwy_.resize(n_bins_*n_samples_, 0.);
+  sample_sumw_.resize(n_bins_*n_samples_, 0.);
+  sample_entries_.resize(n_bins_*n_samples_, 0);
+  event_wy_.resize(n_bins_, 0.);
+  event_w_.resize(n_bins_, 0.);
+  event_valid_.resize(n_bins_, 0);
+}
+
+void StatsAccumulator::Fill(const Product *products, const std::vector<size_type> &samples) {
+  // profile pass. Contributions of invalid bins are set to zero, which leaves the sums unchanged.
+  for (size_type ibin = 0; ibin < n_bins_; ++ibin) {
+    const auto &product = products[ibin];
+    const bool valid = product.validity;
+    const double wy = valid ? product.weight*product.result : 0.;
+    const double w = valid ? product.weight : 0.;
+    event_wy_[ibin] = wy;
+    event_w_[ibin] = w;
+    event_valid_[ibin] = valid;
+    sumwy_[ibin] += wy;
+    sumwy2_[ibin] += valid ? product.weight*product.result*product.result : 0.;
+    sumw_[ibin] += w;
+    sumw2_[ibin] += w*w;
+    entries_[ibin] += valid;
+  }
+  // subsample pass. Each sample row is contiguous in memory.
+  for (const auto sample : samples) {
+    auto sumwy = sample_sumwy_.data() + sample*n_bins_;
+    auto sumw = sample_sumw_.data() + sample*n_bins_;
+    auto entries = sample_entries_.data() + sample*n_bins_;
+    for (size_type ibin = 0; ibin < n_bins_; ++ibin) {
+      sumwy[ibin] += event_wy_[ibin];
+      sumw[ibin] += event_w_[ibin];
+      entries[ibin] += event_valid_[ibin];
+    }
+  }
+}
+
+DataContainerStats StatsAccumulator::GetDataContainer() const {
+  DataContainerStats result;
+  result.AddAxes(axes_);
+  std::vector<Sample> samples(n_samples_);
+  for (size_type ibin = 0; ibin < n_bins_; ++ibin) {
+    for (size_type isample = 0; isample < n_samples_; ++isample) {
+      auto index = isample*n_bins_ + ibin;
+      samples[isample].sumwy = sample_sumwy_[index];
+      samples[isample].sumw = sample_sumw_[index];
+      samples[isample].entries = sample_entries_[index];
+    }
+    Profile profile(sumwy_[ibin], sumwy2_[ibin], sumw_[ibin], sumw2_[ibin], entries_[ibin]);
+    Stats stats(SubSamples(samples), profile);
+    stats.SetStatus(status_);
+    result.At(ibin) = stats;
+  }
+  return result;
+}
+}
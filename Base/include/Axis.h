@@ -86,7 +86,7 @@ class Axis {
    * @param value for finding corresponding bin
    * @return bin index
    */
-  inline long FindBin(const float value) const {
+  inline long FindBin(const float value) const noexcept {
     long bin = 0;
     if (value < *bin_edges_.begin()) {
       bin = -1;
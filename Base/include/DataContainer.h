@@ -237,6 +237,30 @@ class DataContainer : public TObject {
     lambda(data_[index]);
   }
 
+/**
+ * Finds the linear index of the bin containing the coordinates.
+ * Does not allocate memory and does not throw.
+ * @param coordinates pointer to one coordinate per axis, in the order of the axes.
+ * @return linear index of the bin or -1 if the coordinates are outside of the axes.
+ */
+  long FindBin(const float *coordinates) const noexcept {
+    long offset = 0;
+    for (unsigned long i = 0; i < dimension_; ++i) {
+      auto bin = axes_[i].FindBin(coordinates[i]);
+      if (bin < 0) return -1;
+      offset += stride_[i + 1]*bin;
+    }
+    return offset;
+  }
+
+/**
+ * Finds the linear index of the bin containing the coordinates.
+ * Does not allocate memory and does not throw.
+ * @param coordinates one coordinate per axis, in the order of the axes.
+ * @return linear index of the bin or -1 if the coordinates are outside of the axes.
+ */
+  long FindBin(const std::vector<float> &coordinates) const noexcept { return FindBin(coordinates.data()); }
+
 /**
  * Get vector of axes
  * @return Vector of axes
@@ -331,21 +355,7 @@ class DataContainer : public TObject {
   DataContainer<T> Projection(const std::vector<std::string> axis_names,
                               Function &&lambda) const {
     DataContainer<T> projection;
-    unsigned long linearindex = 0;
-    std::vector<bool> isprojected;
-    isprojected.resize(axes_.size());
-    for (const auto &name : axis_names) {
-      bool bproj = false;
-      size_type iaxis = 0;
-      for (const auto &originalaxis : axes_) {
-        if (originalaxis.Name()==name) {
-          bproj = true;
-          break;
-        }
-        iaxis++;
-      }
-      isprojected.at(iaxis) = bproj;
-    }
+    auto isprojected = ProjectedAxes(axis_names);
     size_type iaxis = 0;
     for (const auto proj : isprojected) {
       if (proj) projection.AddAxis(axes_.at(iaxis));
@@ -357,23 +367,10 @@ class DataContainer : public TObject {
         projection.At(0) = lambda(projection.At(0), *bin);
       }
     } else {
-      std::vector<size_type> indices;
-      std::vector<size_type> projindices;
-      indices.reserve(dimension_);
-      projindices.resize(projection.dimension_);
-      // other bins
-      for (auto bin : data_) {
-        this->GetIndex(indices, linearindex);
-        size_type iprojbin = 0;
-        for (size_type i = 0; i < indices.size(); ++i) {
-          if (isprojected.at(i)) {
-            projindices.at(iprojbin) = indices.at(i);
-            ++iprojbin;
-          }
-        }
-        projection.At(projindices) = lambda(projection.At(projindices), bin);
-        ++linearindex;
-      }
+      auto strides = ProjectedStrides(projection, isprojected);
+      ForEachBin(strides, [this, &projection, &lambda](size_type ibin, const std::vector<size_type> &, long offset) {
+        projection.data_[offset] = lambda(projection.data_[offset], data_[ibin]);
+      });
     }
     return projection;
   }
@@ -389,6 +386,26 @@ class DataContainer : public TObject {
     return Projection(axis_names, lambda);
   }
 
+/**
+ * Maps the bins to the bins of the projection on a subset of axes.
+ * Allows to repeat a projection on containers with the same axes without looking up the axes again.
+ * @param axis_names subset of axes used for the projection.
+ * @return linear index in the projected datacontainer of each bin.
+ */
+  std::vector<size_type> ProjectionMap(const std::vector<std::string> &axis_names) const {
+    auto isprojected = ProjectedAxes(axis_names);
+    std::vector<long> strides(dimension_, 0);
+    long stride = 1;
+    for (auto iaxis = dimension_; iaxis-- > 0;) {
+      if (!isprojected[iaxis]) continue;
+      strides[iaxis] = stride;
+      stride *= axes_[iaxis].size();
+    }
+    std::vector<size_type> map(data_.size());
+    ForEachBin(strides, [&map](size_type ibin, const std::vector<size_type> &, long offset) { map[ibin] = offset; });
+    return map;
+  }
+
 /**
  * Projects datacontainer on a subset of axes
  * @tparam Function typename of function.
@@ -401,21 +418,7 @@ class DataContainer : public TObject {
   DataContainer<T> ProjectionExclude(const std::vector<std::string> axis_names,
                                      Function &&lambda, std::vector<int> exindices) const {
     DataContainer<T> projection;
-    size_type linearindex = 0;
-    std::vector<bool> isprojected;
-    isprojected.resize(axes_.size());
-    for (const auto &name : axis_names) {
-      bool bproj = false;
-      size_type iaxis = 0;
-      for (const auto &originalaxis : axes_) {
-        if (originalaxis.Name()==name) {
-          bproj = true;
-          break;
-        }
-        iaxis++;
-      }
-      isprojected.at(iaxis) = bproj;
-    }
+    auto isprojected = ProjectedAxes(axis_names);
     size_type iaxis = 0;
     for (const auto proj : isprojected) {
       if (proj) projection.AddAxis(axes_.at(iaxis));
@@ -427,26 +430,16 @@ class DataContainer : public TObject {
 
       }
     } else {
-      std::vector<size_type> indices;
-      std::vector<size_type> projindices;
-      indices.reserve(dimension_);
-      projindices.resize(projection.dimension_);
-      for (const auto &bin : data_) {
-        if (std::find(exindices.begin(), exindices.end(), linearindex)!=exindices.end()) {
-          ++linearindex;
-          continue;
-        }
-        this->GetIndex(indices, linearindex);
-        size_type iprojbin = 0;
-        for (size_type i = 0; i < indices.size(); ++i) {
-          if (isprojected.at(i)) {
-            projindices.at(iprojbin) = indices.at(i);
-            ++iprojbin;
-          }
-        }
-        projection.At(projindices) = lambda(projection.At(projindices), bin);
-        ++linearindex;
+      std::vector<bool> excluded(data_.size(), false);
+      for (const auto index : exindices) {
+        if (index >= 0 && static_cast<size_type>(index) < data_.size()) excluded[index] = true;
       }
+      auto strides = ProjectedStrides(projection, isprojected);
+      ForEachBin(strides,
+                 [this, &projection, &lambda, &excluded](size_type ibin, const std::vector<size_type> &, long offset) {
+                   if (excluded[ibin]) return;
+                   projection.data_[offset] = lambda(projection.data_[offset], data_[ibin]);
+                 });
     }
     return projection;
   }
@@ -485,21 +478,14 @@ class DataContainer : public TObject {
       }
       tmpaxisposition++;
     }
-    unsigned long index = 0;
-    std::vector<unsigned long> indices;
-    indices.reserve(dimension_);
-    for (const auto &bin : data_) {
-      GetIndex(indices, index);
-      auto binlow = axes_[axisposition].GetLowerBinEdge(indices[axisposition]);
-      auto binhigh = axes_[axisposition].GetUpperBinEdge(indices[axisposition]);
-      auto binmid = binlow + (binhigh - binlow)/2;
-      auto rebinnedindex = axis.FindBin(binmid);
-      if (rebinnedindex!=-1) {
-        indices[axisposition] = static_cast<unsigned long>(rebinnedindex);
-        selected.CallOnElement(indices, [&bin](T &element) { element = bin; });
-      }
-      ++index;
-    }
+    auto binmap = MapAxisBins(axisposition, axis);
+    std::vector<long> strides(selected.stride_.begin() + 1, selected.stride_.end());
+    const auto selectedstride = strides[axisposition];
+    strides[axisposition] = 0;
+    ForEachBin(strides, [&](size_type ibin, const std::vector<size_type> &indices, long offset) {
+      auto rebinnedindex = binmap[indices[axisposition]];
+      if (rebinnedindex!=-1) selected.data_[offset + selectedstride*rebinnedindex] = data_[ibin];
+    });
     if (axis.size()==1) {
       selected.axes_.erase(selected.axes_.begin() + axisposition);
       selected.stride_.resize(selected.axes_.size() + 1);
@@ -552,19 +538,16 @@ class DataContainer : public TObject {
       std::string errormsg = "Rebinned axis has overlapping bins." + rebinaxis.Name();
       throw std::logic_error(errormsg);
     }
-    unsigned long ibin = 0;
-    std::vector<size_type> indices;
-    indices.reserve(dimension_);
-    for (const auto &bin : data_) {
-      GetIndex(indices, ibin);
-      auto binlow = axes_[axisposition].GetLowerBinEdge(indices[axisposition]);
-      auto binhigh = axes_[axisposition].GetUpperBinEdge(indices[axisposition]);
-      auto binmid = binlow + (binhigh - binlow)/2;
-      auto rebinnedindex = rebinaxis.FindBin(binmid);
-      indices[axisposition] = static_cast<unsigned long>(rebinnedindex);
-      if (rebinnedindex!=-1) rebinned.At(indices) = lambda(rebinned.At(indices), bin);
-      ++ibin;
-    }
+    auto binmap = MapAxisBins(axisposition, rebinaxis);
+    std::vector<long> strides(rebinned.stride_.begin() + 1, rebinned.stride_.end());
+    const auto rebinnedstride = strides[axisposition];
+    strides[axisposition] = 0;
+    ForEachBin(strides, [&](size_type ibin, const std::vector<size_type> &indices, long offset) {
+      auto rebinnedindex = binmap[indices[axisposition]];
+      if (rebinnedindex==-1) return;
+      auto &element = rebinned.data_[offset + rebinnedstride*rebinnedindex];
+      element = lambda(element, data_[ibin]);
+    });
     return rebinned;
   }
 
@@ -586,11 +569,12 @@ class DataContainer : public TObject {
   template<typename Function>
   DataContainer<T> Filter(Function &&lambda) const {
     DataContainer<T> filtered(*this);
-    std::vector<size_type> indices(dimension_);
-    for (unsigned int ibin = 0; ibin < data_.size(); ++ibin) {
-      GetIndex(indices, ibin);
-      if (!lambda(axes_, indices)) filtered.data_[ibin] = T();
-    }
+    std::vector<size_type> binindices(dimension_);
+    ForEachBin(std::vector<long>(dimension_, 0),
+               [&](size_type ibin, const std::vector<size_type> &indices, long) {
+                 binindices = indices;
+                 if (!lambda(axes_, binindices)) filtered.data_[ibin] = T();
+               });
     return filtered;
   }
 
@@ -606,8 +590,6 @@ class DataContainer : public TObject {
   template<typename Function>
   DataContainer<T> Apply(const DataContainer<T> &data, Function &&lambda) const {
     DataContainer<T> result;
-    std::vector<size_type> indices;
-    unsigned long index = 0;
     if (axes_.size() > data.axes_.size()) {
       for (unsigned long iaxis = 0; iaxis < data.axes_.size() - 1; ++iaxis) {
         if (axes_[iaxis].Name()!=data.axes_[iaxis].Name()) {
@@ -616,12 +598,12 @@ class DataContainer : public TObject {
         }
       }
       result.AddAxes(axes_);
-      indices.reserve(dimension_);
-      for (const auto &bin_a : data_) {
-        GetIndex(indices, index);
-        result.data_[index] = lambda(bin_a, data.At(indices));
-        ++index;
-      }
+      // the axes beyond the ones of the smaller container do not contribute to its linear index.
+      std::vector<long> strides(dimension_, 0);
+      std::copy(data.stride_.begin() + 1, data.stride_.end(), strides.begin());
+      ForEachBin(strides, [&](size_type ibin, const std::vector<size_type> &, long offset) {
+        result.data_[ibin] = lambda(data_[ibin], data.data_.at(offset));
+      });
     } else {
       for (unsigned long iaxis = axes_.size() - 1; iaxis > 0; --iaxis) {
         if (axes_[iaxis].Name()!=data.axes_[iaxis].Name()) {
@@ -630,12 +612,11 @@ class DataContainer : public TObject {
         }
       }
       result.AddAxes(data.axes_);
-      indices.reserve(data.dimension_);
-      for (const auto &bin_b : data.data_) {
-        data.GetIndex(indices, index);
-        result.data_[index] = lambda(At(indices), bin_b);
-        ++index;
-      }
+      std::vector<long> strides(data.dimension_, 0);
+      std::copy(stride_.begin() + 1, stride_.end(), strides.begin());
+      data.ForEachBin(strides, [&](size_type ibin, const std::vector<size_type> &, long offset) {
+        result.data_[ibin] = lambda(data_.at(offset), data.data_[ibin]);
+      });
     }
     return result;
   }
@@ -714,18 +695,7 @@ class DataContainer : public TObject {
  * @return linear index
  */
   long GetLinearIndex(const std::vector<float> &coordinates) const {
-    typename std::vector<size_type> indices;
-    unsigned long axisindex = 0;
-    for (const auto &axis : axes_) {
-      auto bin = axis.FindBin(coordinates[axisindex]);
-      if (bin >= (unsigned int) axis.size() || bin < 0) {
-        return -1;
-      } else {
-        indices.push_back(static_cast<unsigned long &&>(bin));
-        axisindex++;
-      }
-    }
-    return GetLinearIndex(indices);
+    return FindBin(coordinates);
   }
 
 /**
@@ -746,6 +716,84 @@ class DataContainer : public TObject {
     return indices;
   }
 
+/**
+ * Walks all bins in the order of the linearized vector. The multidimensional indices and the linear index in a second
+ * container are advanced incrementally from bin to bin instead of being recalculated for each bin.
+ * @tparam Function type of function
+ * @param strides stride of each axis in the second container. Zero for axes which are not part of it.
+ * @param function called with the linear index, the indices and the linear index in the second container of each bin.
+ */
+  template<typename Function>
+  void ForEachBin(const std::vector<long> &strides, Function &&function) const {
+    std::vector<size_type> indices(dimension_, 0);
+    long offset = 0;
+    for (size_type ibin = 0; ibin < data_.size(); ++ibin) {
+      function(ibin, indices, offset);
+      for (auto iaxis = dimension_; iaxis-- > 0;) {
+        offset += strides[iaxis];
+        if (++indices[iaxis] < axes_[iaxis].size()) break;
+        offset -= strides[iaxis]*static_cast<long>(axes_[iaxis].size());
+        indices[iaxis] = 0;
+      }
+    }
+  }
+
+/**
+ * Finds the axes which are part of a projection.
+ * @param axis_names names of the axes used for the projection.
+ * @return flag for each axis, which is true if the axis is part of the projection.
+ */
+  std::vector<bool> ProjectedAxes(const std::vector<std::string> &axis_names) const {
+    std::vector<bool> isprojected;
+    isprojected.resize(axes_.size());
+    for (const auto &name : axis_names) {
+      bool bproj = false;
+      size_type iaxis = 0;
+      for (const auto &originalaxis : axes_) {
+        if (originalaxis.Name()==name) {
+          bproj = true;
+          break;
+        }
+        iaxis++;
+      }
+      isprojected.at(iaxis) = bproj;
+    }
+    return isprojected;
+  }
+
+/**
+ * Calculates the strides of the axes in the projection.
+ * @param projection container holding the projected axes.
+ * @param isprojected flags of the axes which are part of the projection.
+ * @return stride of each axis in the projection. Zero for the axes which are projected out.
+ */
+  std::vector<long> ProjectedStrides(const DataContainer<T> &projection, const std::vector<bool> &isprojected) const {
+    std::vector<long> strides(dimension_, 0);
+    size_type iprojaxis = 0;
+    for (size_type iaxis = 0; iaxis < dimension_; ++iaxis) {
+      if (isprojected[iaxis]) strides[iaxis] = projection.stride_[++iprojaxis];
+    }
+    return strides;
+  }
+
+/**
+ * Maps the bins of an axis to the bins of a new axis containing their centers.
+ * @param axisposition position of the axis.
+ * @param newaxis new axis.
+ * @return bin in the new axis for each bin of the axis. -1 if the center is outside of the new axis.
+ */
+  std::vector<long> MapAxisBins(size_type axisposition, const Axis &newaxis) const {
+    const auto &axis = axes_[axisposition];
+    std::vector<long> binmap(axis.size());
+    for (size_type ibin = 0; ibin < axis.size(); ++ibin) {
+      auto binlow = axis.GetLowerBinEdge(ibin);
+      auto binhigh = axis.GetUpperBinEdge(ibin);
+      auto binmid = binlow + (binhigh - binlow)/2;
+      binmap[ibin] = newaxis.FindBin(binmid);
+    }
+    return binmap;
+  }
+
 /**
  * Calculates offset for transformation into one dimensional vector.
  */
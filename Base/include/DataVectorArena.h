@@ -0,0 +1,136 @@
+// Flow Vector Correction Framework
+//
+// Copyright (C) 2018  Lukas Kreis, Ilya Selyuzhenkov
+// Contact: l.kreis@gsi.de; ilya.selyuzhenkov@gmail.com
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLOW_DATAVECTORARENA_H
+#define FLOW_DATAVECTORARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Qn {
+
+/**
+ * @brief Event-scoped storage of the data vectors of a binned detector.
+ * Data vectors are appended in the order in which they are filled, together with their bin.
+ * SortByBin() arranges them in contiguous azimuthal angle and weight buffers with per-bin offsets.
+ * Clear() keeps the allocated capacity, so in steady state no heap allocations happen.
+ */
+class DataVectorArena {
+ public:
+  using size_type = std::size_t;
+
+  explicit DataVectorArena(size_type nbins = 1) { SetNumberOfBins(nbins); }
+
+  /**
+   * Sets the number of bins and clears the data vectors.
+   * @param nbins number of bins
+   */
+  void SetNumberOfBins(size_type nbins) {
+    offsets_.assign(nbins + 1, 0);
+    Clear();
+  }
+
+  /**
+   * Clears the data vectors of the current event. The capacity is kept.
+   */
+  void Clear() {
+    filled_bin_.clear();
+    filled_phi_.clear();
+    filled_weight_.clear();
+    std::fill(offsets_.begin(), offsets_.end(), 0);
+  }
+
+  /**
+   * Adds a data vector to a bin.
+   * @param bin linear bin index
+   * @param phi azimuthal angle
+   * @param weight weight
+   */
+  void Add(size_type bin, float phi, float weight) {
+    filled_bin_.push_back(bin);
+    filled_phi_.push_back(phi);
+    filled_weight_.push_back(weight);
+  }
+
+  /**
+   * Arranges the data vectors in contiguous per-bin ranges.
+   * The order in which the data vectors were added is kept within each bin.
+   */
+  void SortByBin() {
+    std::fill(offsets_.begin(), offsets_.end(), 0);
+    for (auto bin : filled_bin_) {
+      ++offsets_[bin + 1];
+    }
+    for (size_type ibin = 1; ibin < offsets_.size(); ++ibin) {
+      offsets_[ibin] += offsets_[ibin - 1];
+    }
+    phi_.resize(filled_phi_.size());
+    weight_.resize(filled_weight_.size());
+    position_.assign(offsets_.begin(), offsets_.end() - 1);
+    for (size_type i = 0; i < filled_bin_.size(); ++i) {
+      auto position = position_[filled_bin_[i]]++;
+      phi_[position] = filled_phi_[i];
+      weight_[position] = filled_weight_[i];
+    }
+  }
+
+  /**
+   * Returns the number of bins.
+   * @return number of bins
+   */
+  size_type size() const { return offsets_.size() - 1; }
+
+  /**
+   * Returns the number of data vectors of the current event.
+   * @return number of data vectors
+   */
+  size_type GetNumberOfEntries() const { return filled_bin_.size(); }
+
+  /**
+   * Returns the number of data vectors in a bin. Valid after SortByBin().
+   * @param bin linear bin index
+   * @return number of data vectors
+   */
+  size_type BinSize(size_type bin) const { return offsets_[bin + 1] - offsets_[bin]; }
+
+  /**
+   * Returns the azimuthal angles of the data vectors in a bin. Valid after SortByBin().
+   * @param bin linear bin index
+   * @return pointer to the first of BinSize(bin) angles
+   */
+  const float *Phi(size_type bin) const { return phi_.data() + offsets_[bin]; }
+
+  /**
+   * Returns the weights of the data vectors in a bin. Valid after SortByBin().
+   * @param bin linear bin index
+   * @return pointer to the first of BinSize(bin) weights
+   */
+  const float *Weight(size_type bin) const { return weight_.data() + offsets_[bin]; }
+
+ private:
+  std::vector<size_type> filled_bin_; ///< bin of each data vector in fill order
+  std::vector<float> filled_phi_; ///< azimuthal angle of each data vector in fill order
+  std::vector<float> filled_weight_; ///< weight of each data vector in fill order
+  std::vector<size_type> offsets_; ///< offset of the first data vector of each bin. Last element is the total.
+  std::vector<size_type> position_; ///< temporary insert position of each bin
+  std::vector<float> phi_; ///< azimuthal angles sorted by bin
+  std::vector<float> weight_; ///< weights sorted by bin
+};
+}
+
+#endif //FLOW_DATAVECTORARENA_H
@@ -39,6 +39,13 @@ class Profile {
 
   Profile() = default;
 
+  Profile(double sumwy, double sumwy2, double sumw, double sumw2, int entries) :
+      sumwy_(sumwy),
+      sumwy2_(sumwy2),
+      sumw_(sumw),
+      sumw2_(sumw2),
+      entries_(entries) {}
+
   virtual ~Profile() = default;
 
   inline void Fill(const Product &prod) {
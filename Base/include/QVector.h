@@ -19,8 +19,11 @@
 #define FLOW_QVECTOR_H
 
 #include <vector>
+#include <array>
 #include <bitset>
+#include <cassert>
 #include <cmath>
+#include <type_traits>
 
 #include "Rtypes.h"
 
@@ -100,6 +103,45 @@ class QVector {
   /// \endcond
 };
 
+/**
+ * @class QVectorArray
+ * @brief Trivially copyable Q-vector with the harmonics stored in place.
+ * The harmonics are indexed directly by the harmonic number, which makes the access a plain load.
+ * Used in the correlation step, where the harmonics are accessed in the innermost loop.
+ * Reading a harmonic which is not part of the Q-vector is an error, which is only checked in debug builds.
+ */
+struct QVectorArray {
+  using Normalization = QVector::Normalization;
+  static constexpr int kMaxNHarmonics = QVector::kMaxNHarmonics;
+
+  QVectorArray() = default;
+  explicit QVectorArray(const QVector &qvector) { *this = qvector; }
+
+  QVectorArray &operator=(const QVector &qvector);
+  QVector ToQVector() const;
+
+  inline float x(const unsigned int i) const {
+    assert(i < kMaxNHarmonics && bits_.test(i) && "harmonic not in range.");
+    return q_[i].x;
+  }
+  inline float y(const unsigned int i) const {
+    assert(i < kMaxNHarmonics && bits_.test(i) && "harmonic not in range.");
+    return q_[i].y;
+  }
+  inline float mag(const unsigned int i) const { return sqrt(x(i)*x(i) + y(i)*y(i)); }
+  inline float sumweights() const { return sum_weights_; }
+  inline float n() const { return n_; }
+  inline Normalization GetNorm() const { return norm_; }
+
+  Normalization norm_ = Normalization::NONE; ///< normalization method
+  int n_ = 0;                                ///< number of data vectors contributing to the q vector
+  float sum_weights_ = 0.0;                  ///< sum of weights
+  std::bitset<kMaxNHarmonics> bits_{};       ///< Bitset for keeping track of the harmonics
+  std::array<QVec, kMaxNHarmonics> q_{};     ///< array of qvectors indexed by the harmonic number
+};
+
+static_assert(std::is_trivially_copyable<QVectorArray>::value, "QVectorArray needs to be trivially copyable.");
+
 namespace detail {
 template<class T>
 T &FUN(T &t) noexcept { return t; }
@@ -116,7 +158,7 @@ class QVectorPtr {
  public:
   QVectorPtr() = default;
   // construct/copy/destroy
-  QVectorPtr(const QVector &ref) noexcept : qvector_(&ref) {}
+  QVectorPtr(const QVectorArray &ref) noexcept : qvector_(&ref) {}
   QVectorPtr(const QVectorPtr &) noexcept = default;
   // assignment
   QVectorPtr &operator=(const QVectorPtr &x) noexcept = default;
@@ -127,10 +169,10 @@ class QVectorPtr {
   inline float sumweights() const { return qvector_->sumweights(); }
   inline float n() const { return qvector_->n(); }
   inline Normalization GetNorm() const { return qvector_->GetNorm(); }
-  inline QVector Normal(Normalization norm) const { return qvector_->Normal(norm); }
-  inline QVector DeNormal() const { return qvector_->DeNormal(); }
+  inline QVector Normal(Normalization norm) const { return qvector_->ToQVector().Normal(norm); }
+  inline QVector DeNormal() const { return qvector_->ToQVector().DeNormal(); }
  private:
-  const QVector *qvector_ = nullptr;
+  const QVectorArray *qvector_ = nullptr;
 };
 
 }
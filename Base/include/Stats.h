@@ -48,6 +48,8 @@ class Stats {
 
   Stats() = default;
 
+  Stats(SubSamples subsamples, Profile profile) : subsamples_(std::move(subsamples)), profile_(profile) {}
+
   virtual ~Stats() = default;
 
   Stats(const Stats &stats)
@@ -0,0 +1,87 @@
+// Flow Vector Correction Framework
+//
+// Copyright (C) 2018  Lukas Kreis, Ilya Selyuzhenkov
+// Contact: l.kreis@gsi.de; ilya.selyuzhenkov@gmail.com
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLOW_STATSACCUMULATOR_H
+#define FLOW_STATSACCUMULATOR_H
+
+#include <vector>
+
+#include "DataContainer.h"
+#include "Product.h"
+#include "Stats.h"
+
+namespace Qn {
+
+/**
+ * @brief Accumulates the statistics of all bins of a DataContainerStats in contiguous arrays.
+ * The profile sums are stored per bin and the subsample sums in a samples x bins array.
+ * A single event result is filled to all bins in one pass, which keeps the fill cache-resident
+ * and allows the compiler to vectorise the loops over the bins.
+ * The accumulated sums are identical to filling each Stats bin separately.
+ */
+class StatsAccumulator {
+ public:
+  using size_type = std::size_t;
+
+  StatsAccumulator() = default;
+
+  /**
+   * Constructor
+   * @param axes axes of the resulting DataContainerStats
+   * @param nsamples number of subsamples
+   * @param status status of the resulting Stats
+   */
+  StatsAccumulator(const std::vector<Axis> &axes, size_type nsamples, Stats::Status status);
+
+  /**
+   * Fills the result of one event to all bins.
+   * Invalid products are not taken into account.
+   * @param products pointer to the first of size() products ordered like the bins of the container.
+   * @param samples sample ids of the event. Sample ids are repeated according to their multiplicity.
+   */
+  void Fill(const Product *products, const std::vector<size_type> &samples);
+
+  /**
+   * Converts the accumulated sums to a DataContainerStats.
+   * @return DataContainerStats with the axes of the accumulator.
+   */
+  DataContainerStats GetDataContainer() const;
+
+  size_type size() const { return n_bins_; }
+
+  size_type GetNumberOfSamples() const { return n_samples_; }
+
+ private:
+  std::vector<Axis> axes_; ///< axes of the resulting DataContainerStats
+  Stats::Status status_ = Stats::Status::REFERENCE; ///< status of the resulting Stats
+  size_type n_bins_ = 1; ///< number of bins
+  size_type n_samples_ = 0; ///< number of subsamples
+  std::vector<double> sumwy_; ///< profile sum w y per bin
+  std::vector<double> sumwy2_; ///< profile sum w y^2 per bin
+  std::vector<double> sumw_; ///< profile sum w per bin
+  std::vector<double> sumw2_; ///< profile sum w^2 per bin
+  std::vector<int> entries_; ///< profile entries per bin
+  std::vector<double> sample_sumwy_; ///< subsample sum w y. index: sample*n_bins_ + bin
+  std::vector<double> sample_sumw_; ///< subsample sum w. index: sample*n_bins_ + bin
+  std::vector<int> sample_entries_; ///< subsample entries. index: sample*n_bins_ + bin
+  std::vector<double> event_wy_; ///< w y of the current event per bin
+  std::vector<double> event_w_; ///< w of the current event per bin
+  std::vector<int> event_valid_; ///< validity of the current event per bin
+};
+}
+
+#endif //FLOW_STATSACCUMULATOR_H
@@ -15,8 +15,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <thread>
+
 #include "CorrectionManager.h"
 #include "TList.h"
+#include "TH1.h"
+#include "THnBase.h"
+#include "TROOT.h"
 
 void Qn::CorrectionManager::SetCorrectionSteps(const std::string &name,
                                                std::function<void(DetectorConfiguration *config)> config) {
@@ -31,6 +36,44 @@ void Qn::CorrectionManager::SetCorrectionSteps(const std::string &name,
   }
 }
 
+void Qn::CorrectionManager::SetDifferentialMode(const std::string &name) {
+  if (detectors_track_.find(name)!=detectors_track_.end()) {
+    auto binname = name + "_bin";
+    auto bin = var_manager_->CreateInternalVariable(binname);
+    detectors_track_.at(name)->SetDifferential(bin, var_manager_->FindNum(binname));
+  } else if (detectors_channel_.find(name)!=detectors_channel_.end()) {
+    throw std::logic_error(name + " is a channel detector. Only track detectors support the differential mode.");
+  } else {
+    throw std::out_of_range(
+        name + " was not found in the list of detectors. It needs to be created before it can be configured.");
+  }
+}
+
+void Qn::CorrectionManager::FillTrackingDetectors(std::size_t ntracks,
+                                                  const std::vector<std::pair<std::string, const double *>> &columns) {
+  if (!event_passed_cuts_ || ntracks==0) return;
+  columns_.Clear();
+  columns_.SetSize(ntracks);
+  for (const auto &column : columns) {
+    columns_.SetColumn(var_manager_->FindVariable(column.first), column.second);
+  }
+  var_manager_->EvaluateDerivedVariables(columns_);
+  for (auto &dp : detectors_track_) {
+    dp.second->FillData(columns_);
+  }
+}
+
+void Qn::CorrectionManager::SetStreamingMode(const std::string &name) {
+  if (detectors_track_.find(name)!=detectors_track_.end()) {
+    detectors_track_.at(name)->SetStreaming();
+  } else if (detectors_channel_.find(name)!=detectors_channel_.end()) {
+    throw std::logic_error(name + " is a channel detector. Only track detectors support the streaming mode.");
+  } else {
+    throw std::out_of_range(
+        name + " was not found in the list of detectors. It needs to be created before it can be configured.");
+  }
+}
+
 void Qn::CorrectionManager::AddHisto1D(const std::string &name,
                                        const Qn::Axis &axis,
                                        const std::string &weightname) {
@@ -99,6 +142,7 @@ void Qn::CorrectionManager::Initialize(TFile *in_calibration_file_) {
 }
 
 void Qn::CorrectionManager::ProcessEvent() {
+  var_manager_->EvaluateDerivedVariables();
   if (event_cuts_->CheckCuts(0)) event_passed_cuts_ = true;
   if (event_passed_cuts_) {
     event_cuts_->FillReport();
@@ -113,34 +157,34 @@ void Qn::CorrectionManager::ProcessQnVectors() {
     }
     int nbinsrunning = 0;
     for (auto &pair : detectors_track_) {
-      auto &detector = pair.second->GetDataContainer();
-      int ibin = 0;
-      for (const auto &bin : *detector) {
-        auto detectorid = nbinsrunning + ibin;
-        ++ibin;
-        int idata = 0;
-        for (const auto &data : bin) {
-          qnc_calculator_.AddDataVector(detectorid, data.phi, data.weight, idata);
-          ++idata;
+      auto &datavectors = pair.second->GetDataVectors();
+      datavectors.SortByBin();
+      // differential detectors use a single correction detector and pass the bin as data vector id.
+      auto differential = pair.second->IsDifferential();
+      // streaming detectors already accumulated the Q vector sums of each bin.
+      auto streaming = pair.second->IsStreaming();
+      for (std::size_t ibin = 0; ibin < datavectors.size(); ++ibin) {
+        auto detectorid = differential ? nbinsrunning : nbinsrunning + ibin;
+        if (streaming) {
+          qnc_calculator_.AddQnVectorSums(detectorid, &pair.second->GetQnVectorSums()[ibin], differential ? ibin : -1);
+        } else {
+          qnc_calculator_.AddDataVectors(detectorid, datavectors.BinSize(ibin), datavectors.Phi(ibin),
+                                         datavectors.Weight(ibin), differential ? ibin : -1);
         }
       }
       pair.second->FillReport();
-      nbinsrunning += detector->size();
+      nbinsrunning += differential ? 1 : datavectors.size();
     }
     for (auto &pair : detectors_channel_) {
-      auto &detector = pair.second->GetDataContainer();
-      int ibin = 0;
-      for (const auto &bin : *detector) {
+      auto &datavectors = pair.second->GetDataVectors();
+      datavectors.SortByBin();
+      for (std::size_t ibin = 0; ibin < datavectors.size(); ++ibin) {
         auto detectorid = nbinsrunning + ibin;
-        ++ibin;
-        int idata = 0;
-        for (const auto &data : bin) {
-          qnc_calculator_.AddDataVector(detectorid, data.phi, data.weight, idata);
-          ++idata;
-        }
+        qnc_calculator_.AddDataVectors(detectorid, datavectors.BinSize(ibin), datavectors.Phi(ibin),
+                                       datavectors.Weight(ibin));
       }
       pair.second->FillReport();
-      nbinsrunning += detector->size();
+      nbinsrunning += datavectors.size();
     }
     var_manager_->FillToQnCorrections(qnc_calculator_.GetDataPointer());
     qnc_calculator_.ProcessEvent();
@@ -191,6 +235,90 @@ TList *Qn::CorrectionManager::GetEventAndDetectorQAList() {
   return qa_list_;
 }
 
+void Qn::CorrectionManager::Merge(CorrectionManager &replica) {
+  MergeLists(GetCalibrationList(), replica.GetCalibrationList());
+  MergeLists(GetCalibrationQAList(), replica.GetCalibrationQAList());
+  MergeLists(qnc_calculator_.GetNveQAHistogramsList(), replica.qnc_calculator_.GetNveQAHistogramsList());
+  // the report lists only reference the histograms owned by the detectors and the event cuts.
+  auto merge_detectors = [](MapDetectors &target, MapDetectors &source) {
+    for (auto &pair : target) {
+      auto targetlist = pair.second->GetReportList();
+      auto sourcelist = source.at(pair.first)->GetReportList();
+      MergeLists(targetlist, sourcelist);
+      DeleteSublists(targetlist);
+      DeleteSublists(sourcelist);
+    }
+  };
+  merge_detectors(detectors_track_, replica.detectors_track_);
+  merge_detectors(detectors_channel_, replica.detectors_channel_);
+  auto targetevent = new TList();
+  auto sourceevent = new TList();
+  event_cuts_->AddToList(targetevent);
+  replica.event_cuts_->AddToList(sourceevent);
+  for (std::size_t i = 0; i < event_histograms_.size(); ++i) {
+    event_histograms_[i]->AddToList(targetevent);
+    replica.event_histograms_[i]->AddToList(sourceevent);
+  }
+  MergeLists(targetevent, sourceevent);
+  DeleteSublists(targetevent);
+  DeleteSublists(sourceevent);
+}
+
+void Qn::CorrectionManager::RunReplicas(const std::vector<CorrectionManager *> &replicas,
+                                        const std::function<void(CorrectionManager &, std::size_t)> &loop) {
+  ROOT::EnableThreadSafety();
+  std::vector<std::thread> threads;
+  threads.reserve(replicas.size());
+  for (std::size_t i = 0; i < replicas.size(); ++i) {
+    threads.emplace_back([&replicas, &loop, i]() {
+      loop(*replicas[i], i);
+      replicas[i]->Finalize();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (std::size_t i = 1; i < replicas.size(); ++i) {
+    replicas.front()->Merge(*replicas[i]);
+  }
+}
+
+/**
+ * Helper function to add the histograms of a list to the histograms of the same name in the target list.
+ * Sublists are merged recursively. Objects missing in the target, e.g. the lists of correction periods which were only
+ * processed by the replica, are copied.
+ * @param target list receiving the histograms
+ * @param source list of the replica
+ */
+void Qn::CorrectionManager::MergeLists(TList *target, TList *source) {
+  if (!target || !source) return;
+  TIter next(source);
+  while (auto object = next()) {
+    auto existing = target->FindObject(object->GetName());
+    if (!existing) {
+      target->Add(object->Clone());
+    } else if (existing->InheritsFrom(TList::Class()) && object->InheritsFrom(TList::Class())) {
+      MergeLists(static_cast<TList *>(existing), static_cast<TList *>(object));
+    } else if (existing->InheritsFrom(THnBase::Class()) && object->InheritsFrom(THnBase::Class())) {
+      static_cast<THnBase *>(existing)->Add(static_cast<THnBase *>(object));
+    } else if (existing->InheritsFrom(TH1::Class()) && object->InheritsFrom(TH1::Class())) {
+      static_cast<TH1 *>(existing)->Add(static_cast<TH1 *>(object));
+    }
+  }
+}
+
+/**
+ * Helper function to delete a list together with its sublists, leaving the histograms untouched.
+ * @param list list to be deleted
+ */
+void Qn::CorrectionManager::DeleteSublists(TList *list) {
+  TIter next(list);
+  while (auto object = next()) {
+    if (object->InheritsFrom(TList::Class())) DeleteSublists(static_cast<TList *>(object));
+  }
+  delete list;
+}
+
 void Qn::CorrectionManager::CalculateCorrectionAxis() {
   qnc_varset_ = std::make_unique<EventClassVariablesSet>(correction_axes_.size());
   for (const auto &axis : correction_axes_) {
@@ -210,21 +338,26 @@ void Qn::CorrectionManager::CreateDetectors() {
   int nbinsrunning = 0;
   for (auto &pair : detectors_track_) {
     auto &detector = pair.second;
-    for (unsigned int ibin = 0; ibin < detector->GetDataContainer()->size(); ++ibin) {
+    if (detector->IsDifferential()) {
+      qnc_calculator_.AddDetector(detector->GenerateDetector(nbinsrunning, 0, qnc_varset_.get()));
+      ++nbinsrunning;
+      continue;
+    }
+    for (unsigned int ibin = 0; ibin < detector->GetDataVectors().size(); ++ibin) {
       auto globalid = nbinsrunning + ibin;
       auto frameworkdetector = detector->GenerateDetector(globalid, ibin, qnc_varset_.get());
       qnc_calculator_.AddDetector(frameworkdetector);
     }
-    nbinsrunning += detector->GetDataContainer()->size();
+    nbinsrunning += detector->GetDataVectors().size();
   }
   for (auto &pair : detectors_channel_) {
     auto &detector = pair.second;
-    for (unsigned int ibin = 0; ibin < detector->GetDataContainer()->size(); ++ibin) {
+    for (unsigned int ibin = 0; ibin < detector->GetDataVectors().size(); ++ibin) {
       auto globalid = nbinsrunning + ibin;
       auto frameworkdetector = detector->GenerateDetector(globalid, ibin, qnc_varset_.get());
       qnc_calculator_.AddDetector(frameworkdetector);
     }
-    nbinsrunning += detector->GetDataContainer()->size();
+    nbinsrunning += detector->GetDataVectors().size();
   }
 }
 
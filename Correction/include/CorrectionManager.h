@@ -20,6 +20,8 @@
 
 #include <string>
 #include <map>
+#include <functional>
+#include <vector>
 
 #include "ROOT/RMakeUnique.hxx"
 #include "ROOT/RIntegerSequence.hxx"
@@ -28,6 +30,7 @@
 #include "Detector.h"
 #include "VariableManager.h"
 #include "VariableCutBase.h"
+#include "VariableCutExpression.h"
 #include "CorrectionProfile3DCorrelations.h"
 #include "CorrectionProfileCorrelationComponents.h"
 #include "DetectorConfigurationChannels.h"
@@ -52,6 +55,7 @@ class CorrectionManager {
       : event_cuts_(new Cuts()),
         var_manager_(new VariableManager()) {
     var_manager_->CreateVariableOnes();
+    columns_ = VariableColumns(var_manager_->GetVariableContainer());
   }
 
   /**
@@ -64,6 +68,22 @@ class CorrectionManager {
     var_manager_->CreateVariable(name, id, length);
   }
 
+  /**
+   * @brief Adds a variable computed from other variables.
+   * It is evaluated once per event, per track and per batch of tracks before it is used.
+   * Detectors, cuts, histograms and correction axes refer to it by name.
+   * Template parameters are automatically deduced.
+   * @tparam N number of input variables
+   * @tparam FUNCTION type of function
+   * @param name Name of the variable
+   * @param names array of names of the input variables
+   * @param func function of signature double(double...) computing the variable from the input variables.
+   */
+  template<std::size_t N, typename FUNCTION>
+  void AddDerivedVariable(const std::string &name, const char *const (&names)[N], FUNCTION &&func) {
+    var_manager_->CreateDerivedVariable(name, names, std::forward<FUNCTION>(func));
+  }
+
   /**
    * Adds a axis used for correction.
    * @param axis Axis used for correction. The name of the axis corresponds to the name of a variable.
@@ -137,14 +157,20 @@ class CorrectionManager {
       arr[i] = var_manager_->FindVariable(n);
       ++i;
     }
-    auto cut = MakeUniqueNDimCut(arr, lambda);
-    if (detectors_track_.find(name)!=detectors_track_.end()) {
-      detectors_track_.at(name)->AddCut(std::move(cut));
-    } else if (detectors_channel_.find(name)!=detectors_channel_.end()) {
-      detectors_channel_.at(name)->AddCut(std::move(cut));
-    } else {
-      std::cout << "Detector" + name + "not found. Cut not Added." << std::endl;
-    }
+    AddDetectorCut(name, MakeUniqueNDimCut(arr, lambda));
+  }
+
+  /**
+   * @brief Adds a cut expression to a detector.
+   * The expression is built from the conditions Within, Above and Below combined with &&, || and !,
+   * e.g. `Within("Pt", 0.2, 2.) && Above("Eta", 0.)`. It is evaluated without calling a function object.
+   * @tparam EXPR type of the expression. Automatically deduced.
+   * @param name name of the detector
+   * @param expression cut expression. Names of the conditions correspond to the names of variables.
+   */
+  template<typename EXPR>
+  void AddCut(const std::string &name, const CutExpression<EXPR> &expression) {
+    AddDetectorCut(name, MakeUniqueExpressionCut(*var_manager_, expression));
   }
 
   /**
@@ -168,6 +194,17 @@ class CorrectionManager {
     event_cuts_->AddCut(MakeUniqueNDimCut(arr, func));
   }
 
+  /**
+   * @brief Adds a cut expression based on event variables.
+   * Only events which pass the cuts are used for the corrections.
+   * @tparam EXPR type of the expression. Automatically deduced.
+   * @param expression cut expression e.g. `Within("Centrality", 0., 80.)`.
+   */
+  template<typename EXPR>
+  void AddEventCut(const CutExpression<EXPR> &expression) {
+    event_cuts_->AddCut(MakeUniqueExpressionCut(*var_manager_, expression));
+  }
+
   /**
    * @brief Adds a one dimensional event histogram
    * @param axes axis of the histogram. Name corresponds to the axis.
@@ -208,6 +245,20 @@ class CorrectionManager {
    */
   void SetCorrectionSteps(const std::string &name, std::function<void(DetectorConfiguration *config)> config);
 
+  /**
+   * @brief Corrects all bins of a track detector with a single correction detector.
+   * The bin is used as an additional correction axis instead of creating one correction detector per bin.
+   * @param name Name of the detector.
+   */
+  void SetDifferentialMode(const std::string &name);
+
+  /**
+   * @brief Accumulates the Q vectors of a track detector while its tracks are filled.
+   * The data vectors are neither stored nor handed to the correction framework, only their raw sums.
+   * @param name Name of the detector.
+   */
+  void SetStreamingMode(const std::string &name);
+
   /**
    * @brief Set output tree.
    * Lifetime of the tree is managed by the user.
@@ -259,12 +310,23 @@ class CorrectionManager {
    */
   void FillTrackingDetectors() {
     if (event_passed_cuts_) {
+      var_manager_->EvaluateDerivedVariables();
       for (auto &dp : detectors_track_) {
         dp.second->FillData();
       }
     }
   }
 
+  /**
+   * @brief Fill all tracking detectors with all tracks of the event at once.
+   * Replaces calling FillTrackingDetectors() for each track. Each column holds the values of a track variable for all
+   * tracks, e.g. the data of a std::vector or ROOT::VecOps::RVec. Variables without a column, like the event
+   * variables, take their value from the variable container.
+   * @param ntracks number of tracks in the event.
+   * @param columns pairs of variable name and pointer to the values of the variable for all tracks.
+   */
+  void FillTrackingDetectors(std::size_t ntracks, const std::vector<std::pair<std::string, const double *>> &columns);
+
   /**
    * @brief Get the variable container to be able to fill the variables to the framework.
    * @return pointer to the variable container
@@ -283,6 +345,14 @@ class CorrectionManager {
    */
   TList *GetCalibrationQAList() { return qnc_calculator_.GetQAHistogramsList(); }
 
+  /**
+   * @brief Exports the calibration attached at initialization as a compact calibration snapshot.
+   * Written with its own name as key, the list can be used as calibration file of later
+   * initializations, avoiding the reconstruction of the calibration histograms at startup.
+   * @return A pointer to the snapshot list. The ownership is passed to the caller.
+   */
+  TList *ExportCalibrationSnapshot() { return qnc_calculator_.ExportCalibrationSnapshot(); }
+
   /**
    * @brief Get the list containing the event and detector QA histograms.
    * @return A pointer of the list to which the event and detector QA histograms will be saved.
@@ -298,6 +368,40 @@ class CorrectionManager {
     ConnectCorrectionQVectors("latest");
   }
 
+  /**
+   * @brief Sets the number of correction periods whose calibration is kept prepared for attachment.
+   * Returning to one of the most recently used periods then only attaches its cached calibration.
+   * @param size Maximum number of cached period calibrations. Zero disables the cache.
+   */
+  void SetCalibrationCacheSize(int size) { qnc_calculator_.SetCalibrationCacheSize(size); }
+
+  /**
+   * @brief Announces the correction period (e.g. run number) that follows the current one.
+   * With the calibration cache enabled its calibration is prepared on a background thread
+   * while the current period is still being processed.
+   * @param name Name of the next correction period
+   */
+  void PrefetchProcessName(std::string name) { qnc_calculator_.PrefetchProcessCalibration(name.data()); }
+
+  /**
+   * @brief Adds the calibration and QA histograms of a replica to the ones of this correction manager.
+   * The replica needs to be configured identically. To be called after both are finalized.
+   * @param replica correction manager processing a disjoint set of events.
+   */
+  void Merge(CorrectionManager &replica);
+
+  /**
+   * @brief Runs the event loops of independent correction manager replicas on separate threads.
+   * Each replica is configured, initialized and given its own output tree beforehand by the caller.
+   * Each thread runs the event loop of its replica and finalizes it. The outputs of all replicas are merged into
+   * the first one afterwards. ROOT thread safety is enabled. The replicas should be initialized without attaching
+   * their histograms to the current directory (TH1::AddDirectory(kFALSE)), as they share the histogram names.
+   * @param replicas identically configured and initialized correction managers.
+   * @param loop event loop of a replica over its range of events. Called with the replica and its index.
+   */
+  static void RunReplicas(const std::vector<CorrectionManager *> &replicas,
+                          const std::function<void(CorrectionManager &, std::size_t)> &loop);
+
  private:
 
   static constexpr int kMaxCorrectionArrayLength = 1000;
@@ -314,6 +418,25 @@ class CorrectionManager {
 
   void CreateDetectors();
 
+  static void MergeLists(TList *target, TList *source);
+
+  static void DeleteSublists(TList *list);
+
+  /**
+   * @brief Adds a cut to the detector of the given name.
+   * @param name name of the detector
+   * @param cut the cut
+   */
+  void AddDetectorCut(const std::string &name, std::unique_ptr<VariableCutBase> cut) {
+    if (detectors_track_.find(name)!=detectors_track_.end()) {
+      detectors_track_.at(name)->AddCut(std::move(cut));
+    } else if (detectors_channel_.find(name)!=detectors_channel_.end()) {
+      detectors_channel_.at(name)->AddCut(std::move(cut));
+    } else {
+      std::cout << "Detector" + name + "not found. Cut not Added." << std::endl;
+    }
+  }
+
   void ConnectCorrectionQVectors(const std::string &step) {
     for (auto &pair : detectors_track_) {
       pair.second->SetUpCorrectionVectorPtrs(qnc_calculator_, step);
@@ -332,6 +455,7 @@ class CorrectionManager {
   std::vector<Qn::Axis> correction_axes_; ///< vector of event axes used in the correctionstep
   CorrectionCalculator qnc_calculator_; ///< calculator of the corrections
   std::shared_ptr<VariableManager> var_manager_; ///< manager of the variables
+  VariableColumns columns_; ///< columns of the track variables of the current batch
   std::map<std::string, std::unique_ptr<DetectorBase>> detectors_track_; ///< map of tracking detectors
   std::map<std::string, std::unique_ptr<DetectorBase>> detectors_channel_; ///< map of channel detectors
   std::vector<std::unique_ptr<Qn::QAHistoBase>> event_histograms_; ///< event QA histograms
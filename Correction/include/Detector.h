@@ -18,6 +18,7 @@
 #ifndef FLOW_DETECTOR_H
 #define FLOW_DETECTOR_H
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -26,11 +27,13 @@
 #include "EventClassVariablesSet.h"
 #include "DetectorConfigurationChannels.h"
 #include "DetectorConfigurationTracks.h"
+#include "CorrectionQnVectorSums.h"
 
 #include "VariableManager.h"
 #include "DataContainer.h"
 #include "QVector.h"
 #include "DataVector.h"
+#include "DataVectorArena.h"
 #include "QAHistogram.h"
 #include "VariableCutBase.h"
 
@@ -49,17 +52,23 @@ class DetectorBase {
  public:
   virtual ~DetectorBase() = default;
 
-  virtual std::unique_ptr<DataContainerDataVector> &GetDataContainer() = 0;
+  virtual DataVectorArena &GetDataVectors() = 0;
   virtual std::unique_ptr<DataContainerQVector> &GetQnDataContainer() = 0;
 
   virtual CorrectionDetector *GenerateDetector(int globalid, int binid, EventClassVariablesSet *set) = 0;
   virtual DetectorConfiguration *CreateDetectorConfiguration(const std::string &name, EventClassVariablesSet *set) = 0;
   virtual void SetConfig(std::function<void(DetectorConfiguration *config)> conf) = 0;
+  virtual void SetDifferential(const Variable &bin, int id) = 0;
+  virtual bool IsDifferential() const = 0;
+  virtual void SetStreaming() = 0;
+  virtual bool IsStreaming() const = 0;
+  virtual const std::vector<CorrectionQnVectorSums> &GetQnVectorSums() const = 0;
   virtual void AddCut(std::unique_ptr<VariableCutBase> cut) = 0;
   virtual void AddHistogram(std::unique_ptr<QAHistoBase> base) = 0;
   virtual void InitializeCutReports() = 0;
   virtual void FillReport() = 0;
   virtual void FillData() = 0;
+  virtual void FillData(const VariableColumns &columns) = 0;
   virtual void ClearData() = 0;
   virtual TList *GetReportList() = 0;
   virtual void SetUpCorrectionVectorPtrs(const Qn::CorrectionCalculator &calc, std::string step) = 0;
@@ -87,11 +96,10 @@ class Detector : public DetectorBase {
       vars_(vars),
       cuts_(new Qn::Cuts),
       int_cuts_(new Qn::Cuts),
-      datavector_(new Qn::DataContainerDataVector()),
       qvector_(new Qn::DataContainerQVector()) {
     coordinates_.resize(vars.size());
-    datavector_->AddAxes(axes);
     qvector_->AddAxes(axes);
+    datavectors_.SetNumberOfBins(qvector_->size());
     correction_ptrs_.resize(qvector_->size());
     for (unsigned int i = 0; i < N; ++i) {
       harmonics_[i] = harmo[i];
@@ -103,7 +111,10 @@ class Detector : public DetectorBase {
    * @brief Clears data before filling new event.
    */
   void ClearData() override {
-    datavector_->ClearData();
+    datavectors_.Clear();
+    for (auto &sums : qnsums_) {
+      sums.Reset();
+    }
     qvector_->ClearData();
   }
 
@@ -119,14 +130,24 @@ class Detector : public DetectorBase {
       throw (std::runtime_error("No Qn correction configuration found for " + name_));
     }
     std::string name;
-    if (datavector_->IsIntegrated()) {
+    if (qvector_->IsIntegrated() || differential_) {
       name = name_;
     } else {
       name = name_ + std::to_string(binid);
     }
+    if (differential_) {
+      auto nbins = static_cast<int>(qvector_->size());
+      bin_evvar_.reset(new EventClassVariable(bin_id_, (name_ + "_bin").data(), nbins, -0.5, nbins - 0.5));
+      bin_varset_.reset(new EventClassVariablesSet(*set));
+      bin_varset_->Add(bin_evvar_.get());
+      set = bin_varset_.get();
+    }
     auto detector = new CorrectionDetector(name.data(), globalid);
     auto configuration = CreateDetectorConfiguration(name, set);
     configuration_(configuration);
+    if (differential_) {
+      static_cast<DetectorConfigurationTracks *>(configuration)->SetDifferentialBins(qvector_->size(), bin_.begin());
+    }
     normalization_ = configuration->GetQVectorNormalizationMethod();
     detector->AddDetectorConfiguration(configuration);
     return detector;
@@ -150,10 +171,10 @@ class Detector : public DetectorBase {
   }
 
   /**
-   * @brief Get the datacontainer associated to the detector.
-   * @return A reference to the Datacontainer.
+   * @brief Get the data vectors of the current event.
+   * @return A reference to the data vectors.
    */
-  std::unique_ptr<DataContainerDataVector> &GetDataContainer() override { return datavector_; }
+  DataVectorArena &GetDataVectors() override { return datavectors_; }
   /**
    * @brief Get the Qn vector data container associated to the detector.
    * @return A reference to the Datacontainer.
@@ -168,6 +189,54 @@ class Detector : public DetectorBase {
     configuration_ = conf;
   }
 
+  /**
+   * @brief Uses a single correction detector for all bins of the detector.
+   * The bin is used as an additional correction axis. Only supported for track detectors.
+   * @param bin variable holding the bin which is being corrected.
+   * @param id position of the bin variable in the values container.
+   */
+  void SetDifferential(const Variable &bin, int id) override {
+    differential_ = true;
+    bin_ = bin;
+    bin_id_ = id;
+  }
+
+  /**
+   * @brief Returns if a single correction detector is used for all bins.
+   * @return true if the detector is corrected differentially.
+   */
+  bool IsDifferential() const override { return differential_; }
+
+  /**
+   * @brief Accumulates the raw Q vector sums of each bin while the detector is filled.
+   * The data vectors are not stored. Only supported for track detectors, which have no input data corrections.
+   */
+  void SetStreaming() override {
+    streaming_ = true;
+    int highestharmonic = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+      highestharmonic = std::max(highestharmonic, harmonics_[i]);
+    }
+    qnsums_.resize(qvector_->size());
+    for (auto &sums : qnsums_) {
+      // the Q2n vectors need up to twice the highest harmonic.
+      sums.SetHighestMultiple(2*highestharmonic);
+      sums.Reset();
+    }
+  }
+
+  /**
+   * @brief Returns if the raw Q vector sums are accumulated instead of storing the data vectors.
+   * @return true if the detector is filled in streaming mode.
+   */
+  bool IsStreaming() const override { return streaming_; }
+
+  /**
+   * @brief Get the raw Q vector sums of each bin of the current event. Only filled in streaming mode.
+   * @return A reference to the sums.
+   */
+  const std::vector<CorrectionQnVectorSums> &GetQnVectorSums() const override { return qnsums_; }
+
   /**
    * @brief Adds a cut to the detector
    * @param cut unique pointer to the cut. It is moved into the function and cannot be reused!
@@ -189,33 +258,67 @@ class Detector : public DetectorBase {
     for (auto &histo : histograms_) {
       histo->Fill();
     }
+    cuts_->CheckCuts(passed_, static_cast<std::size_t>(phi_.length()));
     for (const auto &phi : phi_) {
-      if (!cuts_->CheckCuts(i)) {
+      if (!passed_.Test(i)) {
         ++i;
         continue;
       }
-      if (vars_.empty()) {
-        datavector_->CallOnElement(0, [&](std::vector<DataVector> &vector) {
-          vector.emplace_back(phi, *(weight_.begin() + i));
-        });
-      } else {
+      long ibin = 0;
+      if (!vars_.empty()) {
         long icoord = 0;
         for (const auto &var : vars_) {
-          coordinates_.at(icoord) = *(var.begin() + i);
+          coordinates_[icoord] = *(var.begin() + i);
           ++icoord;
         }
-        try {
-          datavector_->CallOnElement(coordinates_,
-                                     [&](std::vector<DataVector> &vector) {
-                                       vector.emplace_back(phi, *(weight_.begin() + i));
-                                     });
+        ibin = qvector_->FindBin(coordinates_);
+      }
+      // data outside of the axes is skipped.
+      if (ibin >= 0) {
+        if (streaming_) {
+          qnsums_[ibin].Add(phi, *(weight_.begin() + i));
+        } else {
+          datavectors_.Add(static_cast<std::size_t>(ibin), phi, *(weight_.begin() + i));
         }
-        catch (std::exception &) {}
       }
       ++i;
     }
   }
 
+  /**
+   * @brief Fills a batch of tracks into the data vectors, histograms and cut reports after the cuts have been checked.
+   * Each cut and histogram processes the whole batch at once. Only supported for track detectors.
+   * @param columns values of the variables of all tracks of the batch.
+   */
+  void FillData(const VariableColumns &columns) override {
+    int_cuts_->CheckCuts(columns, passed_);
+    selected_.clear();
+    passed_.ForEachSelected([this](std::size_t i) { selected_.push_back(i); });
+    if (selected_.empty()) return;
+    for (auto &histo : histograms_) {
+      histo->Fill(columns, selected_);
+    }
+    for (const auto i : selected_) {
+      long ibin = 0;
+      if (!vars_.empty()) {
+        long icoord = 0;
+        for (const auto &var : vars_) {
+          coordinates_[icoord] = columns.Value(var, i);
+          ++icoord;
+        }
+        ibin = qvector_->FindBin(coordinates_);
+      }
+      // data outside of the axes is skipped.
+      if (ibin >= 0) {
+        if (streaming_) {
+          qnsums_[ibin].Add(columns.Value(phi_, i), columns.Value(weight_, i));
+        } else {
+          datavectors_.Add(static_cast<std::size_t>(ibin), columns.Value(phi_, i), columns.Value(weight_, i));
+        }
+      }
+    }
+  }
+
   /**
    * Initializes the histograms used for the cut report.
    * @param name name of the detector.
@@ -298,12 +401,21 @@ class Detector : public DetectorBase {
   const Variable weight_; /// variable holding the weight which is used for the calculation of the Q vector.
   std::vector<Variable> vars_; /// variables used for the binning of the Q vector.
   std::vector<float> coordinates_;  ///  vector holding the temporary coordinates of one track or channel.
+  SelectionMask passed_; /// mask of the tracks or channels passing the cuts.
+  std::vector<std::size_t> selected_; /// positions of the tracks of a batch passing the cuts.
   std::unique_ptr<Cuts> cuts_; /// per channel selection  cuts
   std::unique_ptr<Cuts> int_cuts_; /// integrated selection cuts
   std::vector<std::unique_ptr<QAHistoBase>> histograms_; /// QA histograms of the detector
-  std::unique_ptr<DataContainerDataVector> datavector_; /// Container holding the data vectors of the current event.
+  DataVectorArena datavectors_; /// Data vectors of the current event.
+  bool streaming_ = false; /// raw Q vector sums accumulated instead of storing the data vectors
+  std::vector<CorrectionQnVectorSums> qnsums_; /// raw Q vector sums of each bin of the current event
   std::unique_ptr<DataContainerQVector> qvector_; /// Container holding the Q vectors of the current event.
   std::vector<const Qn::CorrectionQnVector *> correction_ptrs_; /// pointers to the latest corrected Q vectors
+  bool differential_ = false; /// single correction detector for all bins
+  Variable bin_; /// variable holding the bin which is being corrected in differential mode
+  int bin_id_ = -1; /// position of the bin variable in the values container
+  std::unique_ptr<EventClassVariable> bin_evvar_; /// correction axis of the bins in differential mode
+  std::unique_ptr<EventClassVariablesSet> bin_varset_; /// correction axes including the bins in differential mode
   std::function<void(DetectorConfiguration *config)> configuration_; /// correction configuration function
 };
 }
@@ -38,6 +38,7 @@ namespace Qn {
 struct QAHistoBase {
   virtual ~QAHistoBase() = default;
   virtual void Fill() = 0;
+  virtual void Fill(const VariableColumns &columns, const std::vector<std::size_t> &selected) = 0;
   virtual void AddToList(TList *) = 0;
 
 };
@@ -97,6 +98,41 @@ class QAHisto : public QAHistoBase {
     return FillImpl(vars_, std::make_index_sequence<N>{});
   };
 
+  /**
+   * Implementation of the fill function for a batch of tracks.
+   * The values of the selected tracks are gathered and filled at once.
+   * @tparam I index sequence
+   * @param columns values of the variables of all tracks of the batch.
+   * @param selected positions of the tracks to be filled.
+   */
+  template<std::size_t... I>
+  void FillImpl(const VariableColumns &columns, const std::vector<std::size_t> &selected, std::index_sequence<I...>) {
+    for (std::size_t ivar = 0; ivar < N; ++ivar) {
+      auto &buffer = buffers_[ivar];
+      buffer.resize(selected.size());
+      for (std::size_t k = 0; k < selected.size(); ++k) {
+        buffer[k] = columns.Value(vars_[ivar], selected[k]);
+      }
+    }
+    if (axis_) {
+      for (std::size_t k = 0; k < selected.size(); ++k) {
+        auto bin = axis_->FindBin(columns.Value(axisvar_, selected[k]));
+        if (bin > -1) ptr(histo_.at(bin))->FillN(1, (buffers_[I].data() + k)...);
+      }
+    } else {
+      ptr(histo_.at(0))->FillN(selected.size(), buffers_[I].data()...);
+    }
+  }
+
+  /**
+   * Fill function for a batch of tracks.
+   * @param columns values of the variables of all tracks of the batch.
+   * @param selected positions of the tracks to be filled.
+   */
+  void Fill(const VariableColumns &columns, const std::vector<std::size_t> &selected) override {
+    return FillImpl(columns, selected, std::make_index_sequence<N>{});
+  }
+
   /**
    * Add the histogram to the list.
    * @param list pointer to the list. Lifetime of the histogram hast to be managed by the list.
@@ -132,6 +168,7 @@ class QAHisto : public QAHistoBase {
 
   std::array<VAR, N> vars_; /// Array of variables to be filled in the histogram.
   std::vector<HISTO> histo_; /// Histogram (e.g. TH1, TH2) which support the filling with FillN(...).
+  std::array<std::vector<double>, N> buffers_; /// values of the tracks of a batch gathered for filling.
   std::unique_ptr<Qn::Axis> axis_ = nullptr; // Creates a histogram for each bin of the axis
   VAR axisvar_;
   std::string name_;
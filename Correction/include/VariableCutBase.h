@@ -19,6 +19,8 @@
 #define FLOW_VARIABLECUTBASE_H
 
 #include <array>
+#include <bitset>
+#include <cstdint>
 #include <vector>
 #include <functional>
 
@@ -29,12 +31,119 @@
 #include "ROOT/RIntegerSequence.hxx"
 
 namespace Qn {
+/**
+ * Bit mask holding the selection status of an array of tracks or channels.
+ * The bits are packed into 64 bit words, so that masks are combined and counted a word at a time.
+ */
+class SelectionMask {
+ public:
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordBits = 64;
+
+  /**
+   * @brief Resizes the mask and selects all entries.
+   * @param size number of tracks or channels.
+   */
+  void Reset(std::size_t size) {
+    size_ = size;
+    words_.assign((size + kWordBits - 1)/kWordBits, ~Word(0));
+    ClearPadding();
+  }
+
+  /**
+   * @brief Sets the mask from a predicate evaluated for every entry.
+   * The bits of each word are collected in a branchless loop over the entries it covers.
+   * @tparam FUNC type of the predicate
+   * @param size number of tracks or channels.
+   * @param func predicate taking the position of the entry.
+   */
+  template<typename FUNC>
+  void Fill(std::size_t size, FUNC &&func) {
+    size_ = size;
+    words_.resize((size + kWordBits - 1)/kWordBits);
+    for (std::size_t iword = 0; iword < words_.size(); ++iword) {
+      const auto offset = iword*kWordBits;
+      const auto nbits = size - offset < kWordBits ? size - offset : kWordBits;
+      Word bits = 0;
+      for (std::size_t ibit = 0; ibit < nbits; ++ibit) {
+        bits |= static_cast<Word>(func(offset + ibit)) << ibit;
+      }
+      words_[iword] = bits;
+    }
+  }
+
+  /**
+   * @brief Keeps only the entries selected in both masks.
+   * @param other mask of the same size.
+   * @return reference to this mask.
+   */
+  SelectionMask &operator&=(const SelectionMask &other) {
+    for (std::size_t iword = 0; iword < words_.size(); ++iword) {
+      words_[iword] &= other.words_[iword];
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Counts the selected entries.
+   * @return number of selected entries.
+   */
+  std::size_t Count() const {
+    std::size_t count = 0;
+    for (const auto word : words_) {
+      count += std::bitset<kWordBits>(word).count();
+    }
+    return count;
+  }
+
+  /**
+   * @brief Calls the function for each selected entry in ascending order.
+   * @tparam FUNC type of the function
+   * @param func function taking the position of the entry.
+   */
+  template<typename FUNC>
+  void ForEachSelected(FUNC &&func) const {
+    for (std::size_t iword = 0; iword < words_.size(); ++iword) {
+      auto bits = words_[iword];
+      for (std::size_t ibit = 0; bits!=0; ++ibit, bits >>= 1) {
+        if (bits & 1) func(iword*kWordBits + ibit);
+      }
+    }
+  }
+
+  /**
+   * @brief Tests if the entry is selected.
+   * @param i position of the entry.
+   * @return true if the entry is selected.
+   */
+  bool Test(std::size_t i) const { return (words_[i/kWordBits] >> (i%kWordBits)) & 1; }
+
+  /**
+   * @brief Get the number of tracks or channels.
+   * @return size of the mask.
+   */
+  std::size_t size() const { return size_; }
+
+ private:
+  /**
+   * @brief Unsets the bits beyond the size in the last word.
+   */
+  void ClearPadding() {
+    if (size_%kWordBits) words_.back() &= (Word(1) << (size_%kWordBits)) - 1;
+  }
+
+  std::size_t size_ = 0; /// number of tracks or channels
+  std::vector<Word> words_; /// selection bits of the tracks or channels
+};
+
 /**
  * Base class of the Cut.
  */
 struct VariableCutBase {
   virtual ~VariableCutBase() = default;
   virtual bool Check(int i) = 0;
+  virtual void Check(SelectionMask &mask, std::size_t size) = 0;
+  virtual void Check(const VariableColumns &columns, SelectionMask &mask) = 0;
   virtual int GetVariableLength() const = 0;
   virtual std::string Name() const = 0;
 };
@@ -65,6 +174,24 @@ class VariableCutNDim : public VariableCutBase {
     return CheckImpl(i, std::make_index_sequence<sizeof...(T)>{});
   }
 
+  /**
+   * Check which entries of the variables at variable id to variable id + size pass the cut.
+   * @param mask mask set to the entries passing the cut.
+   * @param size number of entries, e.g. the number of channels.
+   */
+  void Check(SelectionMask &mask, std::size_t size) override {
+    CheckImpl(mask, size, std::make_index_sequence<sizeof...(T)>{});
+  }
+
+  /**
+   * Check which tracks of a batch pass the cut.
+   * @param columns values of the variables of all tracks of the batch.
+   * @param mask mask set to the tracks passing the cut.
+   */
+  void Check(const VariableColumns &columns, SelectionMask &mask) override {
+    CheckImpl(columns, mask, std::make_index_sequence<sizeof...(T)>{});
+  }
+
   /**
    * Get the length of the variable at position 0.
    * @return length of the variables.
@@ -84,6 +211,39 @@ class VariableCutNDim : public VariableCutBase {
     return lambda_(*(variables_[I].begin() + i)...);
   }
 
+  /**
+   * Implements the evaluation of the cut for an array of entries.
+   * @tparam I index sequence
+   * @param mask mask set to the entries passing the cut.
+   * @param size number of entries.
+   */
+  template<std::size_t... I>
+  void CheckImpl(SelectionMask &mask, std::size_t size, std::index_sequence<I...>) {
+    std::array<double *, sizeof...(T)> data = {{variables_[I].begin()...}};
+    mask.Fill(size, [this, &data](std::size_t i) { return lambda_(data[I][i]...); });
+  }
+
+  /**
+   * Implements the evaluation of the cut for a batch of tracks.
+   * Variables without a column take the same value for all tracks.
+   * @tparam I index sequence
+   * @param columns values of the variables of all tracks of the batch.
+   * @param mask mask set to the tracks passing the cut.
+   */
+  template<std::size_t... I>
+  void CheckImpl(const VariableColumns &columns, SelectionMask &mask, std::index_sequence<I...>) {
+    std::array<const double *, sizeof...(T)> data = {{columns.Column(variables_[I])...}};
+    std::array<std::size_t, sizeof...(T)> strides = {{(data[I] ? 1u : 0u)...}};
+    std::array<double, sizeof...(T)> values;
+    for (std::size_t ivar = 0; ivar < sizeof...(T); ++ivar) {
+      if (!data[ivar]) data[ivar] = variables_[ivar].begin();
+    }
+    mask.Fill(columns.size(), [this, &data, &strides, &values](std::size_t i) {
+      values = {{data[I][i*strides[I]]...}};
+      return lambda_(values[I]...);
+    });
+  }
+
   /**
    * Returns the name of all variables used in the cut.
    * @return name of all variables.
@@ -165,6 +325,48 @@ class Cuts {
     return passed;
   }
 
+  /**
+   * Checks which entries of the variables pass the cuts, e.g. all channels of a detector at once.
+   * Each cut is evaluated for all entries into its own mask before the masks are combined.
+   * Creates entries in the cut report
+   * @param passed mask set to the entries passing all cuts.
+   * @param size number of entries.
+   */
+  inline void CheckCuts(SelectionMask &passed, std::size_t size) {
+    int icut = 1;
+    passed.Reset(size);
+    if (cuts_.empty()) return;
+    for (std::size_t i = 0; i < size; ++i) {
+      ++*cut_weight_.at(i);
+    }
+    for (auto &cut : cuts_) {
+      cut->Check(cut_mask_, size);
+      passed &= cut_mask_;
+      passed.ForEachSelected([this, icut](std::size_t i) { ++*cut_weight_.at(i + nchannels_*icut); });
+      ++icut;
+    }
+  }
+
+  /**
+   * Checks which tracks of a batch pass the cuts.
+   * Each cut is evaluated for all tracks into its own mask before the masks are combined.
+   * The entries of the cut report are obtained from the number of tracks selected after each cut.
+   * @param columns values of the variables of all tracks of the batch.
+   * @param passed mask set to the tracks passing all cuts.
+   */
+  inline void CheckCuts(const VariableColumns &columns, SelectionMask &passed) {
+    int icut = 1;
+    passed.Reset(columns.size());
+    if (cuts_.empty()) return;
+    *cut_weight_.begin() += columns.size();
+    for (auto &cut : cuts_) {
+      cut->Check(columns, cut_mask_);
+      passed &= cut_mask_;
+      *cut_weight_.at(nchannels_*icut) += passed.Count();
+      ++icut;
+    }
+  }
+
   /**
    * @brief Fills the cut report.
    */
@@ -256,6 +458,7 @@ class Cuts {
   Variable cut_weight_; /// Variable saving a weight used for filling the cut histogram
   Variable cut_channel_; /// Variable saving the channel number
   std::vector<std::unique_ptr<VariableCutBase>> cuts_; /// vector of cuts which are applied
+  SelectionMask cut_mask_; /// mask of the entries passing the cut being evaluated
   std::unique_ptr<QAHistoBase> report_ = nullptr; /// histogram of the cut report.
 
 };
@@ -0,0 +1,315 @@
+// Flow Vector Correction Framework
+//
+// Copyright (C) 2018  Lukas Kreis, Ilya Selyuzhenkov
+// Contact: l.kreis@gsi.de; ilya.selyuzhenkov@gmail.com
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLOW_VARIABLECUTEXPRESSION_H
+#define FLOW_VARIABLECUTEXPRESSION_H
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "VariableManager.h"
+#include "VariableCutBase.h"
+
+namespace Qn {
+/**
+ * Base class of the cut expressions.
+ * The expressions are combined with &&, || and ! into a single type, which is evaluated without indirections.
+ * @tparam EXPR type of the derived expression.
+ */
+template<typename EXPR>
+struct CutExpression {
+  const EXPR &Self() const { return static_cast<const EXPR &>(*this); }
+};
+
+/**
+ * Condition on a single variable.
+ * The variable is given by name and bound to the variable manager when the cut is added.
+ * @tparam CONDITION type of the condition evaluated on the value of the variable.
+ */
+template<typename CONDITION>
+class CutCondition : public CutExpression<CutCondition<CONDITION>> {
+ public:
+  CutCondition(std::string name, CONDITION condition) : name_(std::move(name)), condition_(condition) {}
+
+  /**
+   * @brief Binds the variable to the variable manager.
+   * @param manager variable manager holding the variable.
+   */
+  void Bind(const VariableManager &manager) { var_ = manager.FindVariable(name_); }
+
+  /**
+   * @brief Prepares the evaluation for a batch of tracks.
+   * @param columns values of the variables of all tracks of the batch.
+   */
+  void Prepare(const VariableColumns &columns) {
+    auto column = columns.Column(var_);
+    data_ = column ? column : var_.begin();
+    stride_ = column ? 1 : 0;
+  }
+
+  /**
+   * @brief Checks the condition for the variable at variable id + i.
+   * @param i offset from the variable id.
+   * @return true if the condition is fulfilled.
+   */
+  bool Check(std::size_t i) const { return condition_(*(var_.begin() + i)); }
+
+  /**
+   * @brief Checks the condition for a track of the prepared batch.
+   * @param i position of the track in the batch.
+   * @return true if the condition is fulfilled.
+   */
+  bool CheckBatch(std::size_t i) const { return condition_(data_[i*stride_]); }
+
+  int GetVariableLength() const { return var_.length(); }
+  std::string Name() const { return condition_.Name(name_); }
+
+ private:
+  std::string name_; /// name of the variable
+  CONDITION condition_; /// condition evaluated on the value of the variable
+  Variable var_; /// variable bound to the variable manager
+  const double *data_ = nullptr; /// values of the variable for the prepared batch
+  std::size_t stride_ = 0; /// distance between the values of consecutive tracks of the prepared batch
+};
+
+/**
+ * Conjunction of two cut expressions.
+ */
+template<typename LEFT, typename RIGHT>
+class CutAnd : public CutExpression<CutAnd<LEFT, RIGHT>> {
+ public:
+  CutAnd(LEFT left, RIGHT right) : left_(std::move(left)), right_(std::move(right)) {}
+  void Bind(const VariableManager &manager) {
+    left_.Bind(manager);
+    right_.Bind(manager);
+  }
+  void Prepare(const VariableColumns &columns) {
+    left_.Prepare(columns);
+    right_.Prepare(columns);
+  }
+  bool Check(std::size_t i) const { return left_.Check(i) && right_.Check(i); }
+  /// both sides are evaluated to keep the evaluation of a batch free of branches.
+  bool CheckBatch(std::size_t i) const { return left_.CheckBatch(i) & right_.CheckBatch(i); }
+  int GetVariableLength() const { return left_.GetVariableLength(); }
+  std::string Name() const { return "(" + left_.Name() + "&&" + right_.Name() + ")"; }
+ private:
+  LEFT left_; /// left hand side
+  RIGHT right_; /// right hand side
+};
+
+/**
+ * Disjunction of two cut expressions.
+ */
+template<typename LEFT, typename RIGHT>
+class CutOr : public CutExpression<CutOr<LEFT, RIGHT>> {
+ public:
+  CutOr(LEFT left, RIGHT right) : left_(std::move(left)), right_(std::move(right)) {}
+  void Bind(const VariableManager &manager) {
+    left_.Bind(manager);
+    right_.Bind(manager);
+  }
+  void Prepare(const VariableColumns &columns) {
+    left_.Prepare(columns);
+    right_.Prepare(columns);
+  }
+  bool Check(std::size_t i) const { return left_.Check(i) || right_.Check(i); }
+  /// both sides are evaluated to keep the evaluation of a batch free of branches.
+  bool CheckBatch(std::size_t i) const { return left_.CheckBatch(i) | right_.CheckBatch(i); }
+  int GetVariableLength() const { return left_.GetVariableLength(); }
+  std::string Name() const { return "(" + left_.Name() + "||" + right_.Name() + ")"; }
+ private:
+  LEFT left_; /// left hand side
+  RIGHT right_; /// right hand side
+};
+
+/**
+ * Negation of a cut expression.
+ */
+template<typename EXPR>
+class CutNot : public CutExpression<CutNot<EXPR>> {
+ public:
+  explicit CutNot(EXPR expression) : expression_(std::move(expression)) {}
+  void Bind(const VariableManager &manager) { expression_.Bind(manager); }
+  void Prepare(const VariableColumns &columns) { expression_.Prepare(columns); }
+  bool Check(std::size_t i) const { return !expression_.Check(i); }
+  bool CheckBatch(std::size_t i) const { return !expression_.CheckBatch(i); }
+  int GetVariableLength() const { return expression_.GetVariableLength(); }
+  std::string Name() const { return "!" + expression_.Name(); }
+ private:
+  EXPR expression_; /// negated expression
+};
+
+template<typename LEFT, typename RIGHT>
+CutAnd<LEFT, RIGHT> operator&&(const CutExpression<LEFT> &left, const CutExpression<RIGHT> &right) {
+  return CutAnd<LEFT, RIGHT>(left.Self(), right.Self());
+}
+
+template<typename LEFT, typename RIGHT>
+CutOr<LEFT, RIGHT> operator||(const CutExpression<LEFT> &left, const CutExpression<RIGHT> &right) {
+  return CutOr<LEFT, RIGHT>(left.Self(), right.Self());
+}
+
+template<typename EXPR>
+CutNot<EXPR> operator!(const CutExpression<EXPR> &expression) {
+  return CutNot<EXPR>(expression.Self());
+}
+
+namespace Details {
+/**
+ * Formats a threshold for the name of a cut.
+ * @param value threshold
+ * @return shortest representation of the value.
+ */
+inline std::string CutThreshold(double value) {
+  std::ostringstream stream;
+  stream << value;
+  return stream.str();
+}
+
+/**
+ * Condition of a value within an open interval.
+ */
+struct WithinCondition {
+  double low; /// lower limit
+  double high; /// upper limit
+  bool operator()(double value) const { return (low < value) & (value < high); }
+  std::string Name(const std::string &var) const {
+    return CutThreshold(low) + "<" + var + "<" + CutThreshold(high);
+  }
+};
+
+/**
+ * Condition of a value above a threshold.
+ */
+struct AboveCondition {
+  double threshold; /// lower limit
+  bool operator()(double value) const { return threshold < value; }
+  std::string Name(const std::string &var) const { return var + ">" + CutThreshold(threshold); }
+};
+
+/**
+ * Condition of a value below a threshold.
+ */
+struct BelowCondition {
+  double threshold; /// upper limit
+  bool operator()(double value) const { return value < threshold; }
+  std::string Name(const std::string &var) const { return var + "<" + CutThreshold(threshold); }
+};
+}
+
+/**
+ * Creates a cut passed by values within the open interval (low, high).
+ * @param name name of the variable.
+ * @param low lower limit.
+ * @param high upper limit.
+ * @return the cut expression.
+ */
+inline CutCondition<Details::WithinCondition> Within(std::string name, double low, double high) {
+  return {std::move(name), Details::WithinCondition{low, high}};
+}
+
+/**
+ * Creates a cut passed by values above the threshold.
+ * @param name name of the variable.
+ * @param threshold lower limit.
+ * @return the cut expression.
+ */
+inline CutCondition<Details::AboveCondition> Above(std::string name, double threshold) {
+  return {std::move(name), Details::AboveCondition{threshold}};
+}
+
+/**
+ * Creates a cut passed by values below the threshold.
+ * @param name name of the variable.
+ * @param threshold upper limit.
+ * @return the cut expression.
+ */
+inline CutCondition<Details::BelowCondition> Below(std::string name, double threshold) {
+  return {std::move(name), Details::BelowCondition{threshold}};
+}
+
+/**
+ * Cut evaluating a cut expression.
+ * The whole expression is a single type, so that its conditions are inlined into the checks of the cut.
+ * @tparam EXPR type of the cut expression.
+ */
+template<typename EXPR>
+class VariableCutExpression : public VariableCutBase {
+ public:
+  explicit VariableCutExpression(EXPR expression) : expression_(std::move(expression)) {}
+
+  /**
+   * Check if the cut is passed for variables at variable id + i
+   * @param i offset from the variable id.
+   * @return true if the cut is passed.
+   */
+  bool Check(int i) override { return expression_.Check(static_cast<std::size_t>(i)); }
+
+  /**
+   * Check which entries of the variables at variable id to variable id + size pass the cut.
+   * @param mask mask set to the entries passing the cut.
+   * @param size number of entries, e.g. the number of channels.
+   */
+  void Check(SelectionMask &mask, std::size_t size) override {
+    mask.Fill(size, [this](std::size_t i) { return expression_.Check(i); });
+  }
+
+  /**
+   * Check which tracks of a batch pass the cut.
+   * @param columns values of the variables of all tracks of the batch.
+   * @param mask mask set to the tracks passing the cut.
+   */
+  void Check(const VariableColumns &columns, SelectionMask &mask) override {
+    expression_.Prepare(columns);
+    mask.Fill(columns.size(), [this](std::size_t i) { return expression_.CheckBatch(i); });
+  }
+
+  /**
+   * Get the length of the first variable of the expression.
+   * @return length of the variables.
+   */
+  int GetVariableLength() const override { return expression_.GetVariableLength(); }
+
+  /**
+   * Returns the expression in readable form.
+   * @return name of the cut.
+   */
+  std::string Name() const override { return expression_.Name(); }
+
+ private:
+  EXPR expression_; /// expression evaluated by the cut
+};
+
+/**
+ * Function which creates a unique_ptr of a cut evaluating the expression.
+ * @tparam EXPR type of the cut expression.
+ * @param manager variable manager holding the variables used in the expression.
+ * @param expression cut expression.
+ * @return Returns a unique pointer to the cut.
+ */
+template<typename EXPR>
+std::unique_ptr<VariableCutBase> MakeUniqueExpressionCut(const VariableManager &manager,
+                                                         const CutExpression<EXPR> &expression) {
+  EXPR bound = expression.Self();
+  bound.Bind(manager);
+  return std::make_unique<VariableCutExpression<EXPR>>(std::move(bound));
+}
+}
+
+#endif //FLOW_VARIABLECUTEXPRESSION_H
@@ -20,12 +20,18 @@
 #ifndef FLOW_VARIABLEMANAGER_H
 #define FLOW_VARIABLEMANAGER_H
 
+#include <array>
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
 #include <utility>
 #include <cmath>
+#include <stdexcept>
+#include <type_traits>
 
 #include "TTree.h"
+#include "ROOT/RIntegerSequence.hxx"
 
 namespace Qn {
 /**
@@ -42,6 +48,7 @@ class Variable {
   double *var_container = nullptr; /// pointer to the values container
   std::string name_; /// name of the variable
   friend class VariableManager;
+  friend class VariableColumns;
   friend struct std::less<Qn::Variable>;
   friend class Cuts;
  public:
@@ -54,6 +61,80 @@ class Variable {
   inline int length() const noexcept { return length_; }
   std::string Name() const { return name_; }
 };
+
+/**
+ * @brief Columnar view of the variables of a batch of tracks.
+ * Variables with a column take the value of each track from it. All other variables keep their single value in the
+ * values container, which is then shared by all tracks of the batch.
+ */
+class VariableColumns {
+ public:
+  VariableColumns() = default;
+  /**
+   * @brief Constructor
+   * @param container values container of the variables which can be given a column.
+   */
+  explicit VariableColumns(const double *container) : container_(container) {}
+
+  /**
+   * @brief Removes all columns and empties the batch.
+   */
+  void Clear() {
+    columns_.assign(columns_.size(), nullptr);
+    size_ = 0;
+  }
+
+  /**
+   * @brief Sets the number of tracks in the batch.
+   * @param size number of tracks.
+   */
+  void SetSize(std::size_t size) { size_ = size; }
+
+  /**
+   * @brief Get the number of tracks in the batch.
+   * @return number of tracks.
+   */
+  std::size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief Sets the column of a variable.
+   * @param var variable of length one in the values container.
+   * @param column values of the variable for all tracks of the batch. It is not copied.
+   */
+  void SetColumn(const Variable &var, const double *column) {
+    if (var.var_container!=container_ || var.length_!=1) {
+      throw std::logic_error("Variable " + var.name_ + " cannot be given a column. Only variables of length one are supported.");
+    }
+    if (static_cast<std::size_t>(var.id_) >= columns_.size()) columns_.resize(var.id_ + 1, nullptr);
+    columns_[var.id_] = column;
+  }
+
+  /**
+   * @brief Get the column of a variable.
+   * @param var variable
+   * @return pointer to the values of the variable for all tracks. nullptr if the variable has no column.
+   */
+  const double *Column(const Variable &var) const noexcept {
+    if (var.var_container!=container_ || static_cast<std::size_t>(var.id_) >= columns_.size()) return nullptr;
+    return columns_[var.id_];
+  }
+
+  /**
+   * @brief Get the value of a variable for a track of the batch.
+   * @param var variable
+   * @param i position of the track in the batch.
+   * @return the value of the track or the value in the values container if the variable has no column.
+   */
+  double Value(const Variable &var, std::size_t i) const noexcept {
+    auto column = Column(var);
+    return column ? column[i] : *var.begin();
+  }
+
+ private:
+  const double *container_ = nullptr; /// values container of the variables
+  std::size_t size_ = 0; /// number of tracks in the batch
+  std::vector<const double *> columns_; /// columns of the variables indexed by their position in the values container
+};
 }
 
 
@@ -93,6 +174,75 @@ class OutValue {
 };
 
 namespace Qn {
+/**
+ * Base class of a derived variable.
+ */
+struct DerivedVariableBase {
+  virtual ~DerivedVariableBase() = default;
+  virtual void Evaluate() = 0;
+  virtual void Evaluate(VariableColumns &columns) = 0;
+};
+
+/**
+ * Variable computed from other variables.
+ * The function is evaluated into the values container or, for a batch of tracks, into a column.
+ * @tparam N number of input variables
+ * @tparam FUNCTION type of the function. Called with the values of the input variables.
+ */
+template<std::size_t N, typename FUNCTION>
+class DerivedVariable : public DerivedVariableBase {
+ public:
+  DerivedVariable(Variable var, std::array<Variable, N> inputs, FUNCTION function) :
+      var_(std::move(var)), inputs_(std::move(inputs)), function_(std::move(function)) {}
+
+  /**
+   * @brief Evaluates the variable from the values in the values container.
+   */
+  void Evaluate() override { EvaluateImpl(std::make_index_sequence<N>{}); }
+
+  /**
+   * @brief Evaluates the variable for a batch of tracks.
+   * If none of the inputs has a column the variable is evaluated once into the values container.
+   * Otherwise it is evaluated for each track into a column, which is added to the batch.
+   * @param columns values of the variables of all tracks of the batch.
+   */
+  void Evaluate(VariableColumns &columns) override { EvaluateImpl(columns, std::make_index_sequence<N>{}); }
+
+ private:
+  template<std::size_t... I>
+  void EvaluateImpl(std::index_sequence<I...>) {
+    *var_.begin() = function_(*inputs_[I].begin()...);
+  }
+
+  template<std::size_t... I>
+  void EvaluateImpl(VariableColumns &columns, std::index_sequence<I...>) {
+    std::array<const double *, N> data = {{columns.Column(inputs_[I])...}};
+    std::array<std::size_t, N> strides;
+    bool columnar = false;
+    for (std::size_t ivar = 0; ivar < N; ++ivar) {
+      strides[ivar] = data[ivar] ? 1 : 0;
+      columnar = columnar || data[ivar];
+      if (!data[ivar]) data[ivar] = inputs_[ivar].begin();
+    }
+    if (!columnar) {
+      EvaluateImpl(std::index_sequence<I...>{});
+      return;
+    }
+    std::array<double, N> values;
+    column_.resize(columns.size());
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      values = {{data[I][i*strides[I]]...}};
+      column_[i] = function_(values[I]...);
+    }
+    columns.SetColumn(var_, column_.data());
+  }
+
+  Variable var_; /// variable holding the result
+  std::array<Variable, N> inputs_; /// variables the result is computed from
+  FUNCTION function_; /// function computing the result
+  std::vector<double> column_; /// results of the tracks of a batch
+};
+
 /**
  * @brief Manages the input variables for the correction step.
  * A variable consist of a name and a unsigned integer position in the value array and an unsigned integer length.
@@ -119,6 +269,57 @@ class VariableManager {
     name_var_map_.emplace(name, var);
     var_name_map_.emplace(var, name);
   }
+  /**
+   * @brief Creates a variable of length one used internally by the framework.
+   * It is placed at the end of the values container counting downwards.
+   * @param name Name of the new variable.
+   * @return the new variable.
+   */
+  Variable CreateInternalVariable(const std::string &name) {
+    const int id = kMaxSize - 1 - n_internal_;
+    for (const auto &pair : var_name_map_) {
+      const auto &var = pair.first;
+      if (var.var_container==var_container_ && id >= var.id_ && id < var.id_ + var.length_) {
+        throw std::out_of_range("Internal variable " + name + " overlaps with variable " + pair.second + ".");
+      }
+    }
+    ++n_internal_;
+    CreateVariable(name, id, 1);
+    return FindVariable(name);
+  }
+  /**
+   * @brief Creates a variable computed from other variables.
+   * It is placed at the end of the values container like the internal variables.
+   * The variables are evaluated in the order of their creation, so they can be computed from earlier derived variables.
+   * @tparam N number of input variables
+   * @tparam FUNCTION type of the function.
+   * @param name Name of the new variable.
+   * @param names Names of the input variables.
+   * @param function function of signature double(double...) computing the variable from the inputs.
+   */
+  template<std::size_t N, typename FUNCTION>
+  void CreateDerivedVariable(const std::string &name, const char *const (&names)[N], FUNCTION &&function) {
+    std::array<Variable, N> inputs;
+    for (std::size_t i = 0; i < N; ++i) {
+      inputs[i] = FindVariable(names[i]);
+    }
+    auto var = CreateInternalVariable(name);
+    using Function = typename std::decay<FUNCTION>::type;
+    derived_.emplace_back(new DerivedVariable<N, Function>(var, inputs, std::forward<FUNCTION>(function)));
+  }
+  /**
+   * @brief Evaluates the derived variables into the values container.
+   */
+  void EvaluateDerivedVariables() {
+    for (auto &derived : derived_) { derived->Evaluate(); }
+  }
+  /**
+   * @brief Evaluates the derived variables for a batch of tracks.
+   * @param columns values of the variables of all tracks of the batch. Receives the columns of the derived variables.
+   */
+  void EvaluateDerivedVariables(VariableColumns &columns) {
+    for (auto &derived : derived_) { derived->Evaluate(columns); }
+  }
   /**
    * @brief Initializes the variable container for ones.
    */
@@ -207,10 +408,12 @@ class VariableManager {
   static constexpr int kMaxSize = 11000; /// Maximum number of variables.
   double *var_container_ = new double[kMaxSize]; /// non-owning pointer to variables
   double *var_ones_ = new double[kMaxSize]; /// values container of ones.
+  int n_internal_ = 0; /// number of internal variables
   std::map<std::string, Variable> name_var_map_; /// name to variable map
   std::map<Variable, std::string> var_name_map_; ///  variable to name map
   std::vector<OutValue<float>> output_vars_f_; /// variables registered for output as float
   std::vector<OutValue<Long64_t>> output_vars_l_; /// variables registered for output as long
+  std::vector<std::unique_ptr<DerivedVariableBase>> derived_; /// derived variables in order of evaluation
 };
 }
 
@@ -20,56 +20,21 @@
 
 void Qn::Correlation::FillCorrelation(size_type initial_offset,
                                       unsigned int n) {
-  const auto &i_input = **inputs_[n];
-  initial_offset += n;
-  // End recursion if last input DataContainer is reached: n+1 = number of inputs.
-  if (n + 1==inputs_.size()) {
-    size_type ibin = 0;
-    // Calculate result with Q-Vectors from previous recursion steps and all Q-Vectors of the current (last) input DataContainer.
-    for (const auto &qvector : i_input) {
-      // Sets multi-dimensional index in the resulting correlation DataContainer
-      // In case of integrated Q-Vectors no index is propagated to the resulting correlation.
-      // e.g. a correlation with 1 event variable and two Q-Vectors Q_1 and Q_2
-      // For non-integrated: event(h) x Q_1(i, j) x Q_2(k, l) -> (h, i, j, k, l)
-      // For integrated:     event(h) x Q_1()     x Q_2(k, l) -> (h, k, l)
-      if (!i_input.IsIntegrated()) {
-        size_type i_index = 0;
-        for (const auto &index : index_[n][ibin]) {
-          auto pos = i_index + initial_offset;
-          c_index_[pos] = index;
-          ++i_index;
-        }
-      }
-      // Adds a pointer to the current Q-Vector to the temporary container used for calculation of the correlation.
-      qvector_ptrs_[n] = Qn::QVectorPtr(qvector);
-      // Checks that all Q-Vectors are valid.
-      auto valid =
-          std::all_of(qvector_ptrs_.begin(), qvector_ptrs_.end(), [](const Qn::QVectorPtr &q) { return q.n() > 0; });
-      // Store result of the correlation.
-      if (valid) current_event_result_.At(c_index_) = Qn::Product(function_(qvector_ptrs_), valid, CalculateWeight());
-      ++ibin;
-    }
-    // end of recursion
-    return;
-  }
-  size_type ibin = 0;
-  for (const auto &qvector : i_input) {
-    size_type offset = initial_offset;
-    // Sets multi-dimensional index in the resulting correlation DataContainer
-    // In case of integrated Q-Vectors no index is propagated to the resulting correlation. See above.
-    if (!i_input.IsIntegrated()) {
-      size_type i_index = 0;
-      for (auto &index : index_[n][ibin]) {
-        offset += i_index;
-        c_index_[offset] = index;
-        ++i_index;
-      }
-    }
+  const auto &i_arrays = qvector_arrays_[n];
+  const auto &i_offsets = offsets_[n];
+  for (size_type ibin = 0; ibin < i_arrays.size(); ++ibin) {
+    const auto &qvector = i_arrays[ibin];
+    // Q-Vectors without entries invalidate all correlations they contribute to.
+    if (!(qvector.n() > 0)) continue;
     // Adds a pointer to the current Q-Vector to the temporary container used for calculation of the correlation.
     qvector_ptrs_[n] = QVectorPtr(qvector);
-    // next step of recursion
-    FillCorrelation(offset, n + 1);
-    ++ibin;
+    auto offset = initial_offset + i_offsets[ibin];
+    // End recursion if last input DataContainer is reached: n+1 = number of inputs.
+    if (n + 1==inputs_.size()) {
+      *(current_event_result_.begin() + offset) = Qn::Product(function_(qvector_ptrs_), true, CalculateWeight());
+    } else {
+      FillCorrelation(offset, n + 1);
+    }
   }
 }
 
@@ -77,12 +42,25 @@ void Qn::Correlation::Fill(const std::vector<unsigned long> &eventindices) {
   // Update eventindices in the result correlation index.
   size_type ieventvar = 0;
   for (auto &bin : current_event_result_) { bin.validity = false; }
+  // Copy the Q-Vectors of the inputs into contiguous arrays with directly indexed harmonics.
+  qvector_arrays_.resize(inputs_.size());
+  for (size_type i_input = 0; i_input < inputs_.size(); ++i_input) {
+    const auto &input = **inputs_[i_input];
+    auto &arrays = qvector_arrays_[i_input];
+    arrays.resize(input.size());
+    std::copy(input.begin(), input.end(), arrays.begin());
+  }
+  size_type offset = 0;
   for (auto eventindex : eventindices) {
-    c_index_[ieventvar] = eventindex;
+    offset += event_strides_[ieventvar]*eventindex;
     ++ieventvar;
   }
   // Fill the per-event-correlation result recursively.
-  FillCorrelation(ieventvar, 0);
+  if (kernel_) {
+    kernel_->Fill(*this, offset);
+  } else {
+    FillCorrelation(offset, 0);
+  }
 }
 
 void Qn::Correlation::Configure(std::map<std::string, Qn::DataContainerQVector *> *qvectors,
@@ -98,17 +76,9 @@ void Qn::Correlation::Configure(std::map<std::string, Qn::DataContainerQVector *
     std::string errormsg = ("correlation ") + name_ + "trying to add axes, but they already exist.";
     throw std::logic_error(errormsg);
   }
-  // Prepare a map of all indices of the correlation
-  auto dimension = event_axes.size();
   size_type i_input = 0;
   for (const auto &inputptr : inputs_) {
     auto input = *inputptr;
-    if (!input->IsIntegrated()) dimension += input->GetAxes().size();
-    std::vector<std::vector<unsigned long>> indexmap; // vector of multi-dimensional indices of one Input Q-Vector.
-    for (size_type ibin = 0; ibin < input->size(); ++ibin) {
-      indexmap.emplace_back(input->GetIndex(ibin));
-    }
-    index_.push_back(indexmap);
     // Adds remaining axes to the result of the correlation in case of non-integrated Q-Vectors.
     if (!input->IsIntegrated()) {
       auto axes = input->GetAxes();
@@ -145,5 +115,28 @@ void Qn::Correlation::Configure(std::map<std::string, Qn::DataContainerQVector *
       }
     }
   }
-  c_index_.resize(dimension);
+  // Prepare the linear offsets in the result of the event bins and of the bins of all inputs.
+  // The axes of the result are the event axes followed by the axes of the non-integrated inputs.
+  const auto &result_axes = current_event_result_.GetAxes();
+  std::vector<size_type> strides(result_axes.size(), 1);
+  for (auto i_axis = result_axes.size(); i_axis-- > 1;) {
+    strides[i_axis - 1] = strides[i_axis]*result_axes[i_axis].size();
+  }
+  event_strides_.assign(strides.begin(), strides.begin() + event_axes.size());
+  offsets_.clear();
+  auto position = event_axes.size();
+  for (const auto &inputptr : inputs_) {
+    auto input = *inputptr;
+    std::vector<size_type> offsets(input->size(), 0);
+    if (!input->IsIntegrated()) {
+      for (size_type ibin = 0; ibin < input->size(); ++ibin) {
+        auto indices = input->GetIndex(ibin);
+        for (size_type i_axis = 0; i_axis < indices.size(); ++i_axis) {
+          offsets[ibin] += strides[position + i_axis]*indices[i_axis];
+        }
+      }
+      position += input->GetAxes().size();
+    }
+    offsets_.push_back(offsets);
+  }
 }
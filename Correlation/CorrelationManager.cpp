@@ -16,11 +16,99 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <memory>
+#include <thread>
+
+#include "TChain.h"
+#include "TROOT.h"
 
 #include "CorrelationManager.h"
 
 namespace Qn {
 
+/**
+ * @brief Independent unit of the parallel event loop.
+ * Reads the input with its own TTreeReader and evaluates its own copies of the configured correlations.
+ * The correlation results of the accepted events are stored until they are merged by the CorrelationManager.
+ */
+struct CorrelationManager::Worker {
+  explicit Worker(const CorrelationManager &manager);
+
+  /**
+   * Processes the entries in the range [first, last).
+   * @param first first entry
+   * @param last entry after the last processed entry.
+   */
+  void Process(size_type first, size_type last);
+
+  const CorrelationManager &manager_; ///< manager providing the configuration
+  std::unique_ptr<TFile> file_; ///< input file in case the input is a TTree
+  std::unique_ptr<TChain> chain_; ///< input chain in case the input is a TChain
+  std::unique_ptr<TTreeReader> reader_; ///< reader of this worker
+  std::map<std::string, TTreeReaderValue<Qn::DataContainerQVector>> tree_values_; ///< Q-vectors in the input tree
+  std::map<std::string, Qn::DataContainerQVector *> qvectors_; ///< Q-vectors of the current event
+  std::map<std::string, Qn::DataContainerQVector> qvectors_proj_; ///< projected Q-vectors of the current event
+  std::vector<Qn::Correlation> correlations_; ///< correlations in the order of the StatsResults
+  std::unique_ptr<Qn::EventAxes> event_axes_; ///< event axes reading from this worker
+  std::unique_ptr<Qn::EventCuts> event_cuts_; ///< event cuts reading from this worker
+  std::vector<size_type> entries_; ///< entries which passed the event selection
+  std::vector<Qn::Product> products_; ///< correlation results of all entries which passed the event selection
+};
+
+CorrelationManager::Worker::Worker(const CorrelationManager &manager) : manager_(manager) {
+  TTree *tree = nullptr;
+  if (auto chain = dynamic_cast<TChain *>(manager.tree_)) {
+    chain_ = std::make_unique<TChain>(chain->GetName());
+    for (const auto element : *chain->GetListOfFiles()) {
+      chain_->Add(element->GetTitle());
+    }
+    tree = chain_.get();
+  } else if (manager.tree_->GetCurrentFile()) {
+    file_.reset(TFile::Open(manager.tree_->GetCurrentFile()->GetName(), "READ"));
+    if (file_) tree = dynamic_cast<TTree *>(file_->Get(manager.tree_->GetName()));
+  }
+  if (!tree) {
+    throw std::logic_error(std::string("input tree ") + manager.tree_->GetName()
+                               + " cannot be opened by the worker. aborting.");
+  }
+  reader_ = std::make_unique<TTreeReader>(tree);
+  for (const auto &value : manager.tree_values_) {
+    tree_values_.emplace(value.first, TTreeReaderValue<Qn::DataContainerQVector>(*reader_, value.first.data()));
+  }
+  for (const auto &qvector : *manager.qvectors_) {
+    qvectors_.emplace(qvector.first, nullptr);
+  }
+  qvectors_proj_ = manager.qvectors_proj_;
+  for (const auto &stats : manager.stats_results_) {
+    correlations_.push_back(*manager.correlations_.at(stats.first));
+  }
+  for (auto &correlation : correlations_) {
+    correlation.Reconnect(&qvectors_);
+  }
+  event_axes_ = std::make_unique<Qn::EventAxes>(manager.event_axes_, *reader_);
+  event_cuts_ = std::make_unique<Qn::EventCuts>(manager.event_cuts_, *reader_);
+}
+
+void CorrelationManager::Worker::Process(size_type first, size_type last) {
+  entries_.clear();
+  products_.clear();
+  for (auto entry = first; entry < last; ++entry) {
+    reader_->SetEntry(entry);
+    for (auto &value : tree_values_) {
+      qvectors_[value.first] = value.second.Get();
+    }
+    manager_.MakeProjections(qvectors_, qvectors_proj_);
+    if (event_axes_->CheckEvent() && event_cuts_->CheckCuts()) {
+      const auto &bin = event_axes_->GetBin();
+      entries_.push_back(entry);
+      for (auto &correlation : correlations_) {
+        correlation.Fill(bin);
+        const auto &result = correlation.GetResult();
+        products_.insert(products_.end(), result.begin(), result.end());
+      }
+    }
+  }
+}
+
 /**
  * Adds a new DataContainer to the correlation manager.
  * Actual value is retrieved when the tree is read from the file.
@@ -103,7 +191,7 @@ void CorrelationManager::Initialize() {
   reader_->SetEntry(1);
 // initialize values to be able to build the correlations.
   UpdateEvent();
-  MakeProjections();
+  ConfigureProjections();
 // configure the resampling using the number of event of the
   if (sampler_) {
     sampler_->CreateSamples();
@@ -139,6 +227,10 @@ void CorrelationManager::Finalize() {
 }
 
 void CorrelationManager::Run() {
+  if (num_threads_ > 1) {
+    RunParallel();
+    return;
+  }
   Initialize();
   while (reader_->Next()) {
     UpdateEvent();
@@ -161,6 +253,55 @@ void CorrelationManager::Run() {
   Finalize();
 }
 
+/**
+ * @brief Runs the event loop on several threads.
+ * The entries are processed in rounds. In each round every worker processes the next block of entries.
+ * The stored results are filled to the StatsResults in the order of the entries, after all workers of the round finished.
+ */
+void CorrelationManager::RunParallel() {
+  if (!ese_handler_.IsEmpty()) {
+    throw std::logic_error("event shape engineering is not supported in the parallel event loop. aborting.");
+  }
+  ROOT::EnableThreadSafety();
+  Initialize();
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (unsigned int i = 0; i < num_threads_; ++i) {
+    workers.push_back(std::make_unique<Worker>(*this));
+  }
+  size_type first = 0;
+  while (first < num_events_) {
+    std::vector<std::thread> threads;
+    for (auto &worker : workers) {
+      auto last = std::min(first + block_size_, num_events_);
+      threads.emplace_back(&Worker::Process, worker.get(), first, last);
+      first = last;
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (auto &worker : workers) {
+      auto product = worker->products_.cbegin();
+      for (auto entry : worker->entries_) {
+        auto correlation = worker->correlations_.begin();
+        for (auto &stats : stats_results_) {
+          stats.second.Fill(product, entry);
+          product += correlation->GetResult().size();
+          ++correlation;
+        }
+      }
+    }
+    if (debug_mode_) {
+      std::cout << "processed " << first << " of " << num_events_ << " events\r";
+      std::cout.flush();
+    }
+  }
+  if (debug_mode_) std::cout << std::endl;
+  for (const auto &worker : workers) {
+    event_cuts_.MergeReport(*worker->event_cuts_);
+  }
+  Finalize();
+}
+
 void CorrelationManager::UpdateEvent() {
   for (auto &value : tree_values_) {
     (*qvectors_)[value.first] = value.second.Get();
@@ -169,18 +310,46 @@ void CorrelationManager::UpdateEvent() {
   ese_handler_.UpdateIDs();
 }
 
+/**
+ * @brief Prepares the projections of the Q-vectors using the binning of the current event.
+ */
+void CorrelationManager::ConfigureProjections() {
+  projection_plans_.clear();
+  for (const auto &projection : projections_) {
+    const auto &input = std::get<0>(projection.second);
+    const auto &axes = std::get<1>(projection.second);
+    projection_plans_.emplace(projection.first, ProjectionPlan(*(*qvectors_)[input], axes));
+  }
+}
+
 void CorrelationManager::MakeProjections() {
+  MakeProjections(*qvectors_, qvectors_proj_);
+}
+
+/**
+ * @brief Projects the Q-vectors of the current event.
+ * The prepared projections are used, if the binning of the Q-vectors matches the binning they were prepared with.
+ * @param qvectors Q-vectors of the current event.
+ * @param qvectors_proj projected Q-vectors of the current event.
+ */
+void CorrelationManager::MakeProjections(std::map<std::string, Qn::DataContainerQVector *> &qvectors,
+                                         std::map<std::string, Qn::DataContainerQVector> &qvectors_proj) const {
   auto function = [](Qn::QVector a, const Qn::QVector &b) {
     a.CopyHarmonics(b);
     auto norm = b.GetNorm();
     return (a + b).Normal(norm);
   };
   for (const auto &projection : projections_) {
-    auto input = projection.first;
-    const auto &output = std::get<0>(projection.second);
+    const auto &input = *qvectors[std::get<0>(projection.second)];
     const auto &axes = std::get<1>(projection.second);
-    qvectors_proj_[projection.first] = (*qvectors_)[output]->Projection(axes, function);
-    (*qvectors_)[projection.first] = &qvectors_proj_[input];
+    auto &output = qvectors_proj[projection.first];
+    auto plan = projection_plans_.find(projection.first);
+    if (plan!=projection_plans_.end() && plan->second.IsApplicable(input, output)) {
+      plan->second.Fill(input, output);
+    } else {
+      output = input.Projection(axes, function);
+    }
+    qvectors[projection.first] = &output;
   }
 }
 
@@ -210,6 +379,18 @@ Qn::Correlation *CorrelationManager::RegisterCorrelation(const std::string &name
   return correlations_.at(name).get();
 }
 
+Qn::Correlation *CorrelationManager::RegisterCorrelation(const std::string &name,
+                                                         const std::vector<std::string> &inputs,
+                                                         std::shared_ptr<const CorrelationKernelBase> kernel,
+                                                         std::vector<Qn::Weight> use_weights) {
+  std::for_each(inputs.begin(), inputs.end(), [this](const std::string &item) { this->AddDataContainer(item); });
+  if (correlations_.find(name)==correlations_.end()) {
+    auto correlation = std::make_unique<Qn::Correlation>(name, inputs, std::move(kernel), use_weights);
+    correlations_.emplace(name, std::move(correlation));
+  }
+  return correlations_.at(name).get();
+}
+
 void CorrelationManager::ProgressBar() {
   progress_ = (float) current_event_/num_events_;
   current_event_++;
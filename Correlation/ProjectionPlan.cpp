@@ -0,0 +1,119 @@
+// Flow Vector Correction Framework
+//
+// Copyright (C) 2018  Lukas Kreis, Ilya Selyuzhenkov
+// Contact: l.kreis@gsi.de; ilya.selyuzhenkov@gmail.com
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+
+#include "ProjectionPlan.h"
+
+namespace Qn {
+
+/**
+ * Constructor
+ * @param input container with the binning of the projected Q-vectors.
+ * @param axes names of the axes used for the projection. All axes are integrated if empty.
+ */
+ProjectionPlan::ProjectionPlan(const DataContainerQVector &input, const std::vector<std::string> &axes) :
+    map_(input.ProjectionMap(axes)),
+    integrated_(axes.empty()) {
+  for (const auto bin : map_) {
+    if (bin + 1 > output_size_) output_size_ = bin + 1;
+  }
+}
+
+/**
+ * Projects the input container into the output container.
+ * The harmonics of the output Q-vectors are reused, such that no memory is allocated once they are in place.
+ * @param input container to be projected.
+ * @param output projection. Needs to have the binning of the projection.
+ */
+void ProjectionPlan::Fill(const DataContainerQVector &input, DataContainerQVector &output) const {
+  for (auto &sum : output) {
+    Reset(sum);
+  }
+  auto target = map_.cbegin();
+  for (auto qvector = input.begin(); qvector!=input.end(); ++qvector, ++target) {
+    auto &sum = *(output.begin() + *target);
+    if (integrated_ && qvector==input.begin()) {
+      sum = *qvector;
+    } else {
+      Add(sum, *qvector);
+    }
+  }
+}
+
+/**
+ * Resets the Q-vector to an empty Q-vector without releasing its memory.
+ * @param sum Q-vector to be reset.
+ */
+void ProjectionPlan::Reset(QVector &sum) {
+  sum.norm_ = QVector::Normalization::NONE;
+  sum.n_ = 0;
+  sum.sum_weights_ = 0.;
+  sum.bits_.reset();
+  sum.q_.clear();
+}
+
+/**
+ * Adds a Q-vector to the sum in place.
+ * Equivalent to sum.CopyHarmonics(qvector) followed by (sum + qvector).Normal(qvector.GetNorm()).
+ * @param sum sum of the Q-vectors
+ * @param qvector added Q-vector
+ */
+void ProjectionPlan::Add(QVector &sum, const QVector &qvector) {
+  using Normalization = QVector::Normalization;
+  auto denormal = [](QVec q, Normalization norm, float sum_weights) {
+    switch (norm) {
+      case (Normalization::NONE): return q;
+      case (Normalization::M): return q*sum_weights;
+      case (Normalization::SQRT_M): return q*std::sqrt(sum_weights);
+      case (Normalization::MAGNITUDE): return q*Qn::norm(q);
+    }
+    return q;
+  };
+  auto valid = [](QVec q) { return (std::isnan(q.x) || std::isnan(q.y)) ? QVec{0., 0.} : q; };
+  sum.bits_ = qvector.bits_;
+  sum.q_.resize(qvector.q_.size());
+  sum.n_ += qvector.n_;
+  const auto sum_weights = sum.sum_weights_;
+  sum.sum_weights_ += qvector.sum_weights_;
+  const auto norm = qvector.GetNorm();
+  for (std::size_t i = 0; i < sum.q_.size(); ++i) {
+    auto q = valid(denormal(sum.q_[i], sum.norm_, sum_weights))
+        + valid(denormal(qvector.q_[i], qvector.norm_, qvector.sum_weights_));
+    switch (norm) {
+      case (Normalization::NONE): {
+        break;
+      }
+      case (Normalization::M): {
+        q = sum.sum_weights_!=0 ? q/sum.sum_weights_ : QVec{0., 0.};
+        break;
+      }
+      case (Normalization::SQRT_M): {
+        q = sum.sum_weights_ > 0 ? q/std::sqrt(sum.sum_weights_) : QVec{0., 0.};
+        break;
+      }
+      case (Normalization::MAGNITUDE): {
+        q = Qn::norm(q)!=0 ? q/Qn::norm(q) : QVec{0., 0.};
+        break;
+      }
+    }
+    sum.q_[i] = q;
+  }
+  sum.norm_ = norm;
+}
+
+}
@@ -17,11 +17,77 @@
 
 #include "Sampler.h"
 
+#include <array>
+#include <cstdint>
 #include <random>
 #include <algorithm>
 
 #include "TRandom3.h"
 
+namespace {
+/**
+ * Philox4x32-10 counter-based random number generator.
+ * See J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11.
+ * @param counter counter which is replaced by the four random numbers.
+ * @param key key of the generator
+ */
+void Philox4x32(std::array<uint32_t, 4> &counter, std::array<uint32_t, 2> key) {
+  constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  constexpr uint32_t kWeyl1 = 0xBB67AE85;
+  for (unsigned int round = 0; round < 10; ++round) {
+    if (round > 0) {
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    auto product0 = static_cast<uint64_t>(kMultiplier0)*counter[0];
+    auto product1 = static_cast<uint64_t>(kMultiplier1)*counter[2];
+    counter = {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(product1),
+                static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(product0)}};
+  }
+}
+
+/**
+ * Draws a number from a Poisson distribution with mean one using the inversion method.
+ * @param random uniformly distributed 32 bit random number
+ * @return multiplicity
+ */
+unsigned int PoissonOne(uint32_t random) {
+  constexpr unsigned int kMaxMultiplicity = 16;
+  const double uniform = random*(1./4294967296.);
+  double probability = 0.36787944117144233; // exp(-1)
+  double cumulative = probability;
+  unsigned int multiplicity = 0;
+  while (uniform >= cumulative && multiplicity < kMaxMultiplicity) {
+    ++multiplicity;
+    probability /= multiplicity;
+    cumulative += probability;
+  }
+  return multiplicity;
+}
+}
+
+void Qn::Sampler::CreatePoissonSamples(size_type ievent, std::vector<size_type> &samples) const {
+  samples.clear();
+  const std::array<uint32_t, 2> key = {{static_cast<uint32_t>(seed_), static_cast<uint32_t>(uint64_t(seed_) >> 32)}};
+  std::array<uint32_t, 4> random = {{0, 0, 0, 0}};
+  for (size_type isample = 0; isample < n_samples_; ++isample) {
+    auto iword = isample%4;
+    if (iword==0) {
+      random = {{static_cast<uint32_t>(ievent), static_cast<uint32_t>(uint64_t(ievent) >> 32),
+                 static_cast<uint32_t>(isample/4), 0}};
+      Philox4x32(random, key);
+    }
+    auto multiplicity = PoissonOne(random[iword]);
+    for (unsigned int i = 0; i < multiplicity; ++i) {
+      samples.push_back(isample);
+    }
+  }
+}
+
 void Qn::Sampler::CreateSubSamples() {
   TRandom3 random;
   std::vector<int> event_vector;
@@ -21,46 +21,31 @@ namespace Qn {
 
 void StatsResult::Fill(const size_type event_id) {
   // Fill result to the event average statistic DataContainer.
-     const auto &current_event_result = correlation_current_event->GetResult();
-    if (use_resampling_) {
-      unsigned int ibin = 0;
-      for (auto &bin : result_) {
-        bin.Fill(current_event_result.At(ibin), resampler_->GetFillVector(event_id));
-        ++ibin;
-      }
-    } else {
-      unsigned int ibin = 0;
-      for (auto &bin : result_) {
-        bin.Fill(current_event_result.At(ibin), {});
-        ++ibin;
-      }
-    }
-  }
+  Fill(correlation_current_event->GetResult().begin(), event_id);
+}
 
-void StatsResult::ConfigureStats(Qn::Sampler *sampler) {
+void StatsResult::Fill(std::vector<Qn::Product>::const_iterator products, const size_type event_id) {
+  static const std::vector<size_type> no_samples;
+  result_.Fill(&*products, use_resampling_ ? resampler_->GetFillVector(event_id, samples_) : no_samples);
+}
 
+void StatsResult::ConfigureStats(Qn::Sampler *sampler) {
   const auto &current_event_result = correlation_current_event->GetResult();
-  // configure the result datacontainer
-  result_.AddAxes(current_event_result.GetAxes());
   // configure weights
-  if (correlation_current_event->UsingWeights()) {
-    std::for_each(result_.begin(), result_.end(), [](Qn::Stats &stats) { stats.SetStatus(Stats::Status::OBSERVABLE); });
-  } else {
-    std::for_each(result_.begin(), result_.end(), [](Qn::Stats &stats) { stats.SetStatus(Stats::Status::REFERENCE); });
-  }
-  // configure sampler
+  auto status = correlation_current_event->UsingWeights() ? Stats::Status::OBSERVABLE : Stats::Status::REFERENCE;
+  // configure the result container and the sampler
   if (use_resampling_) {
     if (sampler) {
       resampler_ = sampler;
-      for (auto &bin :result_) {
-        bin.SetNumberOfSubSamples(resampler_->GetNumSamples());
-      }
-    }
-    else {
+      result_ = StatsAccumulator(current_event_result.GetAxes(), resampler_->GetNumSamples(), status);
+    } else {
       use_resampling_ = false;
+      result_ = StatsAccumulator(current_event_result.GetAxes(), 0, status);
       throw NoResamplerException();
     }
+  } else {
+    result_ = StatsAccumulator(current_event_result.GetAxes(), 0, status);
   }
 }
 
-}
\ No newline at end of file
+}
@@ -18,6 +18,8 @@
 #ifndef FLOW_CORRELATIONBASE_H
 #define FLOW_CORRELATIONBASE_H
 
+#include <memory>
+#include <type_traits>
 #include <utility>
 #include "DataContainer.h"
 
@@ -35,6 +37,24 @@ enum class Weight {
 auto constexpr kRef = Qn::Weight::REFERENCE;
 auto constexpr kObs = Qn::Weight::OBSERVABLE;
 
+class Correlation;
+
+/**
+ * @class CorrelationKernelBase
+ * @brief Base class of the correlation kernels.
+ * A kernel evaluates the correlation of all combinations of the input bins of the current event.
+ */
+class CorrelationKernelBase {
+ public:
+  virtual ~CorrelationKernelBase() = default;
+  /**
+   * Fills the result of the correlation for the current event.
+   * @param correlation correlation holding the inputs and the result of the current event.
+   * @param offset linear offset of the event bin in the result.
+   */
+  virtual void Fill(Correlation &correlation, std::size_t offset) const = 0;
+};
+
 /**
  * @class Correlation
  * @brief abstract baseclass of the correlation
@@ -58,6 +78,16 @@ class Correlation {
     for (size_type i = 0; i < names_.size(); ++i) { use_weights_.push_back(use_weights[i]==Qn::kObs); }
   }
 
+  Correlation(std::string name,
+              std::vector<std::string> names,
+              std::shared_ptr<const CorrelationKernelBase> kernel,
+              std::vector<Qn::Weight> use_weights) :
+      name_(std::move(name)),
+      names_(std::move(names)),
+      kernel_(std::move(kernel)) {
+    for (size_type i = 0; i < names_.size(); ++i) { use_weights_.push_back(use_weights[i]==Qn::kObs); }
+  }
+
   Correlation(std::string name, std::vector<std::string> names, function_type function) :
       name_(std::move(name)),
       names_(std::move(names)),
@@ -92,6 +122,18 @@ class Correlation {
    */
   void Configure(std::map<std::string, Qn::DataContainerQVector *> *qvectors, const std::vector<Qn::Axis> &eventaxes);
 
+  /**
+   * Points a configured correlation to another set of inputs with the same names.
+   * Used to evaluate copies of the correlation on independently read events.
+   * @param qvectors map of qvector inputs
+   */
+  void Reconnect(std::map<std::string, Qn::DataContainerQVector *> *qvectors) {
+    inputs_.clear();
+    for (const auto &cname : names_) {
+      inputs_.push_back(&qvectors->at(cname));
+    }
+  }
+
   /**
    * Returns the name of the correlation.
    * @return Name of the correlation
@@ -99,18 +141,23 @@ class Correlation {
   std::string GetName() const { return name_; }
 
  private:
+  template<std::size_t N, typename FUNCTION> friend class CorrelationKernel;
+
   std::string name_; ///< name of the correlation
   std::vector<std::string> names_; ///< vector of input names
   inputs_type inputs_; ///< pointer to the Q-Vector inputs during the correlation step.
+  std::vector<std::vector<QVectorArray>> qvector_arrays_; ///< contiguous copies of the Q-Vector inputs of the current event
   std::vector<QVectorPtr> qvector_ptrs_; ///< vector holding pointers to the Q-Vector during FillCorrelation step
   std::vector<bool> use_weights_; ///< vector of input weights
   function_type function_; ///< correlation function
-  std::vector<std::vector<std::vector<size_type>>> index_; ///< map of multi-dimensional indices of all inputs
-  std::vector<size_type> c_index_; ///<  multi-dimensional indices of a bin of the resulting correlation
+  std::shared_ptr<const CorrelationKernelBase> kernel_; ///< correlation kernel used instead of the correlation function
+  std::vector<std::vector<size_type>> offsets_; ///< linear offset in the result of each bin of all inputs
+  std::vector<size_type> event_strides_; ///< strides of the event axes in the result
   Qn::DataContainerProduct current_event_result_; ///< result of the correlation of the current event
 
   /**
    * Iterative function which fills the correlation
+   * The linear offset of a bin of the result is the sum of the offsets of the event bin and of all input bins.
    * @param initial_offset linearized initial offset for the resulting bin container
    * @param n iteration at n+1=N(inputs) the iteration ends.
    */
@@ -134,6 +181,84 @@ class Correlation {
 
 };
 
+
+namespace Details {
+template<std::size_t>
+using QVectorArrayRef = const QVectorArray &;
+
+/**
+ * Checks if a function can be called with one Q-vector per input.
+ * @tparam FUNCTION type of the function
+ * @tparam INDICES index sequence of the inputs
+ */
+template<typename FUNCTION, typename INDICES, typename = void>
+struct IsCorrelationKernel : std::false_type {};
+
+template<typename FUNCTION, std::size_t... I>
+struct IsCorrelationKernel<FUNCTION,
+                           std::index_sequence<I...>,
+                           decltype(void(std::declval<const FUNCTION &>()(std::declval<QVectorArrayRef<I>>()...)))>
+    : std::true_type {
+};
+}
+
+/**
+ * @class CorrelationKernel
+ * @brief Correlation kernel instantiated for the type of the correlation function.
+ * The loops over the input bins are unrolled for the number of inputs and the function is called directly with the
+ * Q-vectors, which allows the compiler to inline it.
+ * @tparam N number of inputs
+ * @tparam FUNCTION type of the function of signature double(const QVectorArray &...) with one argument per input.
+ */
+template<std::size_t N, typename FUNCTION>
+class CorrelationKernel : public CorrelationKernelBase {
+  using size_type = std::size_t;
+  template<std::size_t I>
+  using Input = std::integral_constant<std::size_t, I>;
+ public:
+  explicit CorrelationKernel(FUNCTION function) : function_(std::move(function)) {}
+
+  void Fill(Correlation &correlation, size_type offset) const override {
+    const QVectorArray *qvectors[N];
+    FillInput(correlation, offset, qvectors, Input<0>{});
+  }
+
+ private:
+  FUNCTION function_; ///< correlation function
+
+  /**
+   * Loops over the bins of input I.
+   * Bins without entries invalidate all correlations they contribute to and are skipped.
+   */
+  template<std::size_t I>
+  void FillInput(Correlation &correlation, size_type offset, const QVectorArray *(&qvectors)[N], Input<I>) const {
+    const auto &arrays = correlation.qvector_arrays_[I];
+    const auto &offsets = correlation.offsets_[I];
+    for (size_type ibin = 0; ibin < arrays.size(); ++ibin) {
+      if (!(arrays[ibin].n() > 0)) continue;
+      qvectors[I] = &arrays[ibin];
+      FillInput(correlation, offset + offsets[ibin], qvectors, Input<I + 1>{});
+    }
+  }
+
+  /**
+   * Evaluates the correlation when the bins of all inputs are chosen.
+   */
+  void FillInput(Correlation &correlation, size_type offset, const QVectorArray *(&qvectors)[N], Input<N>) const {
+    double weight = 1.;
+    for (size_type i = 0; i < N; ++i) {
+      if (correlation.use_weights_[i]) weight *= qvectors[i]->sumweights();
+    }
+    *(correlation.current_event_result_.begin() + offset) =
+        Qn::Product(Evaluate(qvectors, std::make_index_sequence<N>{}), true, weight);
+  }
+
+  template<std::size_t... I>
+  double Evaluate(const QVectorArray *(&qvectors)[N], std::index_sequence<I...>) const {
+    return function_(*qvectors[I]...);
+  }
+};
+
 }
 
 #endif
@@ -32,6 +32,7 @@
 #include "EseHandler.h"
 #include "EventAxes.h"
 #include "EventCuts.h"
+#include "ProjectionPlan.h"
 
 #include "ROOT/RMakeUnique.hxx"
 
@@ -55,6 +56,27 @@ class CorrelationManager {
   void AddEventAxis(const Axis &eventaxis);
   void AddCorrelation(std::string name, const std::vector<std::string> &input, function_t lambda,
                       const std::vector<Weight> &use_weights, Sampler::Resample resample = Sampler::Resample::ON);
+  /**
+   * @brief Adds a correlation evaluated with a function of fixed arity.
+   * The correlation is instantiated for the type of the function, which allows the compiler to inline it.
+   * Template parameters are automatically deduced.
+   * @tparam N number of inputs
+   * @tparam FUNCTION type of the function
+   * @param name Name of the correlation under which it is saved to the file
+   * @param input Names of the input datacontainers.
+   * @param lambda Function of signature double(const Qn::QVectorArray &...) with one argument per input.
+   * @param use_weights weights of the inputs used in the correlation.
+   * @param resample resampling of the correlation
+   */
+  template<std::size_t N, typename FUNCTION, typename = std::enable_if_t<
+      Details::IsCorrelationKernel<std::decay_t<FUNCTION>, std::make_index_sequence<N>>::value>>
+  void AddCorrelation(std::string name, const char *const (&input)[N], FUNCTION &&lambda,
+                      const std::vector<Weight> &use_weights, Sampler::Resample resample = Sampler::Resample::ON) {
+    std::vector<std::string> inputs(std::begin(input), std::end(input));
+    auto kernel = std::make_shared<const CorrelationKernel<N, std::decay_t<FUNCTION>>>(std::forward<FUNCTION>(lambda));
+    stats_results_.emplace(name, StatsResult{resample, RegisterCorrelation(name, inputs, kernel, use_weights)});
+  }
+
   void AddEventShape(const std::string &name,
                      const std::vector<std::string> &input,
                      function_t lambda,
@@ -70,6 +92,22 @@ class CorrelationManager {
     ese_handler_.SetOutput(tree_file_name, ese_name);
   }
 
+  /**
+   * @brief Enables the parallel event loop.
+   * Blocks of consecutive entries are processed by independent workers, each with its own reader and correlations.
+   * The per-event results are merged in the order of the entries, which makes the output identical to a serial run.
+   * Correlation functions and event cuts need to be safe to call concurrently.
+   * @param nthreads number of worker threads. One disables the parallel event loop.
+   * @param block_size number of entries processed by one worker before its results are merged.
+   */
+  void SetNumberOfThreads(unsigned int nthreads, size_type block_size = 1000) {
+    if (nthreads==0 || block_size==0) {
+      throw std::logic_error("number of threads and block size need to be larger than zero.");
+    }
+    num_threads_ = nthreads;
+    block_size_ = block_size;
+  }
+
   void Run();
 
   void EnableDebug() { debug_mode_ = true; }
@@ -107,14 +145,23 @@ class CorrelationManager {
   friend class Qn::EventAxes;
   friend class Qn::EseHandler;
 
+  struct Worker;
+
   void AddDataContainer(const std::string &name);
 
   void Initialize();
 
   void Finalize();
 
+  void ConfigureProjections();
+
   void MakeProjections();
 
+  void MakeProjections(std::map<std::string, Qn::DataContainerQVector *> &qvectors,
+                       std::map<std::string, Qn::DataContainerQVector> &qvectors_proj) const;
+
+  void RunParallel();
+
   void ConfigureCorrelations();
 
   void UpdateEvent();
@@ -124,6 +171,11 @@ class CorrelationManager {
                                        function_t lambda,
                                        std::vector<Qn::Weight> use_weights);
 
+  Qn::Correlation *RegisterCorrelation(const std::string &name,
+                                       const std::vector<std::string> &inputs,
+                                       std::shared_ptr<const CorrelationKernelBase> kernel,
+                                       std::vector<Qn::Weight> use_weights);
+
   void AddFriend(const std::string &treename, TFile *file) { tree_->AddFriend(treename.data(), file); }
 
   std::shared_ptr<TTreeReader> &GetReader() { return reader_; }
@@ -134,6 +186,8 @@ class CorrelationManager {
   size_type current_event_ = 0;
   float progress_ = 0.;
   bool debug_mode_ = false;
+  unsigned int num_threads_ = 1;
+  size_type block_size_ = 1000;
   size_type num_events_ = 0;
   std::unique_ptr<Qn::Sampler> sampler_ = nullptr;
   Qn::EseHandler ese_handler_;
@@ -145,6 +199,7 @@ class CorrelationManager {
   std::map<std::string, std::unique_ptr<Qn::Correlation>> correlations_;
   std::map<std::string, Qn::StatsResult> stats_results_;
   std::map<std::string, std::tuple<std::string, std::vector<std::string>>> projections_;
+  std::map<std::string, Qn::ProjectionPlan> projection_plans_;
   std::map<std::string, TTreeReaderValue<Qn::DataContainerQVector>> tree_values_;
   std::unique_ptr<std::map<std::string, Qn::DataContainerQVector *>> qvectors_;
   std::map<std::string, Qn::DataContainerQVector> qvectors_proj_;
@@ -123,6 +123,12 @@ class EseHandler {
     return report;
   }
 
+  /**
+   * Checks if any event shape subevent is configured.
+   * @return true if no event shape engineering is requested.
+   */
+  bool IsEmpty() const { return subevents_.empty(); }
+
   Qn::Correlation *RequestCorrelation(const SubEventPrototype &prototype);
 
   void RequestEventAxis(const Qn::Axis &axis);
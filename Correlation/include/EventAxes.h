@@ -19,6 +19,7 @@
 #define FLOW_EVENTAXES_H
 
 #include "TTreeReaderValue.h"
+#include "ROOT/RMakeUnique.hxx"
 
 #include "Axis.h"
 
@@ -36,6 +37,7 @@ class EventAxisInterface {
   virtual bool IsValid() = 0;
   virtual ~EventAxisInterface() = default;
   virtual const Qn::Axis &GetAxis() const = 0;
+  virtual std::unique_ptr<EventAxisInterface> Clone(TTreeReader &reader) const = 0;
 };
 
 /**
@@ -74,6 +76,15 @@ class EventAxis : public EventAxisInterface {
    */
   bool IsValid() override { return !std::isnan(*value_.Get()); }
 
+  /**
+   * Creates a copy of the axis which reads its value using a different TTreeReader.
+   * @param reader reader of the copy
+   * @return Returns the copy of the axis
+   */
+  std::unique_ptr<EventAxisInterface> Clone(TTreeReader &reader) const override {
+    return std::make_unique<EventAxis<T>>(axis_, TTreeReaderValue<T>(reader, value_.GetBranchName()));
+  }
+
  private:
   Qn::Axis axis_; /// Underlying axies determining the binning and the name
   TTreeReaderValue<T> value_; /// value of the currently read entry from the TTree
@@ -97,6 +108,17 @@ class EventAxes {
 
   explicit EventAxes(Qn::CorrelationManager *manager) : manager_(manager) {}
 
+  /**
+   * @brief Copies the event axes, reading the values with a different TTreeReader.
+   * @param other event axes to be copied
+   * @param reader reader used by the copy
+   */
+  EventAxes(const EventAxes &other, TTreeReader &reader) : manager_(other.manager_), bin_(other.bin_) {
+    for (const auto &axis : other.event_axes_) {
+      event_axes_.push_back(axis->Clone(reader));
+    }
+  }
+
   /**
    * @brief Registers a new axes with a specific datatype to be read from the tree and used for binning.
    * @param axis Axis specifing the name and the size of the binning for the correlations.
@@ -20,6 +20,7 @@
 
 #include <string>
 #include "TTreeReaderValue.h"
+#include "TH1.h"
 #include "ROOT/RMakeUnique.hxx"
 #include "ROOT/RIntegerSequence.hxx"
 
@@ -32,6 +33,7 @@ struct EventCutBase {
   virtual ~EventCutBase() = default;
   virtual bool Check() = 0;
   virtual std::string Name() = 0;
+  virtual std::unique_ptr<EventCutBase> Clone(TTreeReader &reader) const = 0;
 };
 
 /**
@@ -61,6 +63,19 @@ class EventCut : public EventCutBase {
     return CheckImpl(std::make_index_sequence<sizeof...(T)>{});
   }
 
+  /**
+   * Creates a copy of the cut which reads the variables using a different TTreeReader.
+   * @param reader reader of the copy
+   * @return Returns the copy of the cut
+   */
+  std::unique_ptr<EventCutBase> Clone(TTreeReader &reader) const override {
+    VAR arr[sizeof...(T)];
+    for (unsigned int i = 0; i < variables_.size(); ++i) {
+      arr[i] = std::make_unique<typename VAR::element_type>(reader, variables_[i]->GetBranchName());
+    }
+    return std::make_unique<EventCut<VAR, T...>>(arr, lambda_);
+  }
+
   std::string Name() override {
     std::string name;
     for  (unsigned int i = 0; i <  variables_.size(); ++i) {
@@ -120,6 +135,29 @@ std::unique_ptr<EventCutBase> MakeUniqueEventCut(VAR (&arr)[N], FUNC &&func) {
 
 class EventCuts {
  public:
+  EventCuts() = default;
+
+  /**
+   * Copies the cuts, reading the variables with a different TTreeReader.
+   * The cut report of the copy is detached from the current directory.
+   * @param other cuts to be copied
+   * @param reader reader used by the copy
+   */
+  EventCuts(const EventCuts &other, TTreeReader &reader) {
+    for (const auto &cut : other.cuts_) {
+      cuts_.push_back(cut->Clone(reader));
+    }
+    if (other.cut_report_) {
+      cut_report_ = static_cast<TH1D *>(other.cut_report_->Clone());
+      cut_report_->SetDirectory(nullptr);
+      cut_report_->Reset();
+      owns_report_ = true;
+    }
+  }
+
+  ~EventCuts() {
+    if (owns_report_) delete cut_report_;
+  }
 
   void AddCut(std::unique_ptr<EventCutBase> cut) {
     cuts_.push_back(std::move(cut));
@@ -150,9 +188,18 @@ class EventCuts {
     return cut_report_;
   }
 
+  /**
+   * Adds the cut report of other cuts to this cut report.
+   * @param other cuts with the same configuration
+   */
+  void MergeReport(const EventCuts &other) {
+    cut_report_->Add(other.cut_report_);
+  }
+
  private:
   std::vector<std::unique_ptr<EventCutBase>> cuts_;
-  TH1D *cut_report_;
+  TH1D *cut_report_ = nullptr;
+  bool owns_report_ = false;
 };
 
 }
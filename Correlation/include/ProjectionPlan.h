@@ -0,0 +1,62 @@
+// Flow Vector Correction Framework
+//
+// Copyright (C) 2018  Lukas Kreis, Ilya Selyuzhenkov
+// Contact: l.kreis@gsi.de; ilya.selyuzhenkov@gmail.com
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLOW_PROJECTIONPLAN_H
+#define FLOW_PROJECTIONPLAN_H
+
+#include <string>
+#include <vector>
+
+#include "DataContainer.h"
+
+namespace Qn {
+/**
+ * @class ProjectionPlan
+ * @brief Repeats the projection of a Q-vector DataContainer on a subset of its axes.
+ * The mapping of the input bins to the bins of the projection is calculated once from a container with the binning
+ * of the input. Each event the input bins are added into a preallocated projection in place, which gives the same
+ * result as DataContainer::Projection with the CorrelationManager projection function.
+ * The normalization of the sum follows the normalization of the added Q-vectors, as in the projection.
+ */
+class ProjectionPlan {
+ public:
+  ProjectionPlan() = default;
+  ProjectionPlan(const DataContainerQVector &input, const std::vector<std::string> &axes);
+
+  /**
+   * @brief Checks if the plan can be used for the given containers.
+   * @param input container to be projected.
+   * @param output projection of a previous event.
+   * @return true if the binning of the containers matches the one of the plan.
+   */
+  bool IsApplicable(const DataContainerQVector &input, const DataContainerQVector &output) const {
+    return input.size()==map_.size() && output.size()==output_size_;
+  }
+
+  void Fill(const DataContainerQVector &input, DataContainerQVector &output) const;
+
+ private:
+  static void Reset(QVector &sum);
+  static void Add(QVector &sum, const QVector &qvector);
+
+  std::vector<std::size_t> map_; ///< bin in the projection of each input bin.
+  std::size_t output_size_ = 0; ///< number of bins of the projection.
+  bool integrated_ = false; ///< true if the input is integrated over all axes.
+};
+}
+
+#endif //FLOW_PROJECTIONPLAN_H
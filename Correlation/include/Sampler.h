@@ -30,6 +30,7 @@ class Sampler {
     NONE,
     BOOTSTRAP,
     SUBSAMPLING,
+    POISSONBOOTSTRAP,
   };
 
   enum class Resample {
@@ -58,12 +59,12 @@ class Sampler {
       method_(method),
       n_events_(n_events),
       n_samples_(nsamples),
-      samples_(n_events) {
+      samples_(method==Method::POISSONBOOTSTRAP ? 0 : n_events) {
   }
 
   void SetNumberOfEvents(size_type num) {
     n_events_ = num;
-    samples_.resize(num);
+    if (method_!=Method::POISSONBOOTSTRAP) samples_.resize(num);
   }
 
   void CreateSamples() {
@@ -82,6 +83,31 @@ class Sampler {
 
   void CreateResamples();
 
+  /**
+   * @brief Computes the samples of an event for the Poisson bootstrap.
+   * The multiplicity of the event in each sample is drawn from a Poisson distribution with mean one.
+   * The random numbers are generated with a counter-based generator (Philox4x32-10) from the seed and the event id.
+   * The result does not depend on the order or the number of calls, nor on the total number of events.
+   * @param ievent event id
+   * @param samples vector of sample ids. Each sample id is repeated according to its multiplicity.
+   */
+  void CreatePoissonSamples(size_type ievent, std::vector<size_type> &samples) const;
+
+  /**
+   * @brief Returns the samples of an event.
+   * For the Poisson bootstrap they are computed into the caller-owned buffer, which is returned.
+   * Otherwise the stored samples of the event are returned and the buffer is left untouched.
+   * @param ievent event id
+   * @param buffer storage of the samples owned by the caller
+   * @return samples of the event
+   */
+  inline const std::vector<size_type> &GetFillVector(size_type ievent, std::vector<size_type> &buffer) const {
+    if (method_==Method::POISSONBOOTSTRAP) {
+      CreatePoissonSamples(ievent, buffer);
+      return buffer;
+    }
+    return samples_[ievent];
+  }
   inline const std::vector<size_type> &GetFillVector(size_type ievent) const { return samples_[ievent]; }
   inline void GetFillVector(std::vector<size_type> &vector) { vector = samples_[ievent_]; }
   inline void UpdateEvent() { ievent_++; }
@@ -95,6 +121,7 @@ class Sampler {
     std::string method;
     if (method_==Method::BOOTSTRAP) method="bootstrap";
     if (method_==Method::SUBSAMPLING) method="subsampling";
+    if (method_==Method::POISSONBOOTSTRAP) method="poisson bootstrap";
     return  std::string("----------------------\n") +
             std::string("Resampling parameters:\n") +
                         "number of events  " + std::to_string(n_events_)+"\n"
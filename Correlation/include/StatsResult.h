@@ -22,6 +22,7 @@
 #include <exception>
 
 #include "DataContainer.h"
+#include "StatsAccumulator.h"
 #include "Sampler.h"
 #include "Correlation.h"
 
@@ -51,7 +52,7 @@ class StatsResult {
    * @brief Returns the result of the correlation.
    * @return Average over all events.
    */
-  DataContainerStats GetResult() const { return result_; }
+  DataContainerStats GetResult() const { return result_.GetDataContainer(); }
 
   /**
    * @brief Fill Correlation container with specified inputs.
@@ -61,11 +62,19 @@ class StatsResult {
    */
   void Fill(size_type event_id);
 
+  /**
+   * @brief Fill the result with previously stored per-event correlation results.
+   * @param products iterator to the first bin of the stored event result.
+   * @param event_id id of the event used for resampling.
+   */
+  void Fill(std::vector<Qn::Product>::const_iterator products, size_type event_id);
+
  private:
   bool use_resampling_ = false; ///< resampling flag
   Correlation *correlation_current_event = nullptr; ///< Pointer to the correlation result of the current event.
   Qn::Sampler *resampler_ = nullptr; ///< Pointer to the central Resampler. CorrelationManager manages lifetime.
-  DataContainerStats result_; ///< Averaged result of the correlation over all events
+  StatsAccumulator result_; ///< Averaged result of the correlation over all events
+  std::vector<size_type> samples_; ///< Samples of the current event if they are not stored by the Resampler.
 };
 
 struct NoResamplerException : public std::exception {
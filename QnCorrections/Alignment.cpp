@@ -216,6 +216,9 @@ Bool_t Alignment::CreateNveQAHistograms(TList *list) {
 /// Apply the correction step
 /// \return kTRUE if the correction step was applied
 Bool_t Alignment::ProcessCorrections(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   switch (fState) {
     case QCORRSTEP_calibration:
       /* collect the data needed to further produce correction parameters if both current Qn vectors are good enough */
@@ -235,7 +238,7 @@ Bool_t Alignment::ProcessCorrections(const double *variableContainer) {
         fCorrectedQnVector->Set(fDetectorConfiguration->GetCurrentQnVector(), kFALSE);
 
         /* let's check the correction histograms */
-        Long64_t bin = fInputHistograms->GetBin(variableContainer);
+        Long64_t bin = fInputHistograms->GetBin(eventClassBin);
         if (fInputHistograms->BinContentValidated(bin)) {
           /* the bin content is validated so, apply the correction */
           Double_t XX = fInputHistograms->GetXXBinContent(bin);
@@ -266,7 +269,7 @@ Bool_t Alignment::ProcessCorrections(const double *variableContainer) {
           } /* if the correction is not significant we leave the Q vector untouched */
         } /* if the correction bin is not validated we leave the Q vector untouched */
         else {
-          if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(variableContainer, 1.0);
+          if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(eventClassBin, 1.0);
         }
       } else {
         /* not done! input Q vector with bad quality */
@@ -288,6 +291,9 @@ Bool_t Alignment::ProcessCorrections(const double *variableContainer) {
 /// Collect data for the correction step.
 /// \return kTRUE if the correction step was applied
 Bool_t Alignment::ProcessDataCollection(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   switch (fState) {
     case QCORRSTEP_calibration:
       /* logging */
@@ -297,19 +303,19 @@ Bool_t Alignment::ProcessDataCollection(const double *variableContainer) {
       /* collect the data needed to further produce correction parameters if both current Qn vectors are good enough */
       if ((fInputQnVector->IsGoodQuality()) &&
           (fDetectorConfigurationForAlignment->GetCurrentQnVector()->IsGoodQuality())) {
-        fCalibrationHistograms->FillXX(variableContainer,
+        fCalibrationHistograms->FillXX(eventClassBin,
                                        fInputQnVector->Qx(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qx(
                                                fHarmonicForAlignment));
-        fCalibrationHistograms->FillXY(variableContainer,
+        fCalibrationHistograms->FillXY(eventClassBin,
                                        fInputQnVector->Qx(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qy(
                                                fHarmonicForAlignment));
-        fCalibrationHistograms->FillYX(variableContainer,
+        fCalibrationHistograms->FillYX(eventClassBin,
                                        fInputQnVector->Qy(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qx(
                                                fHarmonicForAlignment));
-        fCalibrationHistograms->FillYY(variableContainer,
+        fCalibrationHistograms->FillYY(eventClassBin,
                                        fInputQnVector->Qy(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qy(
                                                fHarmonicForAlignment));
@@ -325,19 +331,19 @@ Bool_t Alignment::ProcessDataCollection(const double *variableContainer) {
       /* collect the data needed to further produce correction parameters if both current Qn vectors are good enough */
       if ((fInputQnVector->IsGoodQuality()) &&
           (fDetectorConfigurationForAlignment->GetCurrentQnVector()->IsGoodQuality())) {
-        fCalibrationHistograms->FillXX(variableContainer,
+        fCalibrationHistograms->FillXX(eventClassBin,
                                        fInputQnVector->Qx(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qx(
                                                fHarmonicForAlignment));
-        fCalibrationHistograms->FillXY(variableContainer,
+        fCalibrationHistograms->FillXY(eventClassBin,
                                        fInputQnVector->Qx(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qy(
                                                fHarmonicForAlignment));
-        fCalibrationHistograms->FillYX(variableContainer,
+        fCalibrationHistograms->FillYX(eventClassBin,
                                        fInputQnVector->Qy(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qx(
                                                fHarmonicForAlignment));
-        fCalibrationHistograms->FillYY(variableContainer,
+        fCalibrationHistograms->FillYY(eventClassBin,
                                        fInputQnVector->Qy(fHarmonicForAlignment)
                                            *fDetectorConfigurationForAlignment->GetCurrentQnVector()->Qy(
                                                fHarmonicForAlignment));
@@ -349,8 +355,8 @@ Bool_t Alignment::ProcessDataCollection(const double *variableContainer) {
       if (fQAQnAverageHistogram!=NULL) {
         Int_t harmonic = fCorrectedQnVector->GetFirstHarmonic();
         while (harmonic!=-1) {
-          fQAQnAverageHistogram->FillX(harmonic, variableContainer, fCorrectedQnVector->Qx(harmonic));
-          fQAQnAverageHistogram->FillY(harmonic, variableContainer, fCorrectedQnVector->Qy(harmonic));
+          fQAQnAverageHistogram->FillX(harmonic, eventClassBin, fCorrectedQnVector->Qx(harmonic));
+          fQAQnAverageHistogram->FillY(harmonic, eventClassBin, fCorrectedQnVector->Qy(harmonic));
           harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
         }
       }
@@ -419,4 +425,42 @@ Bool_t Alignment::ReportUsage(TList *calibrationList, TList *applyList) {
   }
   return kTRUE;
 }
+
+/// Transfers the pending fills of the correction step histograms
+///
+/// The request is transmitted to the calibration and QA histograms
+/// that the correction step fills
+void Alignment::FlushHistogramFills() {
+  if (fCalibrationHistograms!=NULL)
+    fCalibrationHistograms->FlushFills();
+  if (fQAQnAverageHistogram!=NULL)
+    fQAQnAverageHistogram->FlushFills();
+}
+
+/// Exports the attached input calibration information as calibration snapshots
+///
+/// The request is transmitted to the input histograms
+/// \param list list where the snapshots should be incorporated
+void Alignment::ExportCalibrationSnapshot(TList *list) {
+  if (fInputHistograms!=NULL)
+    fInputHistograms->ExportSnapshot(list);
+}
+
+/// Prepares calibration snapshots from the passed input calibration information
+///
+/// Scratch input histograms, equal to the ones of the correction step,
+/// are attached to the passed list and exported
+/// \param source list where the input calibration information should be found
+/// \param list list where the snapshots should be incorporated
+void Alignment::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  if (fInputHistograms==NULL)
+    return;
+
+  CorrectionProfileCorrelationComponents inputHistograms(fInputHistograms->GetName(),
+                                                         fInputHistograms->GetTitle(),
+                                                         fDetectorConfiguration->GetEventClassVariablesSet());
+  inputHistograms.SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+  if (inputHistograms.AttachHistograms(source))
+    inputHistograms.ExportSnapshot(list);
+}
 }
@@ -35,6 +35,7 @@
 #include <TList.h>
 #include <TKey.h>
 #include "CorrectionCalculator.h"
+#include "CorrectionCalibrationCache.h"
 #include "CorrectionLog.h"
 
 #include <iostream>
@@ -60,12 +61,13 @@ const char *CorrectionCalculator::szAllProcessesListName = "all data";
 /// Default constructor.
 /// The class owns the detectors and will be destroyed with it
 CorrectionCalculator::CorrectionCalculator() :
-    TObject(), fDetectorsSet(), fProcessListName(szDummyProcessListName) {
+    TObject(), fDetectorsSet(), fEventClassVariablesSets(), fProcessListName(szDummyProcessListName) {
 
   fDetectorsSet.SetOwner(kTRUE);
   fDetectorsIdMap = NULL;
   fDataContainer = NULL;
   fCalibrationHistogramsList = NULL;
+  fCalibrationCache = NULL;
   fSupportHistogramsList = NULL;
   fQAHistogramsList = NULL;
   fNveQAHistogramsList = NULL;
@@ -84,6 +86,8 @@ CorrectionCalculator::~CorrectionCalculator() {
 
   if (fDetectorsIdMap!=NULL) delete[] fDetectorsIdMap;
   if (fDataContainer!=NULL) delete[] fDataContainer;
+  /* the cached calibrations go first, a background preparation could be reading the calibration histograms */
+  if (fCalibrationCache!=NULL) delete fCalibrationCache;
   if (fCalibrationHistogramsList!=NULL) delete fCalibrationHistogramsList;
   if (fProcessesNames!=NULL) delete fProcessesNames;
 }
@@ -97,6 +101,8 @@ void CorrectionCalculator::SetCalibrationHistogramsList(TFile *calibrationFile)
       if (fCalibrationHistogramsList!=NULL) {
         QnCorrectionsInfo("Changed the calibration file. Deleting the current calibration histograms list");
         /* we delete it. WARNING: at this point the whole framework got orphan of input histograms this MUST be a transient situation */
+        /* the cached calibrations were prepared from it so they go as well */
+        if (fCalibrationCache!=NULL) fCalibrationCache->Clear();
         delete fCalibrationHistogramsList;
         fCalibrationHistogramsList = NULL;
       }
@@ -262,6 +268,11 @@ void CorrectionCalculator::InitializeQnCorrectionsFramework() {
     fDetectorsIdMap[detector->GetId()] = detector;
   }
 
+  /* collect the event class variables sets the event has to be located in */
+  fEventClassVariablesSets.Clear();
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->FillEventClassVariablesSetList(&fEventClassVariablesSets);
+  }
 
   /* create the support data structures */
   for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
@@ -326,21 +337,7 @@ void CorrectionCalculator::InitializeQnCorrectionsFramework() {
 
   /* now get the process list on the calibration histograms list if any */
   /* and pass it to the detectors for input calibration histograms attachment, */
-  if (fCalibrationHistogramsList!=NULL) {
-    TList *processList = (TList *) fCalibrationHistogramsList->FindObject((const char *) fProcessListName);
-    if (processList!=NULL) {
-      QnCorrectionsInfo(Form("Assigned process list %s as the calibration histograms list",
-                             processList->GetName()));
-      /* now transfer the order to the defined detectors */
-      for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-        ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AttachCorrectionInputs(processList);
-      }
-      /* now inform to the defined detectors the framework conditions are complete */
-      for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-        ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AfterInputsAttachActions();
-      }
-    }
-  }
+  AttachProcessCalibration();
 
   /* now build the QA histograms list if needed */
   /* QA histograms are no longer stored on a per run basis */
@@ -422,21 +419,7 @@ void CorrectionCalculator::SetCurrentProcessListName(const char *name) {
       /* now get the process list on the calibration histograms list if any */
       /* and pass it to the detectors for input calibration histograms attachment, */
       fProcessListName = name;
-      if (fCalibrationHistogramsList!=NULL) {
-        TList *processList = (TList *) fCalibrationHistogramsList->FindObject((const char *) fProcessListName);
-        if (processList!=NULL) {
-          QnCorrectionsInfo(Form("Assigned process list %s as the calibration histograms list",
-                                 processList->GetName()));
-          /* now transfer the order to the defined detectors */
-          for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-            ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AttachCorrectionInputs(processList);
-          }
-          /* now inform to the defined detectors the framework conditions are complete */
-          for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-            ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AfterInputsAttachActions();
-          }
-        }
-      }
+      AttachProcessCalibration();
       /* build the Qn vectors list  now that all histograms are loaded */
       if (fQnVectorList==NULL) {
         /* first we build it if it isn't already there */
@@ -456,6 +439,9 @@ void CorrectionCalculator::SetCurrentProcessListName(const char *name) {
   } else {
     QnCorrectionsInfo(Form("Changing process on the fly from %s to %s", fProcessListName.Data(), name));
 
+    /* the pending fills belong to the previous process, transfer them before the histograms are recreated */
+    FlushHistogramFills();
+
     if (fSupportHistogramsList!=NULL) {
       /* check the list of concurrent processes */
       if (fProcessesNames!=NULL && fProcessesNames->GetEntries()!=0) {
@@ -489,21 +475,7 @@ void CorrectionCalculator::SetCurrentProcessListName(const char *name) {
       /* now get the process list on the calibration histograms list if any */
       /* and pass it to the detectors for input calibration histograms attachment, */
       fProcessListName = name;
-      if (fCalibrationHistogramsList!=NULL) {
-        TList *processList = (TList *) fCalibrationHistogramsList->FindObject((const char *) fProcessListName);
-        if (processList!=NULL) {
-          QnCorrectionsInfo(Form("Assigned process list %s as the calibration histograms list",
-                                 processList->GetName()));
-          /* now transfer the order to the defined detectors */
-          for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-            ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AttachCorrectionInputs(processList);
-          }
-          /* now inform to the defined detectors the framework conditions are complete */
-          for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-            ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AfterInputsAttachActions();
-          }
-        }
-      }
+      AttachProcessCalibration();
       /* build the Qn vectors list  now that all histograms are loaded */
       if (fQnVectorList==NULL) {
         /* first we build it if it isn't already there */
@@ -526,6 +498,135 @@ void CorrectionCalculator::SetCurrentProcessListName(const char *name) {
   PrintFrameworkConfiguration();
 }
 
+/// Sets the number of per process calibrations kept prepared for attachment
+///
+/// When processes, i.e. runs, are interleaved the calibration of each of them
+/// has to be attached again every time the process changes. With a non zero
+/// size, the input calibration of the processes is kept as calibration snapshots
+/// in a least recently used cache so switching back to a cached process only
+/// requires the attachment of the snapshots. A zero size disables the cache.
+/// \param nProcesses the maximum number of process calibrations kept
+void CorrectionCalculator::SetCalibrationCacheSize(Int_t nProcesses) {
+  if (nProcesses < 0) {
+    QnCorrectionsFatal(Form("Wrong calibration cache size: %d. FIX IT, PLEASE", nProcesses));
+    return;
+  }
+  if (nProcesses==0) {
+    if (fCalibrationCache!=NULL) {
+      /* the framework could be attached to a cached calibration, reattach it to the histograms */
+      delete fCalibrationCache;
+      fCalibrationCache = NULL;
+      if (fSupportHistogramsList!=NULL)
+        AttachProcessCalibration();
+    }
+  } else {
+    if (fCalibrationCache==NULL)
+      fCalibrationCache = new CorrectionCalibrationCache(nProcesses);
+    else
+      fCalibrationCache->SetCapacity(nProcesses);
+  }
+}
+
+/// Gets the number of per process calibrations kept prepared for attachment
+/// \return the calibration cache size, zero if disabled
+Int_t CorrectionCalculator::GetCalibrationCacheSize() const {
+  return (fCalibrationCache!=NULL) ? fCalibrationCache->GetCapacity() : 0;
+}
+
+/// Announces the process that will follow the current one
+///
+/// If the calibration cache is enabled and the calibration of the announced
+/// process is neither cached nor the current one, its calibration snapshots
+/// are prepared on a background thread while the current process continues.
+/// The correction steps are not involved in the preparation, they will attach
+/// the prepared snapshots once the process is changed. A change to the
+/// announced process before the preparation finished waits for it.
+///
+/// Only one process is prepared in background at a time, a new announcement
+/// waits for the previous preparation to finish.
+/// \param name the name of the next process
+void CorrectionCalculator::PrefetchProcessCalibration(const char *name) {
+  if (fCalibrationCache==NULL || fCalibrationHistogramsList==NULL || fSupportHistogramsList==NULL)
+    return;
+  if (fProcessListName.EqualTo(name))
+    return;
+
+  TList *processList = (TList *) fCalibrationHistogramsList->FindObject(name);
+  if (processList!=NULL) {
+    QnCorrectionsInfo(Form("Preparing the calibration of process %s in background", name));
+    fCalibrationCache->Prefetch(name, [this, processList]() {
+      return PrepareCalibrationSnapshot(processList);
+    });
+  }
+}
+
+/// Attaches the input calibration of the current process to the detectors
+///
+/// If the calibration cache is enabled and holds the current process calibration
+/// the detectors are attached to its snapshots. Otherwise the process list in the
+/// calibration histograms list, if any, is attached and, if the cache is enabled,
+/// the attached calibration is exported and incorporated to the cache.
+void CorrectionCalculator::AttachProcessCalibration() {
+  if (fCalibrationHistogramsList==NULL)
+    return;
+
+  TList *processList = NULL;
+  Bool_t bCached = kFALSE;
+  if (fCalibrationCache!=NULL) {
+    processList = fCalibrationCache->Acquire((const char *) fProcessListName);
+    bCached = (processList!=NULL);
+  }
+  if (processList==NULL)
+    processList = (TList *) fCalibrationHistogramsList->FindObject((const char *) fProcessListName);
+
+  if (processList!=NULL) {
+    QnCorrectionsInfo(Form("Assigned process list %s as the calibration histograms list%s",
+                           processList->GetName(),
+                           bCached ? " from the calibration cache" : ""));
+    /* now transfer the order to the defined detectors */
+    for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+      ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AttachCorrectionInputs(processList);
+    }
+    /* now inform to the defined detectors the framework conditions are complete */
+    for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+      ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->AfterInputsAttachActions();
+    }
+    /* keep the just attached calibration for a later return to this process */
+    if (fCalibrationCache!=NULL && !bCached)
+      fCalibrationCache->Insert(ExportProcessCalibrationSnapshot());
+  }
+}
+
+/// Prepares the calibration snapshots of a process from its calibration histograms
+///
+/// Neither the detectors state nor the calculator state is modified so
+/// it can run concurrently with the event processing.
+/// \param processList the process list within the calibration histograms list
+/// \return the process calibration snapshots list, named as the process
+TList *CorrectionCalculator::PrepareCalibrationSnapshot(TList *processList) const {
+  TList *snapshotList = new TList();
+  snapshotList->SetName(processList->GetName());
+  snapshotList->SetOwner(kTRUE);
+
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->PrepareCalibrationSnapshot(processList, snapshotList);
+  }
+  return snapshotList;
+}
+
+/// Exports the attached input calibration of the current process as calibration snapshots
+/// \return the process calibration snapshots list, named as the process
+TList *CorrectionCalculator::ExportProcessCalibrationSnapshot() {
+  TList *processList = new TList();
+  processList->SetName((const char *) fProcessListName);
+  processList->SetOwner(kTRUE);
+
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->ExportCalibrationSnapshot(processList);
+  }
+  return processList;
+}
+
 /// Produce an understandable picture of current correction configuration
 void CorrectionCalculator::PrintFrameworkConfiguration() const {
   QnCorrectionsInfo("");
@@ -777,10 +878,47 @@ void CorrectionCalculator::PrintFrameworkConfiguration() const {
   delete detectorApplyingCorrectionsList;
 }
 
+/// Transfers the pending fills to the framework histograms
+///
+/// The profile histograms keep their fills in a dense storage
+/// which is only transferred to the histograms on request. This
+/// has to happen before the histograms are used or persisted.
+/// The request is transmitted to the defined detectors
+void CorrectionCalculator::FlushHistogramFills() {
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->FlushHistogramFills();
+  }
+}
+
+/// Exports the attached input calibration as a compact calibration snapshot
+///
+/// The calibration histograms attached at initialization are converted
+/// into flat per bin calibration parameters, one snapshot per input
+/// profile. The snapshots are organized in the same list structure the
+/// calibration histograms have, under the current process list name, and
+/// the whole list is named as the calibration histograms key. Once written
+/// with that key, the file can be passed as calibration file to any later
+/// framework initialization with the same configuration, and the input
+/// profiles will attach to the snapshots instead of rebuilding their
+/// histograms.
+///
+/// The export is only meaningful once the framework has been initialized.
+/// \return the calibration snapshot list, owned by the caller
+TList *CorrectionCalculator::ExportCalibrationSnapshot() {
+  TList *snapshotList = new TList();
+  snapshotList->SetName(szCalibrationHistogramsKeyName);
+  snapshotList->SetOwner(kTRUE);
+
+  snapshotList->Add(ExportProcessCalibrationSnapshot());
+  return snapshotList;
+}
+
 /// Produce the final output and release the framework.
-/// Produce the all data lists that collect data from all concurrent processes.
+/// Transfers the pending fills to the histograms and produce the
+/// all data lists that collect data from all concurrent processes.
 void CorrectionCalculator::FinalizeQnCorrectionsFramework() {
 
+  FlushHistogramFills();
   TList *processList = (TList *) fSupportHistogramsList->FindObject((const char *) fProcessListName);
   fSupportHistogramsList->Add(processList->Clone(szAllProcessesListName));
 }
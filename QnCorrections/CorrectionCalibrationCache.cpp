@@ -0,0 +1,176 @@
+/// \file CorrectionCalibrationCache.cxx
+/// \brief Implementation of the bounded cache of prepared per process calibration
+
+#include <TList.h>
+#include <TROOT.h>
+#include <TString.h>
+
+#include "CorrectionCalibrationCache.h"
+#include "CorrectionLog.h"
+
+namespace Qn {
+/// Normal constructor
+/// \param capacity the maximum number of entries the cache keeps, at least one
+CorrectionCalibrationCache::CorrectionCalibrationCache(Int_t capacity) :
+    fCapacity(capacity),
+    fEntries(),
+    fInUse(),
+    fPrefetchName(),
+    fPrefetchThread(),
+    fMutex() {
+  if (capacity < 1) {
+    QnCorrectionsFatal(Form("Wrong calibration cache capacity: %d. It should be at least one. FIX IT, PLEASE",
+                            capacity));
+  }
+}
+
+/// Default destructor
+///
+/// Waits for any background preparation and deletes the cached entries
+CorrectionCalibrationCache::~CorrectionCalibrationCache() {
+  Clear();
+}
+
+/// Changes the maximum number of entries the cache keeps
+///
+/// Least recently used entries beyond the new capacity are evicted
+/// \param capacity the new capacity, at least one
+void CorrectionCalibrationCache::SetCapacity(Int_t capacity) {
+  if (capacity < 1) {
+    QnCorrectionsFatal(Form("Wrong calibration cache capacity: %d. It should be at least one. FIX IT, PLEASE",
+                            capacity));
+    return;
+  }
+  std::lock_guard<std::mutex> lock(fMutex);
+  fCapacity = capacity;
+  Evict();
+}
+
+/// Gets the number of entries currently cached
+/// \return the number of entries
+Int_t CorrectionCalibrationCache::GetNoOfEntries() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  return Int_t(fEntries.size());
+}
+
+/// Gets the calibration of the passed process and marks it as in use
+///
+/// If the calibration of the process is being prepared in background
+/// waits for the preparation to finish. The process is marked as in use
+/// even if it is not cached, so a later insertion of its calibration
+/// is protected from eviction as well.
+/// \param name the process name
+/// \return the cached calibration list, NULL if not cached
+TList *CorrectionCalibrationCache::Acquire(const char *name) {
+  if (fPrefetchName==name)
+    WaitForPrefetch();
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  fInUse = name;
+  for (auto entry = fEntries.begin(); entry!=fEntries.end(); ++entry) {
+    if (fInUse==(*entry)->GetName()) {
+      TList *calibration = *entry;
+      /* move it to the most recently used position */
+      fEntries.splice(fEntries.begin(), fEntries, entry);
+      return calibration;
+    }
+  }
+  return NULL;
+}
+
+/// Checks whether the calibration of the passed process is cached
+/// or being prepared in background
+/// \param name the process name
+/// \return kTRUE if the process calibration is or will be cached
+Bool_t CorrectionCalibrationCache::Contains(const char *name) {
+  if (fPrefetchName==name)
+    return kTRUE;
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (TList *entry : fEntries) {
+    if (TString(entry->GetName()).EqualTo(name))
+      return kTRUE;
+  }
+  return kFALSE;
+}
+
+/// Incorporates a new calibration as the most recently used entry
+///
+/// The cache takes the ownership of the passed list. If the process
+/// is already cached the passed list is discarded.
+/// \param calibration the calibration list, named after its process
+void CorrectionCalibrationCache::Insert(TList *calibration) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (TList *entry : fEntries) {
+    if (TString(entry->GetName()).EqualTo(calibration->GetName())) {
+      delete calibration;
+      return;
+    }
+  }
+  fEntries.push_front(calibration);
+  Evict();
+}
+
+/// Starts the preparation of the calibration of the passed process on a background thread
+///
+/// Nothing is done if the process is already cached. Otherwise, any
+/// previous background preparation is waited for and the passed preparation
+/// function is run on a new thread. The list it returns, if any, is
+/// incorporated to the cache.
+///
+/// As ROOT objects are created on the background thread, ROOT thread
+/// safety is enabled.
+/// \param name the process name
+/// \param prepare the function that builds the process calibration list
+void CorrectionCalibrationCache::Prefetch(const char *name, std::function<TList *()> prepare) {
+  if (Contains(name))
+    return;
+
+  WaitForPrefetch();
+  ROOT::EnableThreadSafety();
+  fPrefetchName = name;
+  fPrefetchThread = std::thread([this, prepare]() {
+    TList *calibration = prepare();
+    if (calibration!=NULL)
+      Insert(calibration);
+  });
+}
+
+/// Deletes all the cached entries
+///
+/// Any background preparation is waited for beforehand
+void CorrectionCalibrationCache::Clear() {
+  WaitForPrefetch();
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (TList *entry : fEntries) {
+    delete entry;
+  }
+  fEntries.clear();
+  fInUse.clear();
+}
+
+/// Waits for the background preparation, if any, to finish
+void CorrectionCalibrationCache::WaitForPrefetch() {
+  if (fPrefetchThread.joinable())
+    fPrefetchThread.join();
+  fPrefetchName.clear();
+}
+
+/// Evicts least recently used entries until the capacity is honored
+///
+/// The entry in use is never evicted. Must be called with the mutex locked.
+void CorrectionCalibrationCache::Evict() {
+  while (Int_t(fEntries.size()) > fCapacity) {
+    auto victim = fEntries.end();
+    for (auto entry = fEntries.begin(); entry!=fEntries.end(); ++entry) {
+      if (fInUse!=(*entry)->GetName())
+        victim = entry;
+    }
+    if (victim==fEntries.end())
+      break;
+    delete *victim;
+    fEntries.erase(victim);
+  }
+}
+}
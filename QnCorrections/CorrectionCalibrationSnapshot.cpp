@@ -0,0 +1,95 @@
+/// \file CorrectionCalibrationSnapshot.cxx
+/// \brief Implementation of the compact read only calibration parameters
+
+#include <vector>
+
+#include "THnBase.h"
+#include "TMath.h"
+
+#include "CorrectionCalibrationSnapshot.h"
+
+/// \cond CLASSIMP
+ClassImp(Qn::CorrectionCalibrationSnapshot);
+/// \endcond
+namespace Qn {
+/// Default constructor
+CorrectionCalibrationSnapshot::CorrectionCalibrationSnapshot() :
+    TNamed(),
+    fNoOfComponents(0),
+    fHarmonicMask(0x0000),
+    fStrides(),
+    fEntries(),
+    fValues(),
+    fSpreads() {
+
+}
+
+/// Normal constructor
+///
+/// Takes the binning from the passed histogram and allocates
+/// the storage for the passed number of components. The bin
+/// number stride of each axis is obtained from the histogram
+/// itself so the snapshot bin numbers match the histogram ones.
+///
+/// \param name the name of the snapshot
+/// \param title the title of the snapshot
+/// \param binning histogram with the binning of the calibration profile
+/// \param nNoOfComponents the number of components stored for each bin
+CorrectionCalibrationSnapshot::CorrectionCalibrationSnapshot(const char *name,
+                                                             const char *title,
+                                                             THnBase *binning,
+                                                             Int_t nNoOfComponents) :
+    TNamed(name, title),
+    fNoOfComponents(nNoOfComponents),
+    fHarmonicMask(0x0000),
+    fStrides(binning->GetNdimensions()),
+    fEntries(binning->GetNbins()),
+    fValues(binning->GetNbins()*nNoOfComponents),
+    fSpreads(binning->GetNbins()*nNoOfComponents) {
+
+  std::vector<Int_t> bins(binning->GetNdimensions(), 0);
+  Long64_t origin = binning->GetBin(bins.data());
+  for (Int_t axis = 0; axis < binning->GetNdimensions(); axis++) {
+    bins[axis] = 1;
+    fStrides[axis] = binning->GetBin(bins.data()) - origin;
+    bins[axis] = 0;
+  }
+}
+
+/// Default destructor
+CorrectionCalibrationSnapshot::~CorrectionCalibrationSnapshot() {
+
+}
+
+/// Stores the number of entries of each bin
+/// \param entries the entries histogram of the calibration profile
+void CorrectionCalibrationSnapshot::SetEntries(THnBase *entries) {
+  for (Long64_t bin = 0; bin < GetNoOfBins(); bin++) {
+    fEntries[bin] = Int_t(entries->GetBinContent(bin));
+  }
+}
+
+/// Stores the mean and the standard deviation of the bin values of a component
+///
+/// The values histogram holds, for each bin, the sum of the component
+/// values and the sum of their squares as its squared error. Bins without
+/// entries keep zero mean and zero spread.
+/// \param component the component index
+/// \param values the values histogram of the component
+/// \param entries the entries histogram of the calibration profile
+void CorrectionCalibrationSnapshot::SetComponent(Int_t component, THnBase *values, THnBase *entries) {
+  for (Long64_t bin = 0; bin < GetNoOfBins(); bin++) {
+    Int_t nEntries = Int_t(entries->GetBinContent(bin));
+    if (nEntries==0) {
+      SetBinComponent(bin, component, 0.0, 0.0);
+    } else {
+      Float_t sum = values->GetBinContent(bin);
+      Float_t sum2 = values->GetBinError2(bin);
+
+      Double_t average = sum/nEntries;
+      Double_t spread = TMath::Sqrt(TMath::Abs(sum2/nEntries - average*average));
+      SetBinComponent(bin, component, values->GetBinContent(bin)/Float_t(nEntries), spread);
+    }
+  }
+}
+}
@@ -211,6 +211,20 @@ void CorrectionDetector::FillDetectorConfigurationNameList(TList *list) const {
   }
 }
 
+/// Include the event class variables set of each detector configuration
+/// into the passed list
+///
+/// Sets shared by several configurations are only included once
+/// \param list the list where to incorporate the event class variables sets
+void CorrectionDetector::FillEventClassVariablesSetList(TList *list) const {
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    EventClassVariablesSet *set = &fConfigurations.At(ixConfiguration)->GetEventClassVariablesSet();
+    if (list->FindObject(set)==NULL) {
+      list->Add(set);
+    }
+  }
+}
+
 /// Include the name of the input correction steps on each detector
 /// configuration into the passed list
 ///
@@ -244,5 +258,36 @@ void CorrectionDetector::ReportOnCorrections(TList *steps, TList *calib, TList *
     fConfigurations.At(ixConfiguration)->ReportOnCorrections(steps, calib, apply);
   }
 }
+
+/// Transfers the pending fills of the histograms of each detector configuration
+///
+/// The request is transmitted to the attached detector configurations
+void CorrectionDetector::FlushHistogramFills() {
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->FlushHistogramFills();
+  }
 }
 
+/// Exports the attached input calibration information of each detector
+/// configuration as calibration snapshots
+///
+/// The request is transmitted to the attached detector configurations
+/// \param list list where the detector configuration snapshots lists should be incorporated
+void CorrectionDetector::ExportCalibrationSnapshot(TList *list) {
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->ExportCalibrationSnapshot(list);
+  }
+}
+
+/// Prepares calibration snapshots of each detector configuration from the passed
+/// input calibration information
+///
+/// The request is transmitted to the attached detector configurations
+/// \param source list where the detector configuration input calibration lists should be found
+/// \param list list where the detector configuration snapshots lists should be incorporated
+void CorrectionDetector::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->PrepareCalibrationSnapshot(source, list);
+  }
+}
+}
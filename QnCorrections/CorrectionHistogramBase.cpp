@@ -15,6 +15,7 @@ const char *CorrectionHistogramBase::szChannelAxisTitle = "Channel number";
 const char *CorrectionHistogramBase::szGroupAxisTitle = "Channels group";
 const char *CorrectionHistogramBase::szGroupHistoPrefix = "Group";
 const char *CorrectionHistogramBase::szEntriesHistoSuffix = "_entries";
+const char *CorrectionHistogramBase::szSnapshotSuffix = "_snapshot";
 const char *CorrectionHistogramBase::szXComponentSuffix = "X";
 const char *CorrectionHistogramBase::szYComponentSuffix = "Y";
 const char *CorrectionHistogramBase::szXXCorrelationComponentSuffix = "XX";
@@ -35,7 +36,9 @@ const Int_t CorrectionHistogramBase::nDefaultMinNoOfEntriesValidated = 2;
 CorrectionHistogramBase::CorrectionHistogramBase() :
     TNamed(),
     fEventClassVariables(),
-    fBinAxesValues(nullptr) {
+    fBinAxesValues(nullptr),
+    fBinAxesBins(nullptr),
+    fSnapshot(nullptr) {
 
   fErrorMode = kERRORMEAN;
   fMinNoOfEntriesToValidate = nDefaultMinNoOfEntriesValidated;
@@ -43,9 +46,10 @@ CorrectionHistogramBase::CorrectionHistogramBase() :
 
 /// Default destructor
 ///
-/// restores the taken memory for the bin axes values bank
+/// restores the taken memory for the bin axes values and bins banks
 CorrectionHistogramBase::~CorrectionHistogramBase() {
   delete[] fBinAxesValues;
+  delete[] fBinAxesBins;
 }
 
 /// Normal constructor
@@ -72,10 +76,13 @@ CorrectionHistogramBase::CorrectionHistogramBase(const char *name,
                                                        Option_t *option) :
     TNamed(name, title),
     fEventClassVariables(ecvs),
-    fBinAxesValues(nullptr) {
+    fBinAxesValues(nullptr),
+    fBinAxesBins(nullptr),
+    fSnapshot(nullptr) {
 
   /* one place more for storing the channel number by inherited classes */
   fBinAxesValues = new Double_t[fEventClassVariables.GetEntries() + 1];
+  fBinAxesBins = new Int_t[fEventClassVariables.GetEntries() + 1];
 
   TString opt = option;
   opt.ToLower();
@@ -160,6 +167,46 @@ Long64_t CorrectionHistogramBase::GetBin(const double *variableContainer, Int_t
   return -1;
 }
 
+/// Get the bin number for the current event class bin
+///
+/// The bin number identifies the event class the current
+/// event class bin points to.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionHistogramBase::GetBin(const Int_t *eventClassBin) {
+  (void) eventClassBin;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means you have instantiated a base class or\n" \
+      "you are using a channelized profile without passing the channel number. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::GetBin()"));
+  return -1;
+}
+
+/// Get the bin number for the current event class bin and channel number
+///
+/// The bin number identifies the event class the current
+/// event class bin points to and the passed channel
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionHistogramBase::GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+  (void) nChannel;
+  (void) eventClassBin;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means you have instantiated a base class or\n" \
+      "you are using a non channelized profile passing a channel number. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::GetBin()"));
+  return -1;
+}
+
 /// Get the bin content for the passed bin number
 ///
 /// The bin number identifies a desired event class whose content is
@@ -870,6 +917,192 @@ void CorrectionHistogramBase::FillYY(Int_t harmonic, const double *variableConta
                           "QnCorrectionsHistogramBase::FillYY()"));
 }
 
+/// Fills the histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::Fill(const Int_t *eventClassBin, Float_t weight) {
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   FillX or FillY, or FillXX ... FillYY or you have instantiated a base class or you are using\n" \
+      "a channelized profile without passing a channel number. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::Fill()"));
+}
+
+/// Fills the histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin and passed channel number. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight) {
+  (void) nChannel;
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   FillX or FillY, or FillXX ... FillYY or you have instantiated a base class or you are using\n" \
+      "a non channelized profile passing a channel number. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::Fill()"));
+}
+
+/// Fills the X component for the corresponding harmonic histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param harmonic the interested external harmonic number
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::FillX(Int_t harmonic, const Int_t *eventClassBin, Float_t weight) {
+  (void) harmonic;
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   Fill or FillXX ... FillYY or you have instantiated a base class. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::FillX()"));
+}
+
+/// Fills the Y component for the corresponding harmonic histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param harmonic the interested external harmonic number
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::FillY(Int_t harmonic, const Int_t *eventClassBin, Float_t weight) {
+  (void) harmonic;
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   Fill or FillXX ... FillYY or you have instantiated a base class. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::FillY()"));
+}
+
+/// Fills the XX component histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::FillXX(const Int_t *eventClassBin, Float_t weight) {
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   Fill, FillX, FillY or FillXX(harmonic), or you have instantiated a base class. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::FillXX()"));
+}
+
+/// Fills the XY component histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::FillXY(const Int_t *eventClassBin, Float_t weight) {
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   Fill, FillX, FillY or FillXY(harmonic), or you have instantiated a base class. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::FillXY()"));
+}
+
+/// Fills the YX component histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::FillYX(const Int_t *eventClassBin, Float_t weight) {
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   Fill, FillX, FillY or FillYX(harmonic), or you have instantiated a base class. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::FillYX()"));
+}
+
+/// Fills the YY component histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight and
+/// the entries also increased properly.
+///
+/// Interface declaration function.
+/// Default behavior. Base class should not be instantiated.
+/// Run time error to support debugging.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramBase::FillYY(const Int_t *eventClassBin, Float_t weight) {
+  (void) eventClassBin;
+  (void) weight;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means either you should have used\n" \
+      "   Fill, FillX, FillY or FillYY(harmonic), or you have instantiated a base class. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::FillYY()"));
+}
+
+/// Exports the attached calibration information as a calibration snapshot
+///
+/// The snapshot is added to the passed list.
+///
+/// Interface declaration function.
+/// Default behavior. Only the input profiles of the apply stage support snapshots.
+/// Run time error to support debugging.
+///
+/// \param list list where the snapshot should be incorporated
+/// \return kTRUE if the snapshot was exported
+Bool_t CorrectionHistogramBase::ExportSnapshot(TList *list) {
+  (void) list;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means you have instantiated a base class or\n" \
+      "   you are using a histogram class that does not support calibration snapshots. FIX IT, PLEASE.",
+                          "QnCorrectionsHistogramBase::ExportSnapshot()"));
+  return kFALSE;
+}
+
 /// Divide two THn histograms
 ///
 /// Creates a value / error multidimensional histogram from
@@ -973,4 +1206,51 @@ void CorrectionHistogramBase::CopyTHnFDimension(THnF *hDest, THnF *hSource, Int_
     hDest->SetBinError(binsArray, error);
   }
 }
+
+/// Attaches the calibration snapshot, if any, of the profile
+///
+/// The snapshot is located in the passed list by the profile name.
+/// The snapshot is owned by the list.
+/// \param histogramList list where the snapshot has to be located
+/// \return kTRUE if the snapshot was found
+Bool_t CorrectionHistogramBase::AttachSnapshot(TList *histogramList) {
+  fSnapshot =
+      (CorrectionCalibrationSnapshot *) histogramList->FindObject(Form("%s%s", GetName(), szSnapshotSuffix));
+  return (fSnapshot!=nullptr);
+}
+
+/// Get the calibration snapshot error of a component for the passed bin number
+///
+/// The bin content is supposed to be already validated.
+/// \param bin the interested bin number
+/// \param component the component index within the snapshot
+/// \return the bin content error according to the error mode
+Float_t CorrectionHistogramBase::GetSnapshotBinError(Long64_t bin, Int_t component) {
+  Int_t nEntries = fSnapshot->GetBinEntries(bin);
+  Float_t serror = fSnapshot->GetBinSpread(bin, component);
+
+  switch (fErrorMode) {
+    case kERRORMEAN:
+      /* standard error on the mean of the bin values */
+      return serror/TMath::Sqrt(nEntries);
+      break;
+    case kERRORSPREAD:
+      /* standard deviation of the bin values */
+      return serror;
+      break;
+    default:return 0.0;
+  }
+}
+
+/// Get the highest external harmonic number within a harmonics mask
+/// \param harmonicMask the harmonics mask
+/// \return the highest harmonic number, zero if none
+Int_t CorrectionHistogramBase::GetHighestHarmonic(UInt_t harmonicMask) {
+  Int_t nHighestHarmonic = 0;
+  for (Int_t harmonic = 1; harmonic <= nMaxHarmonicNumberSupported; harmonic++) {
+    if (harmonicMask & harmonicNumberMask[harmonic])
+      nHighestHarmonic = harmonic;
+  }
+  return nHighestHarmonic;
+}
 }
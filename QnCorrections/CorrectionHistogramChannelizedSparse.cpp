@@ -162,6 +162,22 @@ Long64_t CorrectionHistogramChannelizedSparse::GetBin(const double *variableCont
   return fValues->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin and passed channel
+///
+/// The bin number identifies the event class the current
+/// event class bin points to under the passed channel.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionHistogramChannelizedSparse::GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+
+  /* store also the channel bin */
+  FillBinAxesBins(eventClassBin,
+                  fValues->GetAxis(fEventClassVariables.GetEntriesFast())->FindFixBin(fChannelMap[nChannel]));
+  return fValues->GetBin(fBinAxesBins);
+}
+
 /// Check the validity of the content of the passed bin
 /// This kind of histograms cannot validate the bin content so, it
 /// is always valid.
@@ -214,5 +230,25 @@ void CorrectionHistogramChannelizedSparse::Fill(const double *variableContainer,
   fValues->Fill(fBinAxesValues, weight);
   fValues->SetEntries(nEntries + 1);
 }
+
+/// Fills the histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin and the passed external channel number. The bin is then
+/// increased by the given weight.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \param weight the increment in the bin content
+void CorrectionHistogramChannelizedSparse::Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight) {
+  /* keep the total entries in fValues updated */
+  Double_t nEntries = fValues->GetEntries();
+
+  FillBinAxesBins(eventClassBin,
+                  fValues->GetAxis(fEventClassVariables.GetEntriesFast())->FindFixBin(fChannelMap[nChannel]));
+  /* and now update the bin */
+  fValues->FillBin(fValues->GetBin(fBinAxesBins), weight);
+  fValues->SetEntries(nEntries + 1);
+}
 }
 
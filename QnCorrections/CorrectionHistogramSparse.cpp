@@ -98,6 +98,18 @@ Long64_t CorrectionHistogramSparse::GetBin(const double *variableContainer) {
   return fValues->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin
+///
+/// The bin number identifies the event class the current
+/// event class bin points to.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionHistogramSparse::GetBin(const Int_t *eventClassBin) {
+
+  return fValues->GetBin(eventClassBin);
+}
+
 /// Check the validity of the content of the passed bin
 /// This kind of histograms cannot validate the bin content so, it
 /// is always valid.
@@ -149,5 +161,21 @@ void CorrectionHistogramSparse::Fill(const double *variableContainer, Float_t we
   fValues->Fill(fBinAxesValues, weight);
   fValues->SetEntries(nEntries + 1);
 }
+
+/// Fills the histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionHistogramSparse::Fill(const Int_t *eventClassBin, Float_t weight) {
+  /* keep the total entries in fValues updated */
+  Double_t nEntries = fValues->GetEntries();
+
+  /* and now update the bin */
+  fValues->FillBin(fValues->GetBin(eventClassBin), weight);
+  fValues->SetEntries(nEntries + 1);
+}
 }
 
@@ -2,6 +2,8 @@
 /// \brief Implementation of the multidimensional correlation components based set of profiles
 /// for three Qn vectors with harmonic support
 
+#include <cstring>
+
 #include "TList.h"
 
 #include "EventClassVariablesSet.h"
@@ -17,6 +19,9 @@ namespace Qn {
 ///< the number of Qn supported
 #define CORRELATIONSNOOFQNVECTORS 3
 
+/// the names of the Qn vector correlation combinations in combination order
+static const char *szCombinationNames[CORRELATIONSNOOFQNVECTORS] = {"AB", "BC", "AC"};
+
 /// Default constructor
 CorrectionProfile3DCorrelations::CorrectionProfile3DCorrelations() :
     CorrectionHistogramBase(), fNameA(""), fNameB(""), fNameC("") {
@@ -27,6 +32,7 @@ CorrectionProfile3DCorrelations::CorrectionProfile3DCorrelations() :
   fYYValues = NULL;
   fEntries = NULL;
   fHarmonicMultiplier = 1;
+  fNoOfSlots = 0;
 }
 
 /// Normal constructor
@@ -62,6 +68,7 @@ CorrectionProfile3DCorrelations::CorrectionProfile3DCorrelations(const char *nam
   fYYValues = NULL;
   fEntries = NULL;
   fHarmonicMultiplier = 1;
+  fNoOfSlots = 0;
 }
 
 /// Default destructor
@@ -158,6 +165,7 @@ Bool_t CorrectionProfile3DCorrelations::CreateCorrelationComponentsProfileHistog
   } else {
     nNumberOfSlots += nNoOfHarmonics;
   }
+  fNoOfSlots = nNumberOfSlots;
 
   /* now allocate the slots for the values histograms for each Qn vector correlation combination */
   fXXValues = new THnF **[CORRELATIONSNOOFQNVECTORS];
@@ -308,6 +316,9 @@ Bool_t CorrectionProfile3DCorrelations::CreateCorrelationComponentsProfileHistog
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
 
+  /* the fill storage: the entries plus the four components for each combination and harmonic slot */
+  fAccumulator.Allocate(fEntries->GetNbins(), 1 + CORRELATIONSNOOFQNVECTORS*nNumberOfSlots*4);
+
   delete[] minvals;
   delete[] maxvals;
   delete[] nbins;
@@ -362,6 +373,18 @@ Bool_t CorrectionProfile3DCorrelations::AttachHistograms(TList *histogramList) {
     }
     delete[] fYYValues;
   }
+  fXXValues = NULL;
+  fXYValues = NULL;
+  fYXValues = NULL;
+  fYYValues = NULL;
+  fAccumulator.Release();
+  fNoOfSlots = 0;
+
+  /* a calibration snapshot takes precedence over the histograms */
+  if (AttachSnapshot(histogramList)) {
+    fNoOfSlots = (fSnapshot->GetNoOfComponents() - 1)/(4*CORRELATIONSNOOFQNVECTORS);
+    return (fSnapshot->GetHarmonicMask()!=0x0000);
+  }
 
   /* let's build the entries histogram name */
   TString entriesHistoName = GetName();
@@ -434,6 +457,9 @@ Bool_t CorrectionProfile3DCorrelations::AttachHistograms(TList *histogramList) {
     return kFALSE;
   }
 
+  /* the harmonic slots for each Qn vector combination */
+  fNoOfSlots = GetHighestHarmonic(harmonicFilledMask) + 1;
+
   /* check that we actually got something */
   if (harmonicFilledMask!=0x0000)
     return kTRUE;
@@ -449,10 +475,27 @@ Bool_t CorrectionProfile3DCorrelations::AttachHistograms(TList *histogramList) {
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t CorrectionProfile3DCorrelations::GetBin(const double *variableContainer) {
+  if (fSnapshot!=NULL) {
+    FillBinAxesBins(variableContainer);
+    return fSnapshot->GetBin(fBinAxesBins);
+  }
   FillBinAxesValues(variableContainer);
   return fEntries->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin
+///
+/// The bin number identifies the event class the current
+/// event class bin points to.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionProfile3DCorrelations::GetBin(const Int_t *eventClassBin) {
+  if (fSnapshot!=NULL)
+    return fSnapshot->GetBin(eventClassBin);
+  return fEntries->GetBin(eventClassBin);
+}
+
 /// Check the validity of the content of the passed bin
 /// If the number of entries is lower
 /// than the minimum number of entries to validate it
@@ -461,7 +504,7 @@ Long64_t CorrectionProfile3DCorrelations::GetBin(const double *variableContainer
 /// \param bin the bin to check its content validity
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t CorrectionProfile3DCorrelations::BinContentValidated(Long64_t bin) {
-  Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
+  Int_t nEntries = (fSnapshot!=NULL) ? fSnapshot->GetBinEntries(bin) : Int_t(fEntries->GetBinContent(bin));
 
   if (nEntries < fMinNoOfEntriesToValidate) {
     return kFALSE;
@@ -470,6 +513,19 @@ Bool_t CorrectionProfile3DCorrelations::BinContentValidated(Long64_t bin) {
   }
 }
 
+/// Get the Qn vector correlation combination from its name
+///
+/// \param comb the name of the desired Qn vector combination: "AB", "BC" or "AC"
+/// \return the Qn vector correlation combination
+CorrectionProfile3DCorrelations::QnCorrelationCombination CorrectionProfile3DCorrelations::GetCombination(const char *comb) {
+  for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+    if (strcmp(comb, szCombinationNames[ixComb])==0)
+      return QnCorrelationCombination(ixComb);
+  }
+  QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return kAB;
+}
+
 /// Get the XX correlation component bin content for the passed bin number
 /// for the corresponding harmonic and Qn vector combination
 ///
@@ -481,32 +537,38 @@ Bool_t CorrectionProfile3DCorrelations::BinContentValidated(Long64_t bin) {
 /// \param bin the interested bin number
 /// \return the bin number content
 Float_t CorrectionProfile3DCorrelations::GetXXBinContent(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetXXBinContent(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the XX correlation component bin content for the passed bin number
+/// for the corresponding harmonic and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin number content
+Float_t CorrectionProfile3DCorrelations::GetXXBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fXXValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fXXValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, FirstComponent(comb, harmonic));
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    return fXXValues[ixComb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
+    return fXXValues[comb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
   }
 }
 
@@ -521,32 +583,38 @@ Float_t CorrectionProfile3DCorrelations::GetXXBinContent(const char *comb, Int_t
 /// \param bin the interested bin number
 /// \return the bin number content
 Float_t CorrectionProfile3DCorrelations::GetXYBinContent(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetXYBinContent(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the XY correlation component bin content for the passed bin number
+/// for the corresponding harmonic and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin number content
+Float_t CorrectionProfile3DCorrelations::GetXYBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fXYValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fXYValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, FirstComponent(comb, harmonic) + 1);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    return fXYValues[ixComb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
+    return fXYValues[comb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
   }
 }
 
@@ -561,32 +629,38 @@ Float_t CorrectionProfile3DCorrelations::GetXYBinContent(const char *comb, Int_t
 /// \param bin the interested bin number
 /// \return the bin number content
 Float_t CorrectionProfile3DCorrelations::GetYXBinContent(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetYXBinContent(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the YX correlation component bin content for the passed bin number
+/// for the corresponding harmonic and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin number content
+Float_t CorrectionProfile3DCorrelations::GetYXBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fYXValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fYXValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, FirstComponent(comb, harmonic) + 2);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    return fYXValues[ixComb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
+    return fYXValues[comb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
   }
 }
 
@@ -601,32 +675,38 @@ Float_t CorrectionProfile3DCorrelations::GetYXBinContent(const char *comb, Int_t
 /// \param bin the interested bin number
 /// \return the bin number content
 Float_t CorrectionProfile3DCorrelations::GetYYBinContent(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetYYBinContent(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the YY correlation component bin content for the passed bin number
+/// for the corresponding harmonic and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin number content
+Float_t CorrectionProfile3DCorrelations::GetYYBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fYYValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fYYValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s  in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, FirstComponent(comb, harmonic) + 3);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    return fYYValues[ixComb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
+    return fYYValues[comb][harmonic]->GetBinContent(bin)/Float_t(nEntries);
   }
 }
 
@@ -641,33 +721,39 @@ Float_t CorrectionProfile3DCorrelations::GetYYBinContent(const char *comb, Int_t
 /// \param bin the interested bin number
 /// \return the bin content error
 Float_t CorrectionProfile3DCorrelations::GetXXBinError(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetXXBinError(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the XX correlation component bin content error for the passed bin number
+/// for the corresponding harmonic  and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// error is requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin content error
+Float_t CorrectionProfile3DCorrelations::GetXXBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fXXValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fXXValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, FirstComponent(comb, harmonic));
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    Float_t values = fXXValues[ixComb][harmonic]->GetBinContent(bin);
-    Float_t error2 = fXXValues[ixComb][harmonic]->GetBinError2(bin);
+    Float_t values = fXXValues[comb][harmonic]->GetBinContent(bin);
+    Float_t error2 = fXXValues[comb][harmonic]->GetBinError2(bin);
 
     Double_t average = values/nEntries;
     Double_t serror = TMath::Sqrt(TMath::Abs(error2/nEntries - average*average));
@@ -696,33 +782,39 @@ Float_t CorrectionProfile3DCorrelations::GetXXBinError(const char *comb, Int_t h
 /// \param bin the interested bin number
 /// \return the bin content error
 Float_t CorrectionProfile3DCorrelations::GetXYBinError(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetXYBinError(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the XY correlation component bin content error for the passed bin number
+/// for the corresponding harmonic  and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// error is requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin content error
+Float_t CorrectionProfile3DCorrelations::GetXYBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fXYValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fXYValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, FirstComponent(comb, harmonic) + 1);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    Float_t values = fXYValues[ixComb][harmonic]->GetBinContent(bin);
-    Float_t error2 = fXYValues[ixComb][harmonic]->GetBinError2(bin);
+    Float_t values = fXYValues[comb][harmonic]->GetBinContent(bin);
+    Float_t error2 = fXYValues[comb][harmonic]->GetBinError2(bin);
 
     Double_t average = values/nEntries;
     Double_t serror = TMath::Sqrt(TMath::Abs(error2/nEntries - average*average));
@@ -751,33 +843,39 @@ Float_t CorrectionProfile3DCorrelations::GetXYBinError(const char *comb, Int_t h
 /// \param bin the interested bin number
 /// \return the bin content error
 Float_t CorrectionProfile3DCorrelations::GetYXBinError(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetYXBinError(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the YX correlation component bin content error for the passed bin number
+/// for the corresponding harmonic  and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// error is requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin content error
+Float_t CorrectionProfile3DCorrelations::GetYXBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fYXValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fYXValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, FirstComponent(comb, harmonic) + 2);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    Float_t values = fYXValues[ixComb][harmonic]->GetBinContent(bin);
-    Float_t error2 = fYXValues[ixComb][harmonic]->GetBinError2(bin);
+    Float_t values = fYXValues[comb][harmonic]->GetBinContent(bin);
+    Float_t error2 = fYXValues[comb][harmonic]->GetBinError2(bin);
 
     Double_t average = values/nEntries;
     Double_t serror = TMath::Sqrt(TMath::Abs(error2/nEntries - average*average));
@@ -806,33 +904,39 @@ Float_t CorrectionProfile3DCorrelations::GetYXBinError(const char *comb, Int_t h
 /// \param bin the interested bin number
 /// \return the bin content error
 Float_t CorrectionProfile3DCorrelations::GetYYBinError(const char *comb, Int_t harmonic, Long64_t bin) {
-  TString szComb = comb;
-  Int_t ixComb = -1;
-  if (szComb.EqualTo("AB"))
-    ixComb = 0;
-  else if (szComb.EqualTo("BC"))
-    ixComb = 1;
-  else if (szComb.EqualTo("AC"))
-    ixComb = 2;
-  else
-    QnCorrectionsFatal(Form("Accessing non existing Qn vector correlation combination %s. FIX IT, PLEASE.", comb));
+  return GetYYBinError(GetCombination(comb), harmonic, bin);
+}
 
+/// Get the YY correlation component bin content error for the passed bin number
+/// for the corresponding harmonic  and Qn vector combination
+///
+/// The bin number identifies a desired event class whose content is
+/// error is requested. If the bin content is not validated zero is returned.
+///
+/// \param comb the desired Qn vector combination
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \return the bin content error
+Float_t CorrectionProfile3DCorrelations::GetYYBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin) {
   /* sanity check */
-  if (fYYValues[ixComb][harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                          : (fYYValues[comb][harmonic]==NULL)) {
     QnCorrectionsFatal(Form(
         "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
         harmonic,
-        comb,
+        szCombinationNames[comb],
         GetName()));
     return 0.0;
   }
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, FirstComponent(comb, harmonic) + 3);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
-    Float_t values = fYYValues[ixComb][harmonic]->GetBinContent(bin);
-    Float_t error2 = fYYValues[ixComb][harmonic]->GetBinError2(bin);
+    Float_t values = fYYValues[comb][harmonic]->GetBinContent(bin);
+    Float_t error2 = fYYValues[comb][harmonic]->GetBinError2(bin);
 
     Double_t average = values/nEntries;
     Double_t serror = TMath::Sqrt(TMath::Abs(error2/nEntries - average*average));
@@ -850,11 +954,69 @@ Float_t CorrectionProfile3DCorrelations::GetYYBinError(const char *comb, Int_t h
   }
 }
 
+/// Get the four correlation components of the three Qn vector combinations
+/// for the passed bin number and the corresponding harmonic
+///
+/// The bin number identifies a desired event class whose content is
+/// requested. The bin content validation and the number of entries are
+/// only evaluated once for the whole set of components. If the bin content
+/// is not validated the components are set to zero.
+///
+/// \param harmonic the interested external harmonic number
+/// \param bin the interested bin number
+/// \param correlations the place where the correlation components are stored
+/// \return kTRUE if the bin content is validated kFALSE otherwise
+Bool_t CorrectionProfile3DCorrelations::GetBinCorrelations(Int_t harmonic,
+                                                           Long64_t bin,
+                                                           QnCorrelationComponents &correlations) {
+  /* sanity check */
+  for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+    if ((fSnapshot!=NULL) ? !(fSnapshot->GetHarmonicMask() & harmonicNumberMask[harmonic])
+                            : (fXXValues[ixComb][harmonic]==NULL)) {
+      QnCorrectionsFatal(Form(
+          "Accessing non allocated harmonic %d of Qn vector combination %s in correlation component histogram %s. FIX IT, PLEASE.",
+          harmonic,
+          szCombinationNames[ixComb],
+          GetName()));
+      return kFALSE;
+    }
+  }
+
+  if (!BinContentValidated(bin)) {
+    for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+      correlations.fXX[ixComb] = 0.0;
+      correlations.fXY[ixComb] = 0.0;
+      correlations.fYX[ixComb] = 0.0;
+      correlations.fYY[ixComb] = 0.0;
+    }
+    return kFALSE;
+  } else if (fSnapshot!=NULL) {
+    for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+      Int_t component = FirstComponent(ixComb, harmonic);
+      correlations.fXX[ixComb] = fSnapshot->GetBinValue(bin, component);
+      correlations.fXY[ixComb] = fSnapshot->GetBinValue(bin, component + 1);
+      correlations.fYX[ixComb] = fSnapshot->GetBinValue(bin, component + 2);
+      correlations.fYY[ixComb] = fSnapshot->GetBinValue(bin, component + 3);
+    }
+    return kTRUE;
+  } else {
+    Float_t nEntries = Float_t(Int_t(fEntries->GetBinContent(bin)));
+    for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+      correlations.fXX[ixComb] = fXXValues[ixComb][harmonic]->GetBinContent(bin)/nEntries;
+      correlations.fXY[ixComb] = fXYValues[ixComb][harmonic]->GetBinContent(bin)/nEntries;
+      correlations.fYX[ixComb] = fYXValues[ixComb][harmonic]->GetBinContent(bin)/nEntries;
+      correlations.fYY[ixComb] = fYYValues[ixComb][harmonic]->GetBinContent(bin)/nEntries;
+    }
+    return kTRUE;
+  }
+}
+
 /// Fills the correlation component for the different Qn vector correlation combinations
 /// and for all handled harmonic histogram
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the corresponding values.
+/// content. The bin is then increased by the corresponding values
+/// in the fill storage, transferred to the histograms by FlushFills.
 /// The entries count is updated accordingly.
 ///
 /// It is considered that the three Qn vectors have the same harmonic
@@ -879,6 +1041,7 @@ void CorrectionProfile3DCorrelations::Fill(const CorrectionQnVector *QnA,
 
   /* let's get the axis information */
   FillBinAxesValues(variableContainer);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
 
   /* consider all combinations */
   const CorrectionQnVector *combQn[CORRELATIONSNOOFQNVECTORS] = {QnA, QnB, QnC};
@@ -893,35 +1056,153 @@ void CorrectionProfile3DCorrelations::Fill(const CorrectionQnVector *QnA,
                                 GetName()));
       }
 
-      /* keep total entries in fValues updated */
-      Double_t nXXEntries = fXXValues[ixComb][nCurrentHarmonic]->GetEntries();
-      Double_t nXYEntries = fXYValues[ixComb][nCurrentHarmonic]->GetEntries();
-      Double_t nYXEntries = fYXValues[ixComb][nCurrentHarmonic]->GetEntries();
-      Double_t nYYEntries = fYYValues[ixComb][nCurrentHarmonic]->GetEntries();
-
-      fXXValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues,
-                                                combQn[ixComb]->Qx(nCurrentHarmonic)*combQn[(ixComb + 1)
-                                                    %CORRELATIONSNOOFQNVECTORS]->Qx(nCurrentHarmonic));
-      fXYValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues,
-                                                combQn[ixComb]->Qx(nCurrentHarmonic)*combQn[(ixComb + 1)
-                                                    %CORRELATIONSNOOFQNVECTORS]->Qy(nCurrentHarmonic));
-      fYXValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues,
-                                                combQn[ixComb]->Qy(nCurrentHarmonic)*combQn[(ixComb + 1)
-                                                    %CORRELATIONSNOOFQNVECTORS]->Qx(nCurrentHarmonic));
-      fYYValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues,
-                                                combQn[ixComb]->Qy(nCurrentHarmonic)*combQn[(ixComb + 1)
-                                                    %CORRELATIONSNOOFQNVECTORS]->Qy(nCurrentHarmonic));
-
-      fXXValues[ixComb][nCurrentHarmonic]->SetEntries(nXXEntries + 1);
-      fXYValues[ixComb][nCurrentHarmonic]->SetEntries(nXYEntries + 1);
-      fYXValues[ixComb][nCurrentHarmonic]->SetEntries(nYXEntries + 1);
-      fYYValues[ixComb][nCurrentHarmonic]->SetEntries(nYYEntries + 1);
+      /* the four components of the harmonic are contiguous in the fill storage */
+      Int_t component = FirstComponent(ixComb, nCurrentHarmonic);
+      const CorrectionQnVector *QnFirst = combQn[ixComb];
+      const CorrectionQnVector *QnSecond = combQn[(ixComb + 1)%CORRELATIONSNOOFQNVECTORS];
+      fAccumulator.Fill(bin, component,
+                        QnFirst->Qx(nCurrentHarmonic)*QnSecond->Qx(nCurrentHarmonic));
+      fAccumulator.Fill(bin, component + 1,
+                        QnFirst->Qx(nCurrentHarmonic)*QnSecond->Qy(nCurrentHarmonic));
+      fAccumulator.Fill(bin, component + 2,
+                        QnFirst->Qy(nCurrentHarmonic)*QnSecond->Qx(nCurrentHarmonic));
+      fAccumulator.Fill(bin, component + 3,
+                        QnFirst->Qy(nCurrentHarmonic)*QnSecond->Qy(nCurrentHarmonic));
 
       nCurrentHarmonic = QnA->GetNextHarmonic(nCurrentHarmonic);
     }
   }
 
   /* update the profile entries */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, 0, 1.0);
+}
+
+/// Fills the correlation component for the different Qn vector correlation combinations
+/// and for all handled harmonic histogram
+///
+/// The involved bin is computed once from the current event class
+/// bin. The bin is then increased by the corresponding values
+/// in the fill storage, transferred to the histograms by FlushFills.
+/// The entries count is updated accordingly.
+///
+/// It is considered that the three Qn vectors have the same harmonic
+/// structure including the harmonic multiplier. If this is not the case
+/// and that situation should be supported this member must be modified.
+/// \param QnA A Qn vector
+/// \param QnB B Qn vector
+/// \param QnC C Qn vector
+/// \param eventClassBin the current event class bin on each of the variables
+void CorrectionProfile3DCorrelations::Fill(const CorrectionQnVector *QnA,
+                                              const CorrectionQnVector *QnB,
+                                              const CorrectionQnVector *QnC,
+                                              const Int_t *eventClassBin) {
+
+  /* first the sanity checks */
+  if (!((QnA->IsGoodQuality()) && (QnB->IsGoodQuality()) && (QnC->IsGoodQuality()))) return;
+  if ((QnA->GetHarmonicMultiplier()!=QnB->GetHarmonicMultiplier())
+      || (QnA->GetHarmonicMultiplier()!=QnC->GetHarmonicMultiplier())) {
+    QnCorrectionsFatal("Your are accessing here with Qn vectors with different harmonic multipliers. FIX IT, PLEASE.");
+    return;
+  }
+
+  /* all the histograms share the binning so the bin is located only once */
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+
+  /* consider all combinations */
+  const CorrectionQnVector *combQn[CORRELATIONSNOOFQNVECTORS] = {QnA, QnB, QnC};
+  for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+    /* and all harmonics */
+    Int_t nCurrentHarmonic = QnA->GetFirstHarmonic();
+    while (nCurrentHarmonic!=-1) {
+      /* first the sanity checks */
+      if (fXXValues[ixComb][nCurrentHarmonic]==NULL) {
+        QnCorrectionsFatal(Form("Non allocated harmonic %d in 3D correlation component histogram %s. FIX IT, PLEASE.",
+                                nCurrentHarmonic,
+                                GetName()));
+      }
+
+      /* the four components of the harmonic are contiguous in the fill storage */
+      Int_t component = FirstComponent(ixComb, nCurrentHarmonic);
+      const CorrectionQnVector *QnFirst = combQn[ixComb];
+      const CorrectionQnVector *QnSecond = combQn[(ixComb + 1)%CORRELATIONSNOOFQNVECTORS];
+      fAccumulator.Fill(bin, component,
+                        QnFirst->Qx(nCurrentHarmonic)*QnSecond->Qx(nCurrentHarmonic));
+      fAccumulator.Fill(bin, component + 1,
+                        QnFirst->Qx(nCurrentHarmonic)*QnSecond->Qy(nCurrentHarmonic));
+      fAccumulator.Fill(bin, component + 2,
+                        QnFirst->Qy(nCurrentHarmonic)*QnSecond->Qx(nCurrentHarmonic));
+      fAccumulator.Fill(bin, component + 3,
+                        QnFirst->Qy(nCurrentHarmonic)*QnSecond->Qy(nCurrentHarmonic));
+
+      nCurrentHarmonic = QnA->GetNextHarmonic(nCurrentHarmonic);
+    }
+  }
+
+  /* update the profile entries */
+  fAccumulator.Fill(bin, 0, 1.0);
+}
+
+/// Transfers the content of the fill storage to the histograms
+///
+/// The four correlation components of each Qn vector combination
+/// and harmonic and the entries are added to their histograms and
+/// the fill storage is cleared. Nothing is done if there are no
+/// pending fills.
+void CorrectionProfile3DCorrelations::FlushFills() {
+  if (!fAccumulator.IsPending()) return;
+
+  for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+    for (Int_t harmonic = 0; harmonic < fNoOfSlots; harmonic++) {
+      if (fXXValues[ixComb][harmonic]==NULL) continue;
+      Int_t component = FirstComponent(ixComb, harmonic);
+      fAccumulator.Flush(component, fXXValues[ixComb][harmonic]);
+      fAccumulator.Flush(component + 1, fXYValues[ixComb][harmonic]);
+      fAccumulator.Flush(component + 2, fYXValues[ixComb][harmonic]);
+      fAccumulator.Flush(component + 3, fYYValues[ixComb][harmonic]);
+    }
+  }
+  fAccumulator.Flush(0, fEntries);
+  fAccumulator.Reset();
+}
+
+/// Exports the attached calibration information as a calibration snapshot
+///
+/// For each bin the entries and the four correlation components mean
+/// and spread for each attached harmonic and Qn vector combination are
+/// stored in the snapshot, that is added to the passed list. If the
+/// profile is attached to a snapshot, a copy of it is added instead.
+/// \param list list where the snapshot should be incorporated
+/// \return kTRUE if the snapshot was exported, kFALSE if nothing is attached
+Bool_t CorrectionProfile3DCorrelations::ExportSnapshot(TList *list) {
+  if (fSnapshot!=NULL) {
+    list->Add(fSnapshot->Clone());
+    return kTRUE;
+  }
+  if ((fEntries==NULL) || (fXXValues==NULL))
+    return kFALSE;
+
+  CorrectionCalibrationSnapshot *snapshot =
+      new CorrectionCalibrationSnapshot(Form("%s%s", GetName(), szSnapshotSuffix),
+                                        Form("%s%s", GetTitle(), szSnapshotSuffix),
+                                        fEntries,
+                                        FirstComponent(CORRELATIONSNOOFQNVECTORS, 0));
+  snapshot->SetEntries(fEntries);
+  UInt_t harmonicMask = 0x0000;
+  for (Int_t ixComb = 0; ixComb < CORRELATIONSNOOFQNVECTORS; ixComb++) {
+    for (Int_t harmonic = 1; harmonic < fNoOfSlots; harmonic++) {
+      if ((fXXValues[ixComb][harmonic]!=NULL) && (fXYValues[ixComb][harmonic]!=NULL)
+          && (fYXValues[ixComb][harmonic]!=NULL) && (fYYValues[ixComb][harmonic]!=NULL)) {
+        Int_t component = FirstComponent(ixComb, harmonic);
+        snapshot->SetComponent(component, fXXValues[ixComb][harmonic], fEntries);
+        snapshot->SetComponent(component + 1, fXYValues[ixComb][harmonic], fEntries);
+        snapshot->SetComponent(component + 2, fYXValues[ixComb][harmonic], fEntries);
+        snapshot->SetComponent(component + 3, fYYValues[ixComb][harmonic], fEntries);
+        harmonicMask |= harmonicNumberMask[harmonic];
+      }
+    }
+  }
+  snapshot->SetHarmonicMask(harmonicMask);
+  list->Add(snapshot);
+  return kTRUE;
+}
 }
-}
\ No newline at end of file
@@ -196,6 +196,22 @@ Long64_t CorrectionProfileChannelized::GetBin(const double *variableContainer, I
   return fEntries->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin and passed channel
+///
+/// The bin number identifies the event class the current
+/// event class bin points to under the passed channel.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionProfileChannelized::GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+
+  /* store also the channel bin */
+  FillBinAxesBins(eventClassBin,
+                  fEntries->GetAxis(fEventClassVariables.GetEntriesFast())->FindFixBin(fChannelMap[nChannel]));
+  return fEntries->GetBin(fBinAxesBins);
+}
+
 /// Check the validity of the content of the passed bin
 /// If the number of entries is lower
 /// than the minimum number of entries to validate it
@@ -281,4 +297,26 @@ void CorrectionProfileChannelized::Fill(const double *variableContainer, Int_t n
   fValues->SetEntries(nEntries + 1);
   fEntries->Fill(fBinAxesValues, 1.0);
 }
+
+/// Fills the histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin and the passed external channel number. The bin is then
+/// increased by the given weight and the entries also increased properly.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \param weight the increment in the bin content
+void CorrectionProfileChannelized::Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight) {
+  /* keep the total entries in fValues updated */
+  Double_t nEntries = fValues->GetEntries();
+
+  FillBinAxesBins(eventClassBin,
+                  fValues->GetAxis(fEventClassVariables.GetEntriesFast())->FindFixBin(fChannelMap[nChannel]));
+  /* and now update the bin */
+  Long64_t bin = fValues->GetBin(fBinAxesBins);
+  fValues->FillBin(bin, weight);
+  fValues->SetEntries(nEntries + 1);
+  fEntries->FillBin(bin, 1.0);
+}
 }
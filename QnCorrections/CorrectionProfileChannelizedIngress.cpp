@@ -28,6 +28,7 @@ CorrectionProfileChannelizedIngress::CorrectionProfileChannelizedIngress() :
   fActualNoOfGroups = 0;
   fNoOfGroups = 0;
   fGroupMap = NULL;
+  fGroupSnapshot = NULL;
 }
 
 /// Normal constructor
@@ -66,6 +67,7 @@ CorrectionProfileChannelizedIngress::CorrectionProfileChannelizedIngress(const c
   fActualNoOfGroups = 0;
   fNoOfGroups = 0;
   fGroupMap = NULL;
+  fGroupSnapshot = NULL;
 }
 
 /// Default destructor
@@ -99,6 +101,9 @@ CorrectionProfileChannelizedIngress::~CorrectionProfileChannelizedIngress() {
 /// Once the histograms are found and validated, a unique value / error channel histogram
 /// is created for efficient access and a potential unique value / error channels group
 /// histogram is created.
+///
+/// If the calibration snapshots of the profile are found in the list they are
+/// attached instead and no histogram is built.
 /// \param histogramList list where the histograms have to be located
 /// \param bUsedChannel array of booleans one per each channel
 /// \param nChannelGroup array of group number for each channel
@@ -123,6 +128,7 @@ Bool_t CorrectionProfileChannelizedIngress::AttachHistograms(TList *histogramLis
   if (fChannelMap!=NULL) delete[] fChannelMap;
   if (fUsedGroup!=NULL) delete[] fUsedGroup;
   if (fGroupMap!=NULL) delete[] fGroupMap;
+  fGroupSnapshot = NULL;
 
 
   /* lets consider now the channel information */
@@ -188,6 +194,19 @@ Bool_t CorrectionProfileChannelizedIngress::AttachHistograms(TList *histogramLis
     }
   }
 
+  /* a calibration snapshot takes precedence over the histograms */
+  if (AttachSnapshot(histogramList)) {
+    if (fSnapshot->GetNoOfDimensions()!=(fEventClassVariables.GetEntriesFast() + 1))
+      return kFALSE;
+    if (fUseGroups) {
+      fGroupSnapshot = (CorrectionCalibrationSnapshot *) histogramList->FindObject(
+          Form("%s%s%s", szGroupHistoPrefix, GetName(), szSnapshotSuffix));
+      if (fGroupSnapshot==NULL)
+        return kFALSE;
+    }
+    return kTRUE;
+  }
+
   /* let's first try the Values / Entries structure */
   THnI *origEntries = (THnI *) histogramList->FindObject((const char *) entriesHistoName);
   if (origEntries!=NULL && origEntries->GetEntries()!=0) {
@@ -348,11 +367,37 @@ Bool_t CorrectionProfileChannelizedIngress::AttachHistograms(TList *histogramLis
 /// \return the associated bin to the current variables content
 Long64_t CorrectionProfileChannelizedIngress::GetBin(const double *variableContainer, Int_t nChannel) {
 
+  if (fSnapshot!=NULL) {
+    /* store also the channel bin */
+    FillBinAxesBins(variableContainer, fChannelMap[nChannel] + 1);
+    return fSnapshot->GetBin(fBinAxesBins);
+  }
   /* store also the channel number */
   FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
   return fValues->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin and passed channel
+///
+/// The bin number identifies the event class the current
+/// event class bin points to under the passed channel.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionProfileChannelizedIngress::GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+
+  if (fSnapshot!=NULL) {
+    /* store also the channel bin */
+    FillBinAxesBins(eventClassBin, fChannelMap[nChannel] + 1);
+    return fSnapshot->GetBin(fBinAxesBins);
+  }
+  /* store also the channel number */
+  FillBinAxesBins(eventClassBin,
+                  fValues->GetAxis(fEventClassVariables.GetEntriesFast())->FindFixBin(fChannelMap[nChannel]));
+  return fValues->GetBin(fBinAxesBins);
+}
+
 /// Check the validity of the content of the passed bin
 /// For the time being this kind of histograms cannot check
 /// bin content validity so, kTRUE is returned.
@@ -360,6 +405,9 @@ Long64_t CorrectionProfileChannelizedIngress::GetBin(const double *variableConta
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t CorrectionProfileChannelizedIngress::BinContentValidated(Long64_t bin) {
 
+  if (fSnapshot!=NULL) {
+    return (fSnapshot->GetBinEntries(bin)!=0);
+  }
   if (fValidated->GetBinContent(bin) < 0.5) {
     return kFALSE;
   } else {
@@ -376,6 +424,8 @@ Bool_t CorrectionProfileChannelizedIngress::BinContentValidated(Long64_t bin) {
 /// \return the bin number content
 Float_t CorrectionProfileChannelizedIngress::GetBinContent(Long64_t bin) {
 
+  if (fSnapshot!=NULL)
+    return fSnapshot->GetBinValue(bin, 0);
   return fValues->GetBinContent(bin);
 }
 
@@ -388,6 +438,8 @@ Float_t CorrectionProfileChannelizedIngress::GetBinContent(Long64_t bin) {
 /// \return the bin number content error
 Float_t CorrectionProfileChannelizedIngress::GetBinError(Long64_t bin) {
 
+  if (fSnapshot!=NULL)
+    return fSnapshot->GetBinSpread(bin, 0);
   return fValues->GetBinError(bin);
 }
 
@@ -403,6 +455,11 @@ Long64_t CorrectionProfileChannelizedIngress::GetGrpBin(const double *variableCo
 
   /* check the groups structures are in place */
   if (fUseGroups) {
+    if (fGroupSnapshot!=NULL) {
+      /* store also the group bin */
+      FillBinAxesBins(variableContainer, fGroupMap[fChannelGroup[nChannel]] + 1);
+      return fGroupSnapshot->GetBin(fBinAxesBins);
+    }
     /* store also the group number */
     FillBinAxesValues(variableContainer, fGroupMap[fChannelGroup[nChannel]]);
     return fGroupValues->GetBin(fBinAxesValues);
@@ -410,6 +467,31 @@ Long64_t CorrectionProfileChannelizedIngress::GetGrpBin(const double *variableCo
   return -1;
 }
 
+/// Get the bin number for the current event class bin and passed channel group number
+///
+/// The bin number identifies the event class the current
+/// event class bin points to under the passed channel group number.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param nChannel the interested external channel number which group number is asked
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionProfileChannelizedIngress::GetGrpBin(const Int_t *eventClassBin, Int_t nChannel) {
+
+  /* check the groups structures are in place */
+  if (fUseGroups) {
+    if (fGroupSnapshot!=NULL) {
+      /* store also the group bin */
+      FillBinAxesBins(eventClassBin, fGroupMap[fChannelGroup[nChannel]] + 1);
+      return fGroupSnapshot->GetBin(fBinAxesBins);
+    }
+    /* store also the group number */
+    FillBinAxesBins(eventClassBin,
+                    fGroupValues->GetAxis(fEventClassVariables.GetEntriesFast())->FindFixBin(fGroupMap[fChannelGroup[nChannel]]));
+    return fGroupValues->GetBin(fBinAxesBins);
+  }
+  return -1;
+}
+
 /// Get the group bin content for the passed bin number
 ///
 /// The bin number identifies a desired event class whose group content
@@ -421,6 +503,8 @@ Float_t CorrectionProfileChannelizedIngress::GetGrpBinContent(Long64_t bin) {
 
   /* check the groups structures are in place */
   if (fUseGroups) {
+    if (fGroupSnapshot!=NULL)
+      return fGroupSnapshot->GetBinValue(bin, 0);
     return fGroupValues->GetBinContent(bin);
   }
   return 1.0;
@@ -437,9 +521,56 @@ Float_t CorrectionProfileChannelizedIngress::GetGrpBinError(Long64_t bin) {
 
   /* check the groups structures are in place */
   if (fUseGroups) {
+    if (fGroupSnapshot!=NULL)
+      return fGroupSnapshot->GetBinSpread(bin, 0);
     return fGroupValues->GetBinError(bin);
   }
   return 1.0;
 }
-}
 
+/// Exports the attached calibration information as calibration snapshots
+///
+/// The ingress profile values are already final so, for each bin, the
+/// value and its error are stored in the snapshot as the component value
+/// and spread, and the bin validation as its entries. If applicable, the
+/// group values and errors are stored in their own snapshot. The snapshots
+/// are added to the passed list. If the profile is attached to snapshots,
+/// copies of them are added instead.
+/// \param list list where the snapshots should be incorporated
+/// \return kTRUE if the snapshots were exported, kFALSE if nothing is attached
+Bool_t CorrectionProfileChannelizedIngress::ExportSnapshot(TList *list) {
+  if (fSnapshot!=NULL) {
+    list->Add(fSnapshot->Clone());
+    if (fGroupSnapshot!=NULL)
+      list->Add(fGroupSnapshot->Clone());
+    return kTRUE;
+  }
+  if (fValues==NULL)
+    return kFALSE;
+
+  CorrectionCalibrationSnapshot *snapshot =
+      new CorrectionCalibrationSnapshot(Form("%s%s", GetName(), szSnapshotSuffix),
+                                        Form("%s%s", GetTitle(), szSnapshotSuffix),
+                                        fValues,
+                                        1);
+  for (Long64_t bin = 0; bin < snapshot->GetNoOfBins(); bin++) {
+    snapshot->SetBinEntries(bin, (fValidated->GetBinContent(bin) < 0.5) ? 0 : 1);
+    snapshot->SetBinComponent(bin, 0, fValues->GetBinContent(bin), fValues->GetBinError(bin));
+  }
+  list->Add(snapshot);
+
+  if (fUseGroups) {
+    CorrectionCalibrationSnapshot *groupSnapshot =
+        new CorrectionCalibrationSnapshot(Form("%s%s%s", szGroupHistoPrefix, GetName(), szSnapshotSuffix),
+                                          Form("%s%s%s", szGroupHistoPrefix, GetTitle(), szSnapshotSuffix),
+                                          fGroupValues,
+                                          1);
+    for (Long64_t bin = 0; bin < groupSnapshot->GetNoOfBins(); bin++) {
+      groupSnapshot->SetBinEntries(bin, 1);
+      groupSnapshot->SetBinComponent(bin, 0, fGroupValues->GetBinContent(bin), fGroupValues->GetBinError(bin));
+    }
+    list->Add(groupSnapshot);
+  }
+  return kTRUE;
+}
+}
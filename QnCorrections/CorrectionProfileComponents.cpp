@@ -205,6 +205,9 @@ Bool_t CorrectionProfileComponents::CreateComponentsProfileHistograms(TList *his
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
 
+  /* the fill storage: the entries plus the X and Y components for each harmonic slot */
+  fAccumulator.Allocate(fEntries->GetNbins(), 1 + 2*nNumberOfSlots);
+
   delete[] minvals;
   delete[] maxvals;
   delete[] nbins;
@@ -221,6 +224,9 @@ Bool_t CorrectionProfileComponents::CreateComponentsProfileHistograms(TList *his
 /// The harmonic map is inferred from the found histograms within the list
 /// that match the naming scheme.
 ///
+/// If the calibration snapshot of the profile is found in the list it
+/// is attached instead of the histograms.
+///
 /// \param histogramList list where the histograms have to be located
 /// \return true if properly attached else false
 Bool_t CorrectionProfileComponents::AttachHistograms(TList *histogramList) {
@@ -247,6 +253,13 @@ Bool_t CorrectionProfileComponents::AttachHistograms(TList *histogramList) {
   fXharmonicFillMask = 0x0000;
   fYharmonicFillMask = 0x0000;
   fFullFilled = 0x0000;
+  fAccumulator.Release();
+
+  /* a calibration snapshot takes precedence over the histograms */
+  if (AttachSnapshot(histogramList)) {
+    fFullFilled = fSnapshot->GetHarmonicMask();
+    return (fFullFilled!=0x0000);
+  }
 
   fEntries = (THnI *) histogramList->FindObject((const char *) entriesHistoName);
   if (fEntries!=NULL && fEntries->GetEntries()!=0) {
@@ -286,10 +299,27 @@ Bool_t CorrectionProfileComponents::AttachHistograms(TList *histogramList) {
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t CorrectionProfileComponents::GetBin(const double *variableContainer) {
+  if (fSnapshot!=NULL) {
+    FillBinAxesBins(variableContainer);
+    return fSnapshot->GetBin(fBinAxesBins);
+  }
   FillBinAxesValues(variableContainer);
   return fEntries->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin
+///
+/// The bin number identifies the event class the current
+/// event class bin points to.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionProfileComponents::GetBin(const Int_t *eventClassBin) {
+  if (fSnapshot!=NULL)
+    return fSnapshot->GetBin(eventClassBin);
+  return fEntries->GetBin(eventClassBin);
+}
+
 /// Check the validity of the content of the passed bin
 /// If the number of entries is lower
 /// than the minimum number of entries to validate it
@@ -298,7 +328,7 @@ Long64_t CorrectionProfileComponents::GetBin(const double *variableContainer) {
 /// \param bin the bin to check its content validity
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t CorrectionProfileComponents::BinContentValidated(Long64_t bin) {
-  Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
+  Int_t nEntries = (fSnapshot!=NULL) ? fSnapshot->GetBinEntries(bin) : Int_t(fEntries->GetBinContent(bin));
 
   if (nEntries < fMinNoOfEntriesToValidate) {
     return kFALSE;
@@ -319,7 +349,7 @@ Bool_t CorrectionProfileComponents::BinContentValidated(Long64_t bin) {
 Float_t CorrectionProfileComponents::GetXBinContent(Int_t harmonic, Long64_t bin) {
 
   /* sanity check */
-  if (fXValues[harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fFullFilled & harmonicNumberMask[harmonic]) : (fXValues[harmonic]==NULL)) {
     QnCorrectionsFatal(Form("Accessing non allocated harmonic %d in component histogram %s. FIX IT, PLEASE.",
                             harmonic,
                             GetName()));
@@ -328,6 +358,8 @@ Float_t CorrectionProfileComponents::GetXBinContent(Int_t harmonic, Long64_t bin
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, XComponent(harmonic));
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     return fXValues[harmonic]->GetBinContent(bin)/Float_t(nEntries);
@@ -346,7 +378,7 @@ Float_t CorrectionProfileComponents::GetXBinContent(Int_t harmonic, Long64_t bin
 Float_t CorrectionProfileComponents::GetYBinContent(Int_t harmonic, Long64_t bin) {
 
   /* sanity check */
-  if (fYValues[harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fFullFilled & harmonicNumberMask[harmonic]) : (fYValues[harmonic]==NULL)) {
     QnCorrectionsFatal(Form("Accessing non allocated harmonic %d in component histogram %s. FIX IT, PLEASE.",
                             harmonic,
                             GetName()));
@@ -355,6 +387,8 @@ Float_t CorrectionProfileComponents::GetYBinContent(Int_t harmonic, Long64_t bin
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, YComponent(harmonic));
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     return fYValues[harmonic]->GetBinContent(bin)/Float_t(nEntries);
@@ -373,7 +407,7 @@ Float_t CorrectionProfileComponents::GetYBinContent(Int_t harmonic, Long64_t bin
 Float_t CorrectionProfileComponents::GetXBinError(Int_t harmonic, Long64_t bin) {
 
   /* sanity check */
-  if (fXValues[harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fFullFilled & harmonicNumberMask[harmonic]) : (fXValues[harmonic]==NULL)) {
     QnCorrectionsFatal(Form("Accessing non allocated harmonic %d in component histogram %s. FIX IT, PLEASE.",
                             harmonic,
                             GetName()));
@@ -382,6 +416,8 @@ Float_t CorrectionProfileComponents::GetXBinError(Int_t harmonic, Long64_t bin)
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, XComponent(harmonic));
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     Float_t values = fXValues[harmonic]->GetBinContent(bin);
@@ -415,7 +451,7 @@ Float_t CorrectionProfileComponents::GetXBinError(Int_t harmonic, Long64_t bin)
 Float_t CorrectionProfileComponents::GetYBinError(Int_t harmonic, Long64_t bin) {
 
   /* sanity check */
-  if (fYValues[harmonic]==NULL) {
+  if ((fSnapshot!=NULL) ? !(fFullFilled & harmonicNumberMask[harmonic]) : (fYValues[harmonic]==NULL)) {
     QnCorrectionsFatal(Form("Accessing non allocated harmonic %d in component histogram %s. FIX IT, PLEASE.",
                             harmonic,
                             GetName()));
@@ -424,6 +460,8 @@ Float_t CorrectionProfileComponents::GetYBinError(Int_t harmonic, Long64_t bin)
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, YComponent(harmonic));
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     Float_t values = fYValues[harmonic]->GetBinContent(bin);
@@ -448,7 +486,8 @@ Float_t CorrectionProfileComponents::GetYBinError(Int_t harmonic, Long64_t bin)
 /// Fills the X component for the corresponding harmonic histogram
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the given weight.
+/// content. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
 /// The entries is only updated if the whole set for both components
 /// has been already filled. A check is done for detecting consecutive
 /// fills for certain harmonic without a previous entries update.
@@ -473,12 +512,53 @@ void CorrectionProfileComponents::FillX(Int_t harmonic, const double *variableCo
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXValues[harmonic]->Fill(fBinAxesValues, weight);
-  fXValues[harmonic]->SetEntries(nEntries + 1);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
+  fAccumulator.Fill(bin, XComponent(harmonic), weight);
+
+  /* update harmonic fill mask */
+  fXharmonicFillMask |= harmonicNumberMask[harmonic];
+
+  /* now check if time for updating entries histogram */
+  if (fXharmonicFillMask!=fFullFilled) return;
+  if (fYharmonicFillMask!=fFullFilled) return;
+  /* update entries and reset the masks */
+  fAccumulator.Fill(bin, 0, 1.0);
+  fXharmonicFillMask = 0x0000;
+  fYharmonicFillMask = 0x0000;
+}
+
+/// Fills the X component for the corresponding harmonic histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
+/// The entries is only updated if the whole set for both components
+/// has been already filled. A check is done for detecting consecutive
+/// fills for certain harmonic without a previous entries update.
+///
+/// \param harmonic the interested external harmonic number
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionProfileComponents::FillX(Int_t harmonic, const Int_t *eventClassBin, Float_t weight) {
+  /* first the sanity checks */
+  if (fXValues[harmonic]==NULL) {
+    QnCorrectionsFatal(Form("Accessing non allocated harmonic %d in component histogram %s. FIX IT, PLEASE.",
+                            harmonic,
+                            GetName()));
+  }
+
+  if (fXharmonicFillMask & harmonicNumberMask[harmonic]) {
+    QnCorrectionsFatal(Form("Filling twice the harmonic %d before entries update in histogram %s.\n" \
+        "   This means you probably have not updated the other components for this harmonic. FIX IT, PLEASE.",
+                            harmonic,
+                            GetName()));
+  }
+
+  /* now it's safe to continue */
+
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+  fAccumulator.Fill(bin, XComponent(harmonic), weight);
 
   /* update harmonic fill mask */
   fXharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -487,7 +567,7 @@ void CorrectionProfileComponents::FillX(Int_t harmonic, const double *variableCo
   if (fXharmonicFillMask!=fFullFilled) return;
   if (fYharmonicFillMask!=fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, 0, 1.0);
   fXharmonicFillMask = 0x0000;
   fYharmonicFillMask = 0x0000;
 }
@@ -495,7 +575,8 @@ void CorrectionProfileComponents::FillX(Int_t harmonic, const double *variableCo
 /// Fills the Y component for the corresponding harmonic histogram
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the given weight.
+/// content. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
 /// The entries is only updated if the whole set for both components
 /// has been already filled. A check is done for detecting consecutive
 /// fills for certain harmonic without a previous entries update.
@@ -520,12 +601,53 @@ void CorrectionProfileComponents::FillY(Int_t harmonic, const double *variableCo
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYValues[harmonic]->Fill(fBinAxesValues, weight);
-  fYValues[harmonic]->SetEntries(nEntries + 1);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
+  fAccumulator.Fill(bin, YComponent(harmonic), weight);
+
+  /* update harmonic fill mask */
+  fYharmonicFillMask |= harmonicNumberMask[harmonic];
+
+  /* now check if time for updating entries histogram */
+  if (fYharmonicFillMask!=fFullFilled) return;
+  if (fXharmonicFillMask!=fFullFilled) return;
+  /* update entries and reset the masks */
+  fAccumulator.Fill(bin, 0, 1.0);
+  fXharmonicFillMask = 0x0000;
+  fYharmonicFillMask = 0x0000;
+}
+
+/// Fills the Y component for the corresponding harmonic histogram
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
+/// The entries is only updated if the whole set for both components
+/// has been already filled. A check is done for detecting consecutive
+/// fills for certain harmonic without a previous entries update.
+///
+/// \param harmonic the interested external harmonic number
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionProfileComponents::FillY(Int_t harmonic, const Int_t *eventClassBin, Float_t weight) {
+  /* first the sanity checks */
+  if (fYValues[harmonic]==NULL) {
+    QnCorrectionsFatal(Form("Accessing non allocated harmonic %d in component histogram %s. FIX IT, PLEASE.",
+                            harmonic,
+                            GetName()));
+  }
+
+  if (fYharmonicFillMask & harmonicNumberMask[harmonic]) {
+    QnCorrectionsFatal(Form("Filling twice the harmonic %d before entries update in histogram %s.\n" \
+        "   This means you probably have not updated the other components for this harmonic. FIX IT, PLEASE.",
+                            harmonic,
+                            GetName()));
+  }
+
+  /* now it's safe to continue */
+
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+  fAccumulator.Fill(bin, YComponent(harmonic), weight);
 
   /* update harmonic fill mask */
   fYharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -534,9 +656,61 @@ void CorrectionProfileComponents::FillY(Int_t harmonic, const double *variableCo
   if (fYharmonicFillMask!=fFullFilled) return;
   if (fXharmonicFillMask!=fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, 0, 1.0);
   fXharmonicFillMask = 0x0000;
   fYharmonicFillMask = 0x0000;
 }
+
+/// Transfers the content of the fill storage to the histograms
+///
+/// The X and Y components of each harmonic and the entries are added
+/// to their histograms and the fill storage is cleared. Nothing is
+/// done if there are no pending fills.
+void CorrectionProfileComponents::FlushFills() {
+  if (!fAccumulator.IsPending()) return;
+
+  Int_t nNumberOfSlots = (fAccumulator.GetNoOfComponents() - 1)/2;
+  for (Int_t harmonic = 0; harmonic < nNumberOfSlots; harmonic++) {
+    if (fXValues[harmonic]!=NULL)
+      fAccumulator.Flush(XComponent(harmonic), fXValues[harmonic]);
+    if (fYValues[harmonic]!=NULL)
+      fAccumulator.Flush(YComponent(harmonic), fYValues[harmonic]);
+  }
+  fAccumulator.Flush(0, fEntries);
+  fAccumulator.Reset();
 }
 
+/// Exports the attached calibration information as a calibration snapshot
+///
+/// For each bin the entries and the X and Y components mean and spread
+/// for each attached harmonic are stored in the snapshot, that is added
+/// to the passed list. If the profile is attached to a snapshot, a copy
+/// of it is added instead.
+/// \param list list where the snapshot should be incorporated
+/// \return kTRUE if the snapshot was exported, kFALSE if nothing is attached
+Bool_t CorrectionProfileComponents::ExportSnapshot(TList *list) {
+  if (fSnapshot!=NULL) {
+    list->Add(fSnapshot->Clone());
+    return kTRUE;
+  }
+  if ((fEntries==NULL) || (fFullFilled==0x0000))
+    return kFALSE;
+
+  Int_t nHighestHarmonic = GetHighestHarmonic(fFullFilled);
+  CorrectionCalibrationSnapshot *snapshot =
+      new CorrectionCalibrationSnapshot(Form("%s%s", GetName(), szSnapshotSuffix),
+                                        Form("%s%s", GetTitle(), szSnapshotSuffix),
+                                        fEntries,
+                                        YComponent(nHighestHarmonic) + 1);
+  snapshot->SetEntries(fEntries);
+  for (Int_t harmonic = 1; harmonic <= nHighestHarmonic; harmonic++) {
+    if (fFullFilled & harmonicNumberMask[harmonic]) {
+      snapshot->SetComponent(XComponent(harmonic), fXValues[harmonic], fEntries);
+      snapshot->SetComponent(YComponent(harmonic), fYValues[harmonic], fEntries);
+    }
+  }
+  snapshot->SetHarmonicMask(fFullFilled);
+  list->Add(snapshot);
+  return kTRUE;
+}
+}
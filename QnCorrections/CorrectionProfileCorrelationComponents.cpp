@@ -177,6 +177,9 @@ Bool_t CorrectionProfileCorrelationComponents::CreateCorrelationComponentsProfil
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
 
+  /* the fill storage: the entries plus the four correlation components */
+  fAccumulator.Allocate(fEntries->GetNbins(), kNoOfComponents);
+
   delete[] minvals;
   delete[] maxvals;
   delete[] nbins;
@@ -193,6 +196,9 @@ Bool_t CorrectionProfileCorrelationComponents::CreateCorrelationComponentsProfil
 /// The harmonic map is inferred from the found histograms within the list
 /// that match the naming scheme.
 ///
+/// If the calibration snapshot of the profile is found in the list it
+/// is attached instead of the histograms.
+///
 /// \param histogramList list where the histograms have to be located
 /// \return true if properly attached else false
 Bool_t CorrectionProfileCorrelationComponents::AttachHistograms(TList *histogramList) {
@@ -221,6 +227,13 @@ Bool_t CorrectionProfileCorrelationComponents::AttachHistograms(TList *histogram
 
   fXXXYYXYYFillMask = 0x0000;
   fFullFilled = 0x0000;
+  fAccumulator.Release();
+
+  /* a calibration snapshot takes precedence over the histograms */
+  if (AttachSnapshot(histogramList)) {
+    fFullFilled = correlationXXmask | correlationXYmask | correlationYXmask | correlationYYmask;
+    return kTRUE;
+  }
 
   fEntries = (THnI *) histogramList->FindObject((const char *) entriesHistoName);
   if (fEntries!=NULL && fEntries->GetEntries()!=0) {
@@ -251,10 +264,27 @@ Bool_t CorrectionProfileCorrelationComponents::AttachHistograms(TList *histogram
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t CorrectionProfileCorrelationComponents::GetBin(const double *variableContainer) {
+  if (fSnapshot!=NULL) {
+    FillBinAxesBins(variableContainer);
+    return fSnapshot->GetBin(fBinAxesBins);
+  }
   FillBinAxesValues(variableContainer);
   return fEntries->GetBin(fBinAxesValues);
 }
 
+/// Get the bin number for the current event class bin
+///
+/// The bin number identifies the event class the current
+/// event class bin points to.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \return the associated bin to the current event class bin
+Long64_t CorrectionProfileCorrelationComponents::GetBin(const Int_t *eventClassBin) {
+  if (fSnapshot!=NULL)
+    return fSnapshot->GetBin(eventClassBin);
+  return fEntries->GetBin(eventClassBin);
+}
+
 /// Check the validity of the content of the passed bin
 /// If the number of entries is lower
 /// than the minimum number of entries to validate it
@@ -263,7 +293,7 @@ Long64_t CorrectionProfileCorrelationComponents::GetBin(const double *variableCo
 /// \param bin the bin to check its content validity
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t CorrectionProfileCorrelationComponents::BinContentValidated(Long64_t bin) {
-  Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
+  Int_t nEntries = (fSnapshot!=NULL) ? fSnapshot->GetBinEntries(bin) : Int_t(fEntries->GetBinContent(bin));
 
   if (nEntries < fMinNoOfEntriesToValidate) {
     return kFALSE;
@@ -283,6 +313,8 @@ Float_t CorrectionProfileCorrelationComponents::GetXXBinContent(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, kXXComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     return fXXValues->GetBinContent(bin)/Float_t(nEntries);
@@ -300,6 +332,8 @@ Float_t CorrectionProfileCorrelationComponents::GetXYBinContent(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, kXYComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     return fXYValues->GetBinContent(bin)/Float_t(nEntries);
@@ -317,6 +351,8 @@ Float_t CorrectionProfileCorrelationComponents::GetYXBinContent(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, kYXComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     return fYXValues->GetBinContent(bin)/Float_t(nEntries);
@@ -334,6 +370,8 @@ Float_t CorrectionProfileCorrelationComponents::GetYYBinContent(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return fSnapshot->GetBinValue(bin, kYYComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     return fYYValues->GetBinContent(bin)/Float_t(nEntries);
@@ -351,6 +389,8 @@ Float_t CorrectionProfileCorrelationComponents::GetXXBinError(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, kXXComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     Float_t values = fXXValues->GetBinContent(bin);
@@ -383,6 +423,8 @@ Float_t CorrectionProfileCorrelationComponents::GetXYBinError(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, kXYComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     Float_t values = fXYValues->GetBinContent(bin);
@@ -415,6 +457,8 @@ Float_t CorrectionProfileCorrelationComponents::GetYXBinError(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, kYXComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     Float_t values = fYXValues->GetBinContent(bin);
@@ -447,6 +491,8 @@ Float_t CorrectionProfileCorrelationComponents::GetYYBinError(Long64_t bin) {
 
   if (!BinContentValidated(bin)) {
     return 0.0;
+  } else if (fSnapshot!=NULL) {
+    return GetSnapshotBinError(bin, kYYComponent);
   } else {
     Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
     Float_t values = fYYValues->GetBinContent(bin);
@@ -471,7 +517,8 @@ Float_t CorrectionProfileCorrelationComponents::GetYYBinError(Long64_t bin) {
 /// Fills the XX correlation component.
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the given weight.
+/// content. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
 /// The entries count is only updated if the whole set for the four components
 /// has been already filled. A check is done for detecting consecutive
 /// fills without a previous entries update.
@@ -487,12 +534,42 @@ void CorrectionProfileCorrelationComponents::FillXX(const double *variableContai
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXXValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXXValues->Fill(fBinAxesValues, weight);
-  fXXValues->SetEntries(nEntries + 1);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
+  fAccumulator.Fill(bin, kXXComponent, weight);
+
+  /* update fill mask */
+  fXXXYYXYYFillMask |= correlationXXmask;
+
+  /* now check if time for updating entries histogram */
+  if (fXXXYYXYYFillMask!=fFullFilled) return;
+  /* update entries and reset the masks */
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
+  fXXXYYXYYFillMask = 0x0000;
+}
+
+/// Fills the XX correlation component.
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
+/// The entries count is only updated if the whole set for the four components
+/// has been already filled. A check is done for detecting consecutive
+/// fills without a previous entries update.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionProfileCorrelationComponents::FillXX(const Int_t *eventClassBin, Float_t weight) {
+  /* first the sanity checks */
+  if (fXXXYYXYYFillMask & correlationXXmask) {
+    QnCorrectionsFatal(Form("Filling twice XX component before entries update in histogram %s.\n" \
+        "   This means you probably have not updated the other components. FIX IT, PLEASE.", GetName()));
+  }
+
+  /* now it's safe to continue */
+
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+  fAccumulator.Fill(bin, kXXComponent, weight);
 
   /* update fill mask */
   fXXXYYXYYFillMask |= correlationXXmask;
@@ -500,14 +577,15 @@ void CorrectionProfileCorrelationComponents::FillXX(const double *variableContai
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask!=fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
 /// Fills the XY correlation component.
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the given weight.
+/// content. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
 /// The entries count is only updated if the whole set for the four components
 /// has been already filled. A check is done for detecting consecutive
 /// fills without a previous entries update.
@@ -523,12 +601,42 @@ void CorrectionProfileCorrelationComponents::FillXY(const double *variableContai
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXYValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXYValues->Fill(fBinAxesValues, weight);
-  fXYValues->SetEntries(nEntries + 1);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
+  fAccumulator.Fill(bin, kXYComponent, weight);
+
+  /* update fill mask */
+  fXXXYYXYYFillMask |= correlationXYmask;
+
+  /* now check if time for updating entries histogram */
+  if (fXXXYYXYYFillMask!=fFullFilled) return;
+  /* update entries and reset the masks */
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
+  fXXXYYXYYFillMask = 0x0000;
+}
+
+/// Fills the XY correlation component.
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
+/// The entries count is only updated if the whole set for the four components
+/// has been already filled. A check is done for detecting consecutive
+/// fills without a previous entries update.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionProfileCorrelationComponents::FillXY(const Int_t *eventClassBin, Float_t weight) {
+  /* first the sanity checks */
+  if (fXXXYYXYYFillMask & correlationXYmask) {
+    QnCorrectionsFatal(Form("Filling twice the XY component before entries update in histogram %s.\n" \
+        "   This means you probably have not updated the other components. FIX IT, PLEASE.", GetName()));
+  }
+
+  /* now it's safe to continue */
+
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+  fAccumulator.Fill(bin, kXYComponent, weight);
 
   /* update fill mask */
   fXXXYYXYYFillMask |= correlationXYmask;
@@ -536,14 +644,15 @@ void CorrectionProfileCorrelationComponents::FillXY(const double *variableContai
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask!=fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
 /// Fills the YX correlation component.
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the given weight.
+/// content. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
 /// The entries count is only updated if the whole set for the four components
 /// has been already filled. A check is done for detecting consecutive
 /// fills without a previous entries update.
@@ -559,12 +668,9 @@ void CorrectionProfileCorrelationComponents::FillYX(const double *variableContai
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYXValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYXValues->Fill(fBinAxesValues, weight);
-  fYXValues->SetEntries(nEntries + 1);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
+  fAccumulator.Fill(bin, kYXComponent, weight);
 
   /* update fill mask */
   fXXXYYXYYFillMask |= correlationYXmask;
@@ -572,14 +678,48 @@ void CorrectionProfileCorrelationComponents::FillYX(const double *variableContai
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask!=fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
+  fXXXYYXYYFillMask = 0x0000;
+}
+
+/// Fills the YX correlation component.
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
+/// The entries count is only updated if the whole set for the four components
+/// has been already filled. A check is done for detecting consecutive
+/// fills without a previous entries update.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionProfileCorrelationComponents::FillYX(const Int_t *eventClassBin, Float_t weight) {
+  /* first the sanity checks */
+  if (fXXXYYXYYFillMask & correlationYXmask) {
+    QnCorrectionsFatal(Form("Filling twice the YX component before entries update in histogram %s.\n" \
+        "   This means you probably have not updated the other components. FIX IT, PLEASE.", GetName()));
+  }
+
+  /* now it's safe to continue */
+
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+  fAccumulator.Fill(bin, kYXComponent, weight);
+
+  /* update fill mask */
+  fXXXYYXYYFillMask |= correlationYXmask;
+
+  /* now check if time for updating entries histogram */
+  if (fXXXYYXYYFillMask!=fFullFilled) return;
+  /* update entries and reset the masks */
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
 /// Fills the YY correlation component.
 ///
 /// The involved bin is computed according to the current variables
-/// content. The bin is then increased by the given weight.
+/// content. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
 /// The entries count is only updated if the whole set for the four components
 /// has been already filled. A check is done for detecting consecutive
 /// fills without a previous entries update.
@@ -595,12 +735,42 @@ void CorrectionProfileCorrelationComponents::FillYY(const double *variableContai
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYYValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYYValues->Fill(fBinAxesValues, weight);
-  fYYValues->SetEntries(nEntries + 1);
+  Long64_t bin = fEntries->GetBin(fBinAxesValues);
+  fAccumulator.Fill(bin, kYYComponent, weight);
+
+  /* update harmonic fill mask */
+  fXXXYYXYYFillMask |= correlationYYmask;
+
+  /* now check if time for updating entries histogram */
+  if (fXXXYYXYYFillMask!=fFullFilled) return;
+  /* update entries and reset the masks */
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
+  fXXXYYXYYFillMask = 0x0000;
+}
+
+/// Fills the YY correlation component.
+///
+/// The involved bin is computed according to the current event class
+/// bin. The bin is then increased by the given weight in the
+/// fill storage, transferred to the histograms by FlushFills.
+/// The entries count is only updated if the whole set for the four components
+/// has been already filled. A check is done for detecting consecutive
+/// fills without a previous entries update.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param weight the increment in the bin content
+void CorrectionProfileCorrelationComponents::FillYY(const Int_t *eventClassBin, Float_t weight) {
+  /* first the sanity checks */
+  if (fXXXYYXYYFillMask & correlationYYmask) {
+    QnCorrectionsFatal(Form("Filling twice the YY component before entries update in histogram %s.\n" \
+        "   This means you probably have not updated the other components. FIX IT, PLEASE.", GetName()));
+  }
+
+  /* now it's safe to continue */
+
+  Long64_t bin = fEntries->GetBin(eventClassBin);
+  fAccumulator.Fill(bin, kYYComponent, weight);
 
   /* update harmonic fill mask */
   fXXXYYXYYFillMask |= correlationYYmask;
@@ -608,8 +778,53 @@ void CorrectionProfileCorrelationComponents::FillYY(const double *variableContai
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask!=fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  fAccumulator.Fill(bin, kEntriesComponent, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
+
+/// Transfers the content of the fill storage to the histograms
+///
+/// The four correlation components and the entries are added to
+/// their histograms and the fill storage is cleared. Nothing is
+/// done if there are no pending fills.
+void CorrectionProfileCorrelationComponents::FlushFills() {
+  if (!fAccumulator.IsPending()) return;
+
+  fAccumulator.Flush(kXXComponent, fXXValues);
+  fAccumulator.Flush(kXYComponent, fXYValues);
+  fAccumulator.Flush(kYXComponent, fYXValues);
+  fAccumulator.Flush(kYYComponent, fYYValues);
+  fAccumulator.Flush(kEntriesComponent, fEntries);
+  fAccumulator.Reset();
 }
 
+/// Exports the attached calibration information as a calibration snapshot
+///
+/// For each bin the entries and the four correlation components mean
+/// and spread are stored in the snapshot, that is added to the passed
+/// list. If the profile is attached to a snapshot, a copy of it is
+/// added instead.
+/// \param list list where the snapshot should be incorporated
+/// \return kTRUE if the snapshot was exported, kFALSE if nothing is attached
+Bool_t CorrectionProfileCorrelationComponents::ExportSnapshot(TList *list) {
+  if (fSnapshot!=NULL) {
+    list->Add(fSnapshot->Clone());
+    return kTRUE;
+  }
+  if ((fEntries==NULL) || (fFullFilled==0x0000))
+    return kFALSE;
+
+  CorrectionCalibrationSnapshot *snapshot =
+      new CorrectionCalibrationSnapshot(Form("%s%s", GetName(), szSnapshotSuffix),
+                                        Form("%s%s", GetTitle(), szSnapshotSuffix),
+                                        fEntries,
+                                        kNoOfComponents);
+  snapshot->SetEntries(fEntries);
+  snapshot->SetComponent(kXXComponent, fXXValues, fEntries);
+  snapshot->SetComponent(kXYComponent, fXYValues, fEntries);
+  snapshot->SetComponent(kYXComponent, fYXValues, fEntries);
+  snapshot->SetComponent(kYYComponent, fYYValues, fEntries);
+  list->Add(snapshot);
+  return kTRUE;
+}
+}
@@ -35,6 +35,7 @@
 #include <Riostream.h>
 
 #include "CorrectionQnVectorBuild.h"
+#include "CorrectionQnVectorSums.h"
 #include "CorrectionLog.h"
 
 using std::cout;
@@ -132,6 +133,99 @@ void CorrectionQnVectorBuild::Add(CorrectionQnVectorBuild *Qn) {
   fN += Qn->GetN();
 }
 
+/// Adds the contributions already accumulated in a set of raw sums
+///
+/// Each harmonic takes the sums of its multiple by the harmonic
+/// multiplier. A run time error is raised if the sums do not keep
+/// the highest multiple needed.
+/// \param sums the raw sums of the contributions
+void CorrectionQnVectorBuild::Add(const CorrectionQnVectorSums &sums) {
+
+  if (sums.GetHighestMultiple() < fHighestHarmonic*fHarmonicMultiplier) {
+    QnCorrectionsFatal(Form("You requested to add to a Q vector raw sums up to the harmonic multiple %d " \
+        "while the Q vector needs up to %d", sums.GetHighestMultiple(), fHighestHarmonic*fHarmonicMultiplier));
+    return;
+  }
+
+  for (Int_t h = 1; h < fHighestHarmonic + 1; h++) {
+    if ((fHarmonicMask & harmonicNumberMask[h])==harmonicNumberMask[h]) {
+      fQnX[h] += sums.Cos(h*fHarmonicMultiplier);
+      fQnY[h] += sums.Sin(h*fHarmonicMultiplier);
+    }
+  }
+  fSumW += sums.GetSumOfWeights();
+  fN += sums.GetN();
+}
+
+/// Adds a batch of contributions to the build Q vector
+///
+/// Equivalent to calling Add(phi, weight) for each entry but only
+/// one sine and cosine are evaluated per entry. The higher harmonics
+/// are obtained by complex multiplication, i.e. the Chebyshev recurrence
+/// cos((h+1)x) + i sin((h+1)x) = (cos(hx) + i sin(hx)) (cos(x) + i sin(x)).
+/// Entries are processed in blocks of nBuildLanes independent lanes
+/// which allows the compiler to vectorise the harmonics loop.
+/// Entries with weight below the significant value are ignored.
+/// \param nEntries the number of contributions
+/// \param phi the azimuthal angle of each contribution
+/// \param weight the weight of each contribution
+void CorrectionQnVectorBuild::Add(Int_t nEntries, const Float_t *phi, const Float_t *weight) {
+  Double_t qx[MAXHARMONICNUMBERSUPPORTED + 1][nBuildLanes] = {};
+  Double_t qy[MAXHARMONICNUMBERSUPPORTED + 1][nBuildLanes] = {};
+  Double_t w[nBuildLanes];
+  Double_t c1[nBuildLanes];
+  Double_t s1[nBuildLanes];
+  Double_t cn[nBuildLanes];
+  Double_t sn[nBuildLanes];
+
+  for (Int_t first = 0; first < nEntries; first += nBuildLanes) {
+    for (Int_t lane = 0; lane < nBuildLanes; lane++) {
+      Int_t entry = first + lane;
+      if (entry < nEntries && !(weight[entry] < fMinimumSignificantValue)) {
+        Double_t angle = fHarmonicMultiplier*static_cast<Double_t>(phi[entry]);
+        w[lane] = weight[entry];
+        c1[lane] = TMath::Cos(angle);
+        s1[lane] = TMath::Sin(angle);
+        fSumW += weight[entry];
+        fN += 1;
+      } else {
+        w[lane] = 0.0;
+        c1[lane] = 1.0;
+        s1[lane] = 0.0;
+      }
+      cn[lane] = c1[lane];
+      sn[lane] = s1[lane];
+    }
+    for (Int_t h = 1; h < fHighestHarmonic + 1; h++) {
+      if (h > 1) {
+        for (Int_t lane = 0; lane < nBuildLanes; lane++) {
+          Double_t c = cn[lane]*c1[lane] - sn[lane]*s1[lane];
+          sn[lane] = sn[lane]*c1[lane] + cn[lane]*s1[lane];
+          cn[lane] = c;
+        }
+      }
+      if ((fHarmonicMask & harmonicNumberMask[h])==harmonicNumberMask[h]) {
+        for (Int_t lane = 0; lane < nBuildLanes; lane++) {
+          qx[h][lane] += w[lane]*cn[lane];
+          qy[h][lane] += w[lane]*sn[lane];
+        }
+      }
+    }
+  }
+  for (Int_t h = 1; h < fHighestHarmonic + 1; h++) {
+    if ((fHarmonicMask & harmonicNumberMask[h])==harmonicNumberMask[h]) {
+      Double_t sumX = 0.0;
+      Double_t sumY = 0.0;
+      for (Int_t lane = 0; lane < nBuildLanes; lane++) {
+        sumX += qx[h][lane];
+        sumY += qy[h][lane];
+      }
+      fQnX[h] += sumX;
+      fQnY[h] += sumY;
+    }
+  }
+}
+
 /// Normalizes the build Q vector for the whole harmonics set
 ///
 /// Normalizes the build Q vector as \f$ Qn = \frac{Qn}{M} \f$.
@@ -153,4 +153,46 @@ void DetectorConfiguration::ActivateHarmonic(Int_t harmonic) {
   fTempQ2nVector.ActivateHarmonic(harmonic);
 }
 
+/// New set of data vectors for the detector configuration
+///
+/// Default behavior: each data vector is passed in turn to AddDataVector
+/// \param variableContainer pointer to the variable content bank
+/// \param nData the number of data vectors
+/// \param phi the azimuthal angles of the data vectors
+/// \param weight the weights of the data vectors
+/// \param id the Id shared by the data vectors. If negative each data vector gets its position as Id.
+/// \return kTRUE if any of the data vectors was accepted and stored
+Bool_t DetectorConfiguration::AddDataVectors(const double *variableContainer,
+                                             Int_t nData,
+                                             const Float_t *phi,
+                                             const Float_t *weight,
+                                             Int_t id) {
+  Bool_t accepted = kFALSE;
+  for (Int_t ixData = 0; ixData < nData; ixData++) {
+    if (AddDataVector(variableContainer, phi[ixData], weight[ixData], (id < 0) ? ixData : id))
+      accepted = kTRUE;
+  }
+  return accepted;
+}
+
+/// New raw Q vector sums for the detector configuration
+///
+/// Default behavior: the detector configuration needs the individual data
+/// vectors, raise a run time error
+/// \param variableContainer pointer to the variable content bank
+/// \param sums the raw sums of the data vectors
+/// \param id the Id shared by the data vectors
+/// \return kTRUE if the sums were accepted
+Bool_t DetectorConfiguration::AddQnVectorSums(const double *variableContainer,
+                                              const CorrectionQnVectorSums *sums,
+                                              Int_t id) {
+  (void) variableContainer;
+  (void) sums;
+  (void) id;
+  QnCorrectionsFatal(Form("You have reached base member %s. This means the detector configuration %s " \
+      "does not support raw Q vector sums as input. FIX IT, PLEASE.",
+                          "DetectorConfiguration::AddQnVectorSums()", GetName()));
+  return kFALSE;
+}
+
 }
@@ -32,6 +32,8 @@
 /// \file QnCorrectionsDetectorConfigurationChannels.cxx
 /// \brief Implementation of the channel detector configuration class 
 
+#include <limits>
+
 #include "CorrectionProfileComponents.h"
 #include "DetectorConfigurationChannels.h"
 #include "CorrectionLog.h"
@@ -53,6 +55,10 @@ DetectorConfigurationChannels::DetectorConfigurationChannels() :
   fChannelMap = NULL;
   fChannelGroup = NULL;
   fHardCodedGroupWeights = NULL;
+  fChannelPhi = NULL;
+  fChannelCos = NULL;
+  fChannelSin = NULL;
+  fChannelWeights = NULL;
   /* QA section */
   fQACentralityVarId = -1;
   fQAnBinsMultiplicity = 100;
@@ -83,6 +89,10 @@ DetectorConfigurationChannels::DetectorConfigurationChannels(const char *name,
   fChannelMap = NULL;
   fChannelGroup = NULL;
   fHardCodedGroupWeights = NULL;
+  fChannelPhi = NULL;
+  fChannelCos = NULL;
+  fChannelSin = NULL;
+  fChannelWeights = NULL;
   /* QA section */
   fQACentralityVarId = -1;
   fQAnBinsMultiplicity = 100;
@@ -101,6 +111,10 @@ DetectorConfigurationChannels::~DetectorConfigurationChannels() {
   if (fChannelMap!=NULL) delete[] fChannelMap;
   if (fChannelGroup!=NULL) delete[] fChannelGroup;
   if (fHardCodedGroupWeights!=NULL) delete[] fHardCodedGroupWeights;
+  if (fChannelPhi!=NULL) delete[] fChannelPhi;
+  if (fChannelCos!=NULL) delete[] fChannelCos;
+  if (fChannelSin!=NULL) delete[] fChannelSin;
+  if (fChannelWeights!=NULL) delete[] fChannelWeights;
   if (fQAQnAverageHistogram!=NULL) delete fQAQnAverageHistogram;
 }
 
@@ -189,6 +203,16 @@ void DetectorConfigurationChannels::CreateSupportDataStructures() {
   /* this is executed in the remote node so, allocate the data bank */
   fDataVectorBank = new TClonesArray("Qn::CorrectionDataVectorChannelized", INITIALDATAVECTORBANKSIZE);
 
+  /* and the channels harmonic tables, built the first time each channel gets data */
+  fChannelPhi = new Float_t[fNoOfChannels];
+  fChannelCos = new Double_t[nHarmonicTableSize*fNoOfChannels];
+  fChannelSin = new Double_t[nHarmonicTableSize*fNoOfChannels];
+  fChannelWeights = new Double_t[fNoOfChannels];
+  for (Int_t ixChannel = 0; ixChannel < fNoOfChannels; ixChannel++) {
+    fChannelPhi[ixChannel] = std::numeric_limits<Float_t>::quiet_NaN();
+    fChannelWeights[ixChannel] = 0.0;
+  }
+
   for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
     fInputDataCorrections.At(ixCorrection)->CreateSupportDataStructures();
   }
@@ -443,6 +467,8 @@ void DetectorConfigurationChannels::AddCorrectionOnInputData(CorrectionOnInputDa
 /// and the plain Qn vector average components histogram
 /// \param variableContainer pointer to the variable content bank
 void DetectorConfigurationChannels::FillQAHistograms(const double *variableContainer) {
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fEventClassVariables->GetEventClassBin();
   if (fQAMultiplicityBefore3D!=NULL && fQAMultiplicityAfter3D!=NULL) {
     for (Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++) {
       CorrectionDataVectorChannelized *dataVector =
@@ -458,8 +484,8 @@ void DetectorConfigurationChannels::FillQAHistograms(const double *variableConta
   if (fQAQnAverageHistogram!=NULL) {
     Int_t harmonic = fPlainQnVector.GetFirstHarmonic();
     while (harmonic!=-1) {
-      fQAQnAverageHistogram->FillX(harmonic, variableContainer, fPlainQnVector.Qx(harmonic));
-      fQAQnAverageHistogram->FillY(harmonic, variableContainer, fPlainQnVector.Qy(harmonic));
+      fQAQnAverageHistogram->FillX(harmonic, eventClassBin, fPlainQnVector.Qx(harmonic));
+      fQAQnAverageHistogram->FillY(harmonic, eventClassBin, fPlainQnVector.Qy(harmonic));
       harmonic = fPlainQnVector.GetNextHarmonic(harmonic);
     }
   }
@@ -567,4 +593,74 @@ void DetectorConfigurationChannels::ReportOnCorrections(TList *steps, TList *cal
   calib->Add(mycalib);
   apply->Add(myapply);
 }
+
+/// Transfers the pending fills of the configuration histograms
+///
+/// The request is transmitted to the QA histograms, to the input
+/// data correction steps and to the Qn vector correction steps
+void DetectorConfigurationChannels::FlushHistogramFills() {
+  if (fQAQnAverageHistogram!=NULL)
+    fQAQnAverageHistogram->FlushFills();
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
+    fInputDataCorrections.At(ixCorrection)->FlushHistogramFills();
+  }
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->FlushHistogramFills();
+  }
+}
+
+/// Exports the attached input calibration information as calibration snapshots
+///
+/// The snapshots are collected in a list named after the detector
+/// configuration, the same structure the calibration histograms have,
+/// which is incorporated to the passed list if not empty.
+/// The request is transmitted to the input data correction steps
+/// and to the Q vector correction steps
+/// \param list list where the detector configuration snapshots list should be incorporated
+void DetectorConfigurationChannels::ExportCalibrationSnapshot(TList *list) {
+  TList *detectorConfigurationList = new TList();
+  detectorConfigurationList->SetName(this->GetName());
+  detectorConfigurationList->SetOwner(kTRUE);
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
+    fInputDataCorrections.At(ixCorrection)->ExportCalibrationSnapshot(detectorConfigurationList);
+  }
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->ExportCalibrationSnapshot(detectorConfigurationList);
+  }
+  if (detectorConfigurationList->GetEntries()!=0)
+    list->Add(detectorConfigurationList);
+  else
+    delete detectorConfigurationList;
+}
+
+/// Prepares calibration snapshots from the passed input calibration information
+///
+/// The input calibration list of the detector configuration is located in the
+/// passed source list and the snapshots are collected in a list named after
+/// the detector configuration which is incorporated to the passed list if not empty.
+/// The request is transmitted to the input data correction steps
+/// and to the Q vector correction steps
+/// \param source list where the detector configuration input calibration list should be found
+/// \param list list where the detector configuration snapshots list should be incorporated
+void DetectorConfigurationChannels::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  TList *detectorConfigurationSource = (TList *) source->FindObject(this->GetName());
+  if (detectorConfigurationSource==NULL)
+    return;
+
+  TList *detectorConfigurationList = new TList();
+  detectorConfigurationList->SetName(this->GetName());
+  detectorConfigurationList->SetOwner(kTRUE);
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
+    fInputDataCorrections.At(ixCorrection)->PrepareCalibrationSnapshot(detectorConfigurationSource,
+                                                                       detectorConfigurationList);
+  }
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->PrepareCalibrationSnapshot(detectorConfigurationSource,
+                                                                      detectorConfigurationList);
+  }
+  if (detectorConfigurationList->GetEntries()!=0)
+    list->Add(detectorConfigurationList);
+  else
+    delete detectorConfigurationList;
+}
 }
@@ -32,6 +32,8 @@
 /// \file QnCorrectionsDetectorConfigurationTracks.cxx
 /// \brief Implementation of the track detector configuration class
 
+#include <algorithm>
+
 #include "CorrectionProfileComponents.h"
 #include "DetectorConfigurationTracks.h"
 #include "CorrectionLog.h"
@@ -46,6 +48,9 @@ const char *DetectorConfigurationTracks::szQAQnAverageHistogramName = "Plain Qn
 DetectorConfigurationTracks::DetectorConfigurationTracks() : DetectorConfiguration() {
 
   fQAQnAverageHistogram = NULL;
+  fNoOfBins = 0;
+  fBinVariable = NULL;
+  fBinQnVectorLists.SetOwner(kTRUE);
 }
 
 /// Normal constructor
@@ -61,6 +66,9 @@ DetectorConfigurationTracks::DetectorConfigurationTracks(const char *name,
     DetectorConfiguration(name, eventClassesVariables, nNoOfHarmonics, harmonicMap) {
 
   fQAQnAverageHistogram = NULL;
+  fNoOfBins = 0;
+  fBinVariable = NULL;
+  fBinQnVectorLists.SetOwner(kTRUE);
 }
 
 /// Default destructor
@@ -223,12 +231,15 @@ void DetectorConfigurationTracks::AfterInputsAttachActions() {
 /// Fills the QA plain Qn vector average components histogram
 /// \param variableContainer pointer to the variable content bank
 void DetectorConfigurationTracks::FillQAHistograms(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fEventClassVariables->GetEventClassBin();
 
   if (fQAQnAverageHistogram!=NULL) {
     Int_t harmonic = fPlainQnVector.GetFirstHarmonic();
     while (harmonic!=-1) {
-      fQAQnAverageHistogram->FillX(harmonic, variableContainer, fPlainQnVector.Qx(harmonic));
-      fQAQnAverageHistogram->FillY(harmonic, variableContainer, fPlainQnVector.Qy(harmonic));
+      fQAQnAverageHistogram->FillX(harmonic, eventClassBin, fPlainQnVector.Qx(harmonic));
+      fQAQnAverageHistogram->FillY(harmonic, eventClassBin, fPlainQnVector.Qy(harmonic));
       harmonic = fPlainQnVector.GetNextHarmonic(harmonic);
     }
   }
@@ -270,6 +281,141 @@ void DetectorConfigurationTracks::IncludeQnVectors(TList *list) {
   }
   if (!bAlreadyThere)
     list->Add(detectorConfigurationList);
+
+  if (fNoOfBins > 0)
+    IncludeBinQnVectors(list);
+}
+
+/// Include the lists of the Qn vectors of each bin into the passed list
+///
+/// The Qn vectors of each bin are copies of the Qn vectors of the
+/// detector configuration. They are updated once the bin has been
+/// processed. The list of each bin is named as the detector configuration
+/// followed by the bin number.
+/// \param list list where the Qn vectors lists should be added
+void DetectorConfigurationTracks::IncludeBinQnVectors(TList *list) {
+
+  /* the bin Qn vectors are only created once */
+  if (fBinQnVectorLists.GetEntriesFast()==0) {
+    fBinLiveQnVectors.Add(&fCorrectedQnVector);
+    fBinLiveQnVectors.Add(&fPlainQnVector);
+    for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+      fQnVectorCorrections.At(ixCorrection)->IncludeCorrectedQnVector(&fBinLiveQnVectors);
+    }
+    for (Int_t ixBin = 0; ixBin < fNoOfBins; ixBin++) {
+      TList *binList = new TList();
+      binList->SetName(Form("%s%d", this->GetName(), ixBin));
+      binList->SetOwner(kTRUE);
+      TIter next(&fBinLiveQnVectors);
+      while (TObject *qnVector = next()) {
+        binList->Add(new CorrectionQnVector(*static_cast<CorrectionQnVector *>(qnVector)));
+      }
+      fBinQnVectorLists.Add(binList);
+    }
+  }
+  for (Int_t ixBin = 0; ixBin < fNoOfBins; ixBin++) {
+    TObject *binList = fBinQnVectorLists.At(ixBin);
+    if (list->FindObject(binList->GetName())==NULL)
+      list->Add(binList);
+  }
+}
+
+/// Configures the detector configuration for building one Qn vector per bin
+///
+/// The id of each data vector is taken as its bin. At data collection time
+/// the bins are processed in turn, storing the bin number in the passed
+/// variable bank slot. An event class variable associated to that slot
+/// makes the bin an extra axis of the correction histograms.
+/// \param nNoOfBins the number of bins
+/// \param binVariable pointer to the variable bank slot which holds the bin
+void DetectorConfigurationTracks::SetDifferentialBins(Int_t nNoOfBins, Double_t *binVariable) {
+  fNoOfBins = nNoOfBins;
+  fBinVariable = binVariable;
+  fBinOffsets.resize(nNoOfBins + 1);
+}
+
+/// Process the corrections and the data collection of each bin in turn
+///
+/// The data vectors are sorted by bin, the ones handed in bulk, or as
+/// raw Q vector sums, are kept in place and only their sets are sorted. For each bin its number is stored
+/// in the variable bank, its Qn vectors are built, the Q vector correction
+/// steps are processed and the resulting Qn vectors are stored.
+/// \param variableContainer pointer to the variable content bank
+/// \return kTRUE if all correction steps were applied for all bins
+Bool_t DetectorConfigurationTracks::ProcessBinnedDataCollection(const double *variableContainer) {
+
+  /* sort the data vectors by bin */
+  Int_t nData = fDataVectorBank->GetEntriesFast();
+  fPhiBuffer.resize(nData);
+  fWeightBuffer.resize(nData);
+  std::fill(fBinOffsets.begin(), fBinOffsets.end(), 0);
+  for (Int_t ixData = 0; ixData < nData; ixData++) {
+    fBinOffsets[static_cast<CorrectionDataVector *>(fDataVectorBank->At(ixData))->GetId() + 1]++;
+  }
+  for (Int_t ixBin = 0; ixBin < fNoOfBins; ixBin++) {
+    fBinOffsets[ixBin + 1] += fBinOffsets[ixBin];
+  }
+  fBinPositions.assign(fBinOffsets.begin(), fBinOffsets.end() - 1);
+  for (Int_t ixData = 0; ixData < nData; ixData++) {
+    CorrectionDataVector *dataVector = static_cast<CorrectionDataVector *>(fDataVectorBank->At(ixData));
+    Int_t position = fBinPositions[dataVector->GetId()]++;
+    fPhiBuffer[position] = dataVector->Phi();
+    fWeightBuffer[position] = dataVector->Weight();
+  }
+  std::stable_sort(fDataVectorSpans.begin(), fDataVectorSpans.end(),
+                   [](const DataVectorSpan &a, const DataVectorSpan &b) { return a.fId < b.fId; });
+  auto nextSpan = fDataVectorSpans.begin();
+
+  Bool_t retValue = kTRUE;
+  for (Int_t ixBin = 0; ixBin < fNoOfBins; ixBin++) {
+    *fBinVariable = ixBin;
+    fEventClassVariables->UpdateEventClassBin(variableContainer);
+    ClearQnVectors();
+    fBuildSpans.clear();
+    if (fBinOffsets[ixBin + 1] > fBinOffsets[ixBin]) {
+      fBuildSpans.push_back({fBinOffsets[ixBin + 1] - fBinOffsets[ixBin],
+                             fPhiBuffer.data() + fBinOffsets[ixBin],
+                             fWeightBuffer.data() + fBinOffsets[ixBin],
+                             ixBin,
+                             nullptr});
+    }
+    /* sets of data vectors out of the bins range are ignored */
+    while (nextSpan!=fDataVectorSpans.end() && nextSpan->fId < ixBin) ++nextSpan;
+    while (nextSpan!=fDataVectorSpans.end() && nextSpan->fId==ixBin) {
+      fBuildSpans.push_back(*nextSpan);
+      ++nextSpan;
+    }
+    BuildQnVector(Int_t(fBuildSpans.size()), fBuildSpans.data());
+
+    /* the loops are broken when a correction step has not been applied */
+    Bool_t binValue = kTRUE;
+    for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+      if (!fQnVectorCorrections.At(ixCorrection)->ProcessCorrections(variableContainer)) {
+        binValue = kFALSE;
+        break;
+      }
+    }
+    FillQAHistograms(variableContainer);
+    for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+      if (!fQnVectorCorrections.At(ixCorrection)->ProcessDataCollection(variableContainer)) {
+        binValue = kFALSE;
+        break;
+      }
+    }
+    StoreBinQnVectors(ixBin);
+    retValue = retValue && binValue;
+  }
+  return retValue;
+}
+
+/// Stores the current Qn vectors as the ones of the passed bin
+/// \param bin the bin number
+void DetectorConfigurationTracks::StoreBinQnVectors(Int_t bin) {
+  TIter nextLive(&fBinLiveQnVectors);
+  TIter nextStored(static_cast<TList *>(fBinQnVectorLists.At(bin)));
+  while (TObject *qnVector = nextLive()) {
+    static_cast<CorrectionQnVector *>(nextStored())->Set(static_cast<CorrectionQnVector *>(qnVector), kTRUE);
+  }
 }
 
 /// Include only one instance of each input correction step
@@ -324,4 +470,61 @@ void DetectorConfigurationTracks::ReportOnCorrections(TList *steps, TList *calib
   apply->Add(myapply);
 }
 
-}
\ No newline at end of file
+/// Transfers the pending fills of the configuration histograms
+///
+/// The request is transmitted to the QA histograms and to the
+/// Qn vector correction steps
+void DetectorConfigurationTracks::FlushHistogramFills() {
+  if (fQAQnAverageHistogram!=NULL)
+    fQAQnAverageHistogram->FlushFills();
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->FlushHistogramFills();
+  }
+}
+
+/// Exports the attached input calibration information as calibration snapshots
+///
+/// The snapshots are collected in a list named after the detector
+/// configuration, the same structure the calibration histograms have,
+/// which is incorporated to the passed list if not empty.
+/// The request is transmitted to the Q vector correction steps
+/// \param list list where the detector configuration snapshots list should be incorporated
+void DetectorConfigurationTracks::ExportCalibrationSnapshot(TList *list) {
+  TList *detectorConfigurationList = new TList();
+  detectorConfigurationList->SetName(this->GetName());
+  detectorConfigurationList->SetOwner(kTRUE);
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->ExportCalibrationSnapshot(detectorConfigurationList);
+  }
+  if (detectorConfigurationList->GetEntries()!=0)
+    list->Add(detectorConfigurationList);
+  else
+    delete detectorConfigurationList;
+}
+
+/// Prepares calibration snapshots from the passed input calibration information
+///
+/// The input calibration list of the detector configuration is located in the
+/// passed source list and the snapshots are collected in a list named after
+/// the detector configuration which is incorporated to the passed list if not empty.
+/// The request is transmitted to the Q vector correction steps
+/// \param source list where the detector configuration input calibration list should be found
+/// \param list list where the detector configuration snapshots list should be incorporated
+void DetectorConfigurationTracks::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  TList *detectorConfigurationSource = (TList *) source->FindObject(this->GetName());
+  if (detectorConfigurationSource==NULL)
+    return;
+
+  TList *detectorConfigurationList = new TList();
+  detectorConfigurationList->SetName(this->GetName());
+  detectorConfigurationList->SetOwner(kTRUE);
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->PrepareCalibrationSnapshot(detectorConfigurationSource,
+                                                                      detectorConfigurationList);
+  }
+  if (detectorConfigurationList->GetEntries()!=0)
+    list->Add(detectorConfigurationList);
+  else
+    delete detectorConfigurationList;
+}
+}
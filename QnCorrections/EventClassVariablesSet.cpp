@@ -55,4 +55,17 @@ void EventClassVariablesSet::GetMultidimensionalConfiguration(Int_t *nbins,
   }
 }
 
+/// Locates the current event within the event class variables bins
+///
+/// Stores, for each of the variables in the set, the bin number the
+/// current event falls in. Intended to be called once per event so
+/// that the correction steps and histograms sharing the set do not
+/// have to look up the bins again.
+/// \param variableContainer pointer to the variable content bank
+void EventClassVariablesSet::UpdateEventClassBin(const double *variableContainer) {
+  fEventClassBin.resize(GetEntriesFast());
+  for (Int_t var = 0; var < GetEntriesFast(); var++) {
+    fEventClassBin[var] = At(var)->FindBin(variableContainer[At(var)->GetVariableId()]);
+  }
+}
 }
\ No newline at end of file
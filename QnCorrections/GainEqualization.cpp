@@ -215,13 +215,16 @@ Bool_t GainEqualization::CreateNveQAHistograms(TList *list) {
 /// structures should be included.
 /// \return kTRUE if the correction step was applied
 Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   switch (fState) {
     case QCORRSTEP_calibration:
       /* collect the data needed to further produce equalization parameters */
       for (Int_t ixData = 0; ixData < fDetectorConfiguration->GetInputDataBank()->GetEntriesFast(); ixData++) {
         CorrectionDataVectorChannelized *dataVector =
             static_cast<CorrectionDataVectorChannelized *>(fDetectorConfiguration->GetInputDataBank()->At(ixData));
-        fCalibrationHistograms->Fill(variableContainer, dataVector->GetId(), dataVector->EqualizedWeight());
+        fCalibrationHistograms->Fill(eventClassBin, dataVector->GetId(), dataVector->EqualizedWeight());
       }
       return kFALSE;
       break;
@@ -230,7 +233,7 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
       for (Int_t ixData = 0; ixData < fDetectorConfiguration->GetInputDataBank()->GetEntriesFast(); ixData++) {
         CorrectionDataVectorChannelized *dataVector =
             static_cast<CorrectionDataVectorChannelized *>(fDetectorConfiguration->GetInputDataBank()->At(ixData));
-        fCalibrationHistograms->Fill(variableContainer, dataVector->GetId(), dataVector->EqualizedWeight());
+        fCalibrationHistograms->Fill(eventClassBin, dataVector->GetId(), dataVector->EqualizedWeight());
       }
       /* and proceed to ... */
       /* FALLTHRU */
@@ -240,7 +243,7 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
         for (Int_t ixData = 0; ixData < fDetectorConfiguration->GetInputDataBank()->GetEntriesFast(); ixData++) {
           CorrectionDataVectorChannelized *dataVector =
               static_cast<CorrectionDataVectorChannelized *>(fDetectorConfiguration->GetInputDataBank()->At(ixData));
-          fQAMultiplicityBefore->Fill(variableContainer, dataVector->GetId(), dataVector->EqualizedWeight());
+          fQAMultiplicityBefore->Fill(eventClassBin, dataVector->GetId(), dataVector->EqualizedWeight());
         }
       }
       /* store the equalized weights in the data vector bank according to equalization method */
@@ -256,13 +259,13 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
           for (Int_t ixData = 0; ixData < fDetectorConfiguration->GetInputDataBank()->GetEntriesFast(); ixData++) {
             CorrectionDataVectorChannelized *dataVector =
                 static_cast<CorrectionDataVectorChannelized *>(fDetectorConfiguration->GetInputDataBank()->At(ixData));
-            Long64_t bin = fInputHistograms->GetBin(variableContainer, dataVector->GetId());
+            Long64_t bin = fInputHistograms->GetBin(eventClassBin, dataVector->GetId());
             if (fInputHistograms->BinContentValidated(bin)) {
               Float_t average = fInputHistograms->GetBinContent(bin);
               /* let's handle the potential group weights usage */
               Float_t groupweight = 1.0;
               if (fUseChannelGroupsWeights) {
-                groupweight = fInputHistograms->GetGrpBinContent(fInputHistograms->GetGrpBin(variableContainer,
+                groupweight = fInputHistograms->GetGrpBinContent(fInputHistograms->GetGrpBin(eventClassBin,
                                                                                              dataVector->GetId()));
               } else {
                 if (fHardCodedWeights!=NULL) {
@@ -274,7 +277,7 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
               else
                 dataVector->SetEqualizedWeight(0.0);
             } else {
-              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(variableContainer, dataVector->GetId(), 1.0);
+              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(eventClassBin, dataVector->GetId(), 1.0);
             }
           }
           break;
@@ -282,16 +285,16 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
           for (Int_t ixData = 0; ixData < fDetectorConfiguration->GetInputDataBank()->GetEntriesFast(); ixData++) {
             CorrectionDataVectorChannelized *dataVector =
                 static_cast<CorrectionDataVectorChannelized *>(fDetectorConfiguration->GetInputDataBank()->At(ixData));
-            Long64_t bin = fInputHistograms->GetBin(variableContainer, dataVector->GetId());
+            Long64_t bin = fInputHistograms->GetBin(eventClassBin, dataVector->GetId());
             if (fInputHistograms->BinContentValidated(bin)) {
               Float_t average =
-                  fInputHistograms->GetBinContent(fInputHistograms->GetBin(variableContainer, dataVector->GetId()));
+                  fInputHistograms->GetBinContent(fInputHistograms->GetBin(eventClassBin, dataVector->GetId()));
               Float_t width =
-                  fInputHistograms->GetBinError(fInputHistograms->GetBin(variableContainer, dataVector->GetId()));
+                  fInputHistograms->GetBinError(fInputHistograms->GetBin(eventClassBin, dataVector->GetId()));
               /* let's handle the potential group weights usage */
               Float_t groupweight = 1.0;
               if (fUseChannelGroupsWeights) {
-                groupweight = fInputHistograms->GetGrpBinContent(fInputHistograms->GetGrpBin(variableContainer,
+                groupweight = fInputHistograms->GetGrpBinContent(fInputHistograms->GetGrpBin(eventClassBin,
                                                                                              dataVector->GetId()));
               } else {
                 if (fHardCodedWeights!=NULL) {
@@ -304,7 +307,7 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
               else
                 dataVector->SetEqualizedWeight(0.0);
             } else {
-              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(variableContainer, dataVector->GetId(), 1.0);
+              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(eventClassBin, dataVector->GetId(), 1.0);
             }
           }
           break;
@@ -314,7 +317,7 @@ Bool_t GainEqualization::ProcessCorrections(const double *variableContainer) {
         for (Int_t ixData = 0; ixData < fDetectorConfiguration->GetInputDataBank()->GetEntriesFast(); ixData++) {
           CorrectionDataVectorChannelized *dataVector =
               static_cast<CorrectionDataVectorChannelized *>(fDetectorConfiguration->GetInputDataBank()->At(ixData));
-          fQAMultiplicityAfter->Fill(variableContainer, dataVector->GetId(), dataVector->EqualizedWeight());
+          fQAMultiplicityAfter->Fill(eventClassBin, dataVector->GetId(), dataVector->EqualizedWeight());
         }
       }
       break;
@@ -381,4 +384,37 @@ Bool_t GainEqualization::ReportUsage(TList *calibrationList, TList *applyList) {
   }
   return kTRUE;
 }
+
+/// Exports the attached input calibration information as calibration snapshots
+///
+/// The request is transmitted to the input histograms
+/// \param list list where the snapshots should be incorporated
+void GainEqualization::ExportCalibrationSnapshot(TList *list) {
+  if (fInputHistograms!=NULL)
+    fInputHistograms->ExportSnapshot(list);
+}
+
+/// Prepares calibration snapshots from the passed input calibration information
+///
+/// Scratch input histograms, equal to the ones of the correction step,
+/// are attached to the passed list and exported
+/// \param source list where the input calibration information should be found
+/// \param list list where the snapshots should be incorporated
+void GainEqualization::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  if (fInputHistograms==NULL)
+    return;
+
+  DetectorConfigurationChannels *ownerConfiguration =
+      static_cast<DetectorConfigurationChannels *>(fDetectorConfiguration);
+  CorrectionProfileChannelizedIngress inputHistograms(fInputHistograms->GetName(),
+                                                      fInputHistograms->GetTitle(),
+                                                      ownerConfiguration->GetEventClassVariablesSet(),
+                                                      ownerConfiguration->GetNoOfChannels(),
+                                                      "s");
+  inputHistograms.SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+  if (inputHistograms.AttachHistograms(source,
+                                       ownerConfiguration->GetUsedChannelsMask(),
+                                       ownerConfiguration->GetChannelsGroups()))
+    inputHistograms.ExportSnapshot(list);
+}
 }
@@ -45,6 +45,7 @@
 #pragma link C++ class Qn::CorrectionProfile+;
 #pragma link C++ class Qn::CorrectionProfile3DCorrelations+;
 #pragma link C++ class Qn::CorrectionProfileChannelized+;
+#pragma link C++ class Qn::CorrectionCalibrationSnapshot+;
 #pragma link C++ class Qn::CorrectionProfileChannelizedIngress+;
 #pragma link C++ class Qn::CorrectionProfileComponents+;
 #pragma link C++ class Qn::CorrectionProfileCorrelationComponents+;
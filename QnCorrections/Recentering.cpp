@@ -176,6 +176,9 @@ Bool_t Recentering::CreateNveQAHistograms(TList *list) {
 /// Pure virtual function
 /// \return kTRUE if the correction step was applied
 Bool_t Recentering::ProcessCorrections(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   Int_t harmonic;
   switch (fState) {
     case QCORRSTEP_calibration:
@@ -195,7 +198,7 @@ Bool_t Recentering::ProcessCorrections(const double *variableContainer) {
         harmonic = fDetectorConfiguration->GetCurrentQnVector()->GetFirstHarmonic();
 
         /* let's check the correction histograms */
-        Long64_t bin = fInputHistograms->GetBin(variableContainer);
+        Long64_t bin = fInputHistograms->GetBin(eventClassBin);
         if (fInputHistograms->BinContentValidated(bin)) {
           /* correction information validated */
           while (harmonic!=-1) {
@@ -215,7 +218,7 @@ Bool_t Recentering::ProcessCorrections(const double *variableContainer) {
           }
         } /* correction information not validated, we leave the Q vector untouched */
         else {
-          if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(variableContainer, 1.0);
+          if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(eventClassBin, 1.0);
         }
       } else {
         /* not done! input vector with bad quality */
@@ -237,6 +240,9 @@ Bool_t Recentering::ProcessCorrections(const double *variableContainer) {
 /// Pure virtual function
 /// \return kTRUE if the correction step was applied
 Bool_t Recentering::ProcessDataCollection(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   Int_t harmonic;
   switch (fState) {
     case QCORRSTEP_calibration:QnCorrectionsInfo(Form("Recentering process in detector %s: collecting data.",
@@ -245,8 +251,8 @@ Bool_t Recentering::ProcessDataCollection(const double *variableContainer) {
       if (fInputQnVector->IsGoodQuality()) {
         harmonic = fInputQnVector->GetFirstHarmonic();
         while (harmonic!=-1) {
-          fCalibrationHistograms->FillX(harmonic, variableContainer, fInputQnVector->Qx(harmonic));
-          fCalibrationHistograms->FillY(harmonic, variableContainer, fInputQnVector->Qy(harmonic));
+          fCalibrationHistograms->FillX(harmonic, eventClassBin, fInputQnVector->Qx(harmonic));
+          fCalibrationHistograms->FillY(harmonic, eventClassBin, fInputQnVector->Qy(harmonic));
           harmonic = fInputQnVector->GetNextHarmonic(harmonic);
         }
       }
@@ -259,8 +265,8 @@ Bool_t Recentering::ProcessDataCollection(const double *variableContainer) {
       if (fInputQnVector->IsGoodQuality()) {
         harmonic = fInputQnVector->GetFirstHarmonic();
         while (harmonic!=-1) {
-          fCalibrationHistograms->FillX(harmonic, variableContainer, fInputQnVector->Qx(harmonic));
-          fCalibrationHistograms->FillY(harmonic, variableContainer, fInputQnVector->Qy(harmonic));
+          fCalibrationHistograms->FillX(harmonic, eventClassBin, fInputQnVector->Qx(harmonic));
+          fCalibrationHistograms->FillY(harmonic, eventClassBin, fInputQnVector->Qy(harmonic));
           harmonic = fInputQnVector->GetNextHarmonic(harmonic);
         }
       }
@@ -271,8 +277,8 @@ Bool_t Recentering::ProcessDataCollection(const double *variableContainer) {
       if (fQAQnAverageHistogram!=NULL) {
         harmonic = fCorrectedQnVector->GetFirstHarmonic();
         while (harmonic!=-1) {
-          fQAQnAverageHistogram->FillX(harmonic, variableContainer, fCorrectedQnVector->Qx(harmonic));
-          fQAQnAverageHistogram->FillY(harmonic, variableContainer, fCorrectedQnVector->Qy(harmonic));
+          fQAQnAverageHistogram->FillX(harmonic, eventClassBin, fCorrectedQnVector->Qx(harmonic));
+          fQAQnAverageHistogram->FillY(harmonic, eventClassBin, fCorrectedQnVector->Qy(harmonic));
           harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
         }
       }
@@ -341,4 +347,42 @@ Bool_t Recentering::ReportUsage(TList *calibrationList, TList *applyList) {
   }
   return kTRUE;
 }
+
+/// Transfers the pending fills of the correction step histograms
+///
+/// The request is transmitted to the calibration and QA histograms
+/// that the correction step fills
+void Recentering::FlushHistogramFills() {
+  if (fCalibrationHistograms!=NULL)
+    fCalibrationHistograms->FlushFills();
+  if (fQAQnAverageHistogram!=NULL)
+    fQAQnAverageHistogram->FlushFills();
+}
+
+/// Exports the attached input calibration information as calibration snapshots
+///
+/// The request is transmitted to the input histograms
+/// \param list list where the snapshots should be incorporated
+void Recentering::ExportCalibrationSnapshot(TList *list) {
+  if (fInputHistograms!=NULL)
+    fInputHistograms->ExportSnapshot(list);
+}
+
+/// Prepares calibration snapshots from the passed input calibration information
+///
+/// Scratch input histograms, equal to the ones of the correction step,
+/// are attached to the passed list and exported
+/// \param source list where the input calibration information should be found
+/// \param list list where the snapshots should be incorporated
+void Recentering::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  if (fInputHistograms==NULL)
+    return;
+
+  CorrectionProfileComponents inputHistograms(fInputHistograms->GetName(),
+                                              fInputHistograms->GetTitle(),
+                                              fDetectorConfiguration->GetEventClassVariablesSet());
+  inputHistograms.SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+  if (inputHistograms.AttachHistograms(source))
+    inputHistograms.ExportSnapshot(list);
+}
 }
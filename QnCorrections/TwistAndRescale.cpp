@@ -402,6 +402,9 @@ Bool_t TwistAndRescale::CreateNveQAHistograms(TList *list) {
 /// Apply the correction step
 /// \return kTRUE if the correction step was applied
 Bool_t TwistAndRescale::ProcessCorrections(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   Int_t harmonic;
   switch (fState) {
     case QCORRSTEP_calibration: {
@@ -428,7 +431,7 @@ Bool_t TwistAndRescale::ProcessCorrections(const double *variableContainer) {
             fRescaleCorrectedQnVector->Set(fCorrectedQnVector, kFALSE);
 
             /* let's check the correction histograms */
-            Long64_t bin = fDoubleHarmonicInputHistograms->GetBin(variableContainer);
+            Long64_t bin = fDoubleHarmonicInputHistograms->GetBin(eventClassBin);
             if (fDoubleHarmonicInputHistograms->BinContentValidated(bin)) {
               /* remember we store the profile information on a twice the harmonic number base */
               harmonic = fCorrectedQnVector->GetFirstHarmonic();
@@ -492,7 +495,7 @@ Bool_t TwistAndRescale::ProcessCorrections(const double *variableContainer) {
                 harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
               }
             } else {
-              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(variableContainer, 1.0);
+              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(eventClassBin, 1.0);
             }
           } else {
             /* not done! input Q vector with bad quality */
@@ -512,16 +515,18 @@ Bool_t TwistAndRescale::ProcessCorrections(const double *variableContainer) {
             fRescaleCorrectedQnVector->Set(fCorrectedQnVector, kFALSE);
 
             /* let's check the correction histograms */
-            Long64_t bin = fCorrelationsInputHistograms->GetBin(variableContainer);
+            Long64_t bin = fCorrelationsInputHistograms->GetBin(eventClassBin);
             if (fCorrelationsInputHistograms->BinContentValidated(bin)) {
+              CorrectionProfile3DCorrelations::QnCorrelationComponents correlations;
               harmonic = fCorrectedQnVector->GetFirstHarmonic();
               while (harmonic!=-1) {
-                Double_t XAXC = fCorrelationsInputHistograms->GetXXBinContent("AC", harmonic, bin);
-                Double_t YAYB = fCorrelationsInputHistograms->GetYYBinContent("AB", harmonic, bin);
-                Double_t XAXB = fCorrelationsInputHistograms->GetXXBinContent("AB", harmonic, bin);
-                Double_t XBXC = fCorrelationsInputHistograms->GetXXBinContent("BC", harmonic, bin);
-                Double_t XAYB = fCorrelationsInputHistograms->GetXYBinContent("AB", harmonic, bin);
-                Double_t XBYC = fCorrelationsInputHistograms->GetXYBinContent("BC", harmonic, bin);
+                fCorrelationsInputHistograms->GetBinCorrelations(harmonic, bin, correlations);
+                Double_t XAXC = correlations.fXX[CorrectionProfile3DCorrelations::kAC];
+                Double_t YAYB = correlations.fYY[CorrectionProfile3DCorrelations::kAB];
+                Double_t XAXB = correlations.fXX[CorrectionProfile3DCorrelations::kAB];
+                Double_t XBXC = correlations.fXX[CorrectionProfile3DCorrelations::kBC];
+                Double_t XAYB = correlations.fXY[CorrectionProfile3DCorrelations::kAB];
+                Double_t XBYC = correlations.fXY[CorrectionProfile3DCorrelations::kBC];
 
                 Double_t Aplus = TMath::Sqrt(TMath::Abs(2.0*XAXC))*XAXB/TMath::Sqrt(TMath::Abs(XAXB*XBXC + XAYB*XBYC));
                 Double_t Aminus = TMath::Sqrt(TMath::Abs(2.0*XAXC))*YAYB/TMath::Sqrt(TMath::Abs(XAXB*XBXC + XAYB*XBYC));
@@ -579,7 +584,7 @@ Bool_t TwistAndRescale::ProcessCorrections(const double *variableContainer) {
                 harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
               }
             } else {
-              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(variableContainer, 1.0);
+              if (fQANotValidatedBin!=NULL) fQANotValidatedBin->Fill(eventClassBin, 1.0);
             }
           } else {
             /* not done! input Q vector with bad quality */
@@ -614,6 +619,9 @@ Bool_t TwistAndRescale::ProcessCorrections(const double *variableContainer) {
 /// Collect data for the correction step.
 /// \return kTRUE if the correction step was applied
 Bool_t TwistAndRescale::ProcessDataCollection(const double *variableContainer) {
+  (void) variableContainer;
+  /* the event class bin has already been located for the current event */
+  const Int_t *eventClassBin = fDetectorConfiguration->GetEventClassVariablesSet().GetEventClassBin();
   switch (fState) {
     case QCORRSTEP_calibration: {
       /* logging */
@@ -626,8 +634,8 @@ Bool_t TwistAndRescale::ProcessDataCollection(const double *variableContainer) {
           Int_t harmonic = fCorrectedQnVector->GetFirstHarmonic();
           if (plainQ2nVector->IsGoodQuality()) {
             while (harmonic!=-1) {
-              fDoubleHarmonicCalibrationHistograms->FillX(harmonic*2, variableContainer, plainQ2nVector->Qx(harmonic));
-              fDoubleHarmonicCalibrationHistograms->FillY(harmonic*2, variableContainer, plainQ2nVector->Qy(harmonic));
+              fDoubleHarmonicCalibrationHistograms->FillX(harmonic*2, eventClassBin, plainQ2nVector->Qx(harmonic));
+              fDoubleHarmonicCalibrationHistograms->FillY(harmonic*2, eventClassBin, plainQ2nVector->Qy(harmonic));
               harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
             }
           }
@@ -647,7 +655,7 @@ Bool_t TwistAndRescale::ProcessDataCollection(const double *variableContainer) {
             fCorrelationsCalibrationHistograms->Fill(fInputQnVector,
                                                      fBDetectorConfiguration->GetCurrentQnVector(),
                                                      fCDetectorConfiguration->GetCurrentQnVector(),
-                                                     variableContainer);
+                                                     eventClassBin);
           }
         }
           break;
@@ -671,8 +679,8 @@ Bool_t TwistAndRescale::ProcessDataCollection(const double *variableContainer) {
           Int_t harmonic = fCorrectedQnVector->GetFirstHarmonic();
           if (plainQ2nVector->IsGoodQuality()) {
             while (harmonic!=-1) {
-              fDoubleHarmonicCalibrationHistograms->FillX(harmonic*2, variableContainer, plainQ2nVector->Qx(harmonic));
-              fDoubleHarmonicCalibrationHistograms->FillY(harmonic*2, variableContainer, plainQ2nVector->Qy(harmonic));
+              fDoubleHarmonicCalibrationHistograms->FillX(harmonic*2, eventClassBin, plainQ2nVector->Qx(harmonic));
+              fDoubleHarmonicCalibrationHistograms->FillY(harmonic*2, eventClassBin, plainQ2nVector->Qy(harmonic));
               harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
             }
           }
@@ -692,7 +700,7 @@ Bool_t TwistAndRescale::ProcessDataCollection(const double *variableContainer) {
             fCorrelationsCalibrationHistograms->Fill(fInputQnVector,
                                                      fBDetectorConfiguration->GetCurrentQnVector(),
                                                      fCDetectorConfiguration->GetCurrentQnVector(),
-                                                     variableContainer);
+                                                     eventClassBin);
           }
         }
           break;
@@ -708,16 +716,16 @@ Bool_t TwistAndRescale::ProcessDataCollection(const double *variableContainer) {
       if (fQATwistQnAverageHistogram!=NULL) {
         Int_t harmonic = fCorrectedQnVector->GetFirstHarmonic();
         while (harmonic!=-1) {
-          fQATwistQnAverageHistogram->FillX(harmonic, variableContainer, fTwistCorrectedQnVector->Qx(harmonic));
-          fQATwistQnAverageHistogram->FillY(harmonic, variableContainer, fTwistCorrectedQnVector->Qy(harmonic));
+          fQATwistQnAverageHistogram->FillX(harmonic, eventClassBin, fTwistCorrectedQnVector->Qx(harmonic));
+          fQATwistQnAverageHistogram->FillY(harmonic, eventClassBin, fTwistCorrectedQnVector->Qy(harmonic));
           harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
         }
       }
       if (fQARescaleQnAverageHistogram!=NULL) {
         Int_t harmonic = fCorrectedQnVector->GetFirstHarmonic();
         while (harmonic!=-1) {
-          fQARescaleQnAverageHistogram->FillX(harmonic, variableContainer, fRescaleCorrectedQnVector->Qx(harmonic));
-          fQARescaleQnAverageHistogram->FillY(harmonic, variableContainer, fRescaleCorrectedQnVector->Qy(harmonic));
+          fQARescaleQnAverageHistogram->FillX(harmonic, eventClassBin, fRescaleCorrectedQnVector->Qx(harmonic));
+          fQARescaleQnAverageHistogram->FillY(harmonic, eventClassBin, fRescaleCorrectedQnVector->Qy(harmonic));
           harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
         }
       }
@@ -821,4 +829,58 @@ Bool_t TwistAndRescale::ReportUsage(TList *calibrationList, TList *applyList) {
   }
   return kFALSE;
 }
+
+/// Transfers the pending fills of the correction step histograms
+///
+/// The request is transmitted to the calibration histograms of both
+/// methods and to the QA histograms that the correction step fills
+void TwistAndRescale::FlushHistogramFills() {
+  if (fDoubleHarmonicCalibrationHistograms!=NULL)
+    fDoubleHarmonicCalibrationHistograms->FlushFills();
+  if (fCorrelationsCalibrationHistograms!=NULL)
+    fCorrelationsCalibrationHistograms->FlushFills();
+  if (fQATwistQnAverageHistogram!=NULL)
+    fQATwistQnAverageHistogram->FlushFills();
+  if (fQARescaleQnAverageHistogram!=NULL)
+    fQARescaleQnAverageHistogram->FlushFills();
+}
+
+/// Exports the attached input calibration information as calibration snapshots
+///
+/// The request is transmitted to the input histograms of both methods
+/// \param list list where the snapshots should be incorporated
+void TwistAndRescale::ExportCalibrationSnapshot(TList *list) {
+  if (fDoubleHarmonicInputHistograms!=NULL)
+    fDoubleHarmonicInputHistograms->ExportSnapshot(list);
+  if (fCorrelationsInputHistograms!=NULL)
+    fCorrelationsInputHistograms->ExportSnapshot(list);
+}
+
+/// Prepares calibration snapshots from the passed input calibration information
+///
+/// Scratch input histograms, equal to the ones of the correction step
+/// for the configured method, are attached to the passed list and exported
+/// \param source list where the input calibration information should be found
+/// \param list list where the snapshots should be incorporated
+void TwistAndRescale::PrepareCalibrationSnapshot(TList *source, TList *list) const {
+  if (fDoubleHarmonicInputHistograms!=NULL) {
+    CorrectionProfileComponents inputHistograms(fDoubleHarmonicInputHistograms->GetName(),
+                                                fDoubleHarmonicInputHistograms->GetTitle(),
+                                                fDetectorConfiguration->GetEventClassVariablesSet());
+    inputHistograms.SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+    if (inputHistograms.AttachHistograms(source))
+      inputHistograms.ExportSnapshot(list);
+  }
+  if (fCorrelationsInputHistograms!=NULL) {
+    CorrectionProfile3DCorrelations inputHistograms(fCorrelationsInputHistograms->GetName(),
+                                                    fCorrelationsInputHistograms->GetTitle(),
+                                                    fDetectorConfiguration->GetName(),
+                                                    fBDetectorConfiguration->GetName(),
+                                                    fCDetectorConfiguration->GetName(),
+                                                    fDetectorConfiguration->GetEventClassVariablesSet());
+    inputHistograms.SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+    if (inputHistograms.AttachHistograms(source))
+      inputHistograms.ExportSnapshot(list);
+  }
+}
 }
@@ -58,6 +58,7 @@
 #include <TTree.h>
 #include "CorrectionDetector.h"
 namespace Qn {
+class CorrectionCalibrationCache;
 class CorrectionCalculator : public TObject {
  public:
   CorrectionCalculator();
@@ -68,6 +69,9 @@ class CorrectionCalculator : public TObject {
   void SetListOfProcessesNames(TObjArray *names) { fProcessesNames = names; }
   void SetCurrentProcessListName(const char *name);
   void SetCalibrationHistogramsList(TFile *calibrationFile);
+  void SetCalibrationCacheSize(Int_t nProcesses);
+  Int_t GetCalibrationCacheSize() const;
+  void PrefetchProcessCalibration(const char *name);
   /// Enables disables the filling of histograms for building correction parameters
   /// \param enable kTRUE for enabling histograms filling
   void SetShouldFillOutputHistograms(Bool_t enable = kTRUE) { fFillOutputHistograms = enable; }
@@ -142,12 +146,20 @@ class CorrectionCalculator : public TObject {
   void PrintFrameworkConfiguration() const;
   void InitializeQnCorrectionsFramework();
   Int_t AddDataVector(Int_t detectorId, Double_t phi, Double_t weight = 1.0, Int_t channelId = -1);
+  Int_t AddDataVectors(Int_t detectorId, Int_t nData, const Float_t *phi, const Float_t *weight, Int_t channelId = -1);
+  Int_t AddQnVectorSums(Int_t detectorId, const CorrectionQnVectorSums *sums, Int_t channelId = -1);
   const char *GetAcceptedDataDetectorConfigurationName(Int_t detectorId, Int_t index) const;
   void ProcessEvent();
   void ClearEvent();
+  void FlushHistogramFills();
+  TList *ExportCalibrationSnapshot();
   void FinalizeQnCorrectionsFramework();
 
  private:
+  void AttachProcessCalibration();
+  TList *PrepareCalibrationSnapshot(TList *processList) const;
+  TList *ExportProcessCalibrationSnapshot();
+
   static const Int_t nMaxNoOfDetectors;              ///< the highest detector id currently supported by the framework
   static const Int_t
       nMaxNoOfDataVariables;          ///< the maximum number of variables currently supported by the framework
@@ -161,9 +173,11 @@ class CorrectionCalculator : public TObject {
   static const char
       *szAllProcessesListName;         ///< the name of the list that collects data from all concurrent processes
   TList fDetectorsSet;                  ///< the list of detectors
+  TList fEventClassVariablesSets;       //!<! the distinct event class variables sets used by the detector configurations
   CorrectionDetector **fDetectorsIdMap; //!<! map between external detector Id and internal detector
   double *fDataContainer;              //!<! the data variables bank
   TList *fCalibrationHistogramsList;    ///< the list of the input calibration histograms
+  CorrectionCalibrationCache *fCalibrationCache; //!<! the cache of prepared per process calibrations
   TList *fSupportHistogramsList;        //!<! the list of the support histograms
   TList *fQAHistogramsList;             //!<! the list of QA histograms
   TList *fNveQAHistogramsList;          //!<! the list of not validated entries QA histograms
@@ -202,6 +216,41 @@ inline Int_t CorrectionCalculator::AddDataVector(Int_t detectorId, Double_t phi,
   return fDetectorsIdMap[detectorId]->AddDataVector(fDataContainer, phi, weight, channelId);
 }
 
+/// New set of data vectors for the framework
+/// The whole set is transmitted in one go to the passed detector together
+/// with the current content of the variable bank. Detector configurations
+/// without input data corrections use the passed arrays in place so they
+/// must stay unchanged until the event has been processed.
+/// \param detectorId id of the involved detector
+/// \param nData the number of data vectors
+/// \param phi the azimuthal angles of the data vectors
+/// \param weight the weights of the data vectors
+/// \param channelId the channel Id shared by the data vectors. If negative
+/// each data vector gets its position as channel Id.
+/// \return the number of detector configurations that accepted the data vectors
+inline Int_t CorrectionCalculator::AddDataVectors(Int_t detectorId,
+                                                  Int_t nData,
+                                                  const Float_t *phi,
+                                                  const Float_t *weight,
+                                                  Int_t channelId) {
+  return fDetectorsIdMap[detectorId]->AddDataVectors(fDataContainer, nData, phi, weight, channelId);
+}
+
+/// New raw Q vector sums for the framework
+/// The sums, accumulated while the data vectors were produced, are transmitted
+/// to the passed detector together with the current content of the variable bank.
+/// Only detector configurations without input data corrections accept them.
+/// The passed sums must stay unchanged until the event has been processed.
+/// \param detectorId id of the involved detector
+/// \param sums the raw sums of the data vectors
+/// \param channelId the channel Id shared by the data vectors, the bin for differential configurations
+/// \return the number of detector configurations that accepted the sums
+inline Int_t CorrectionCalculator::AddQnVectorSums(Int_t detectorId,
+                                                   const CorrectionQnVectorSums *sums,
+                                                   Int_t channelId) {
+  return fDetectorsIdMap[detectorId]->AddQnVectorSums(fDataContainer, sums, channelId);
+}
+
 /// Gets the name of the detector configuration at index that accepted last data vector
 /// \param detectorId id of the involved detector
 /// \param index the position in the list of accepted data vector configuration
@@ -215,9 +264,19 @@ inline const char *CorrectionCalculator::GetAcceptedDataDetectorConfigurationNam
 /// The request is transmitted to the different detectors first for applying the different
 /// correction steps and then to collect the correction steps data.
 ///
+/// The event class bin of each of the event class variables sets
+/// in use is computed beforehand and shared by all the correction
+/// steps and histograms that depend on it.
+///
 /// Must be called only when the whole data vectors for the event
 /// have been incorporated to the framework.
 inline void CorrectionCalculator::ProcessEvent() {
+  /* locate the event within each event class variables set only once */
+  TIter nextSet(&fEventClassVariablesSets);
+  EventClassVariablesSet *set;
+  while ((set = (EventClassVariablesSet *) nextSet())) {
+    set->UpdateEventClassBin(fDataContainer);
+  }
   for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
     ((CorrectionDetector *) fDetectorsSet.At(ixDetector))->ProcessCorrections(fDataContainer);
   }
@@ -0,0 +1,73 @@
+#ifndef QNCORRECTIONS_CALIBRATIONCACHE_H
+#define QNCORRECTIONS_CALIBRATIONCACHE_H
+
+/// \file CorrectionCalibrationCache.h
+/// \brief Bounded cache of prepared per process calibration for the Q vector correction framework
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <Rtypes.h>
+
+class TList;
+
+namespace Qn {
+/// \class CorrectionCalibrationCache
+/// \brief Least recently used cache of per process calibration snapshot lists
+///
+/// Each entry is a calibration snapshot list prepared for a concrete
+/// process, i.e. a run, and is identified by the list name, which is the
+/// process name. Input profiles attach to the entries by plain lookups,
+/// so switching back to a cached process avoids the reconstruction of
+/// the calibration histograms.
+///
+/// The cache keeps at most its capacity of entries. When a new entry
+/// exceeds it, the least recently used one is evicted. The entry marked
+/// as in use, the one the framework is currently attached to, is never
+/// evicted.
+///
+/// One entry at a time can be prepared on a background thread while the
+/// current process is still being processed. Lookups of a process whose
+/// preparation is in flight wait for it to finish.
+///
+/// The cache owns the entries.
+class CorrectionCalibrationCache {
+ public:
+  explicit CorrectionCalibrationCache(Int_t capacity);
+  ~CorrectionCalibrationCache();
+
+  /// Gets the maximum number of entries the cache keeps
+  /// \return the cache capacity
+  Int_t GetCapacity() const { return fCapacity; }
+  void SetCapacity(Int_t capacity);
+  Int_t GetNoOfEntries();
+
+  TList *Acquire(const char *name);
+  Bool_t Contains(const char *name);
+  void Insert(TList *calibration);
+  void Prefetch(const char *name, std::function<TList *()> prepare);
+  void Clear();
+
+ private:
+  void WaitForPrefetch();
+  void Evict();
+
+  Int_t fCapacity;                 ///< maximum number of entries
+  std::list<TList *> fEntries;     ///< the cached calibration lists, most recently used first
+  std::string fInUse;              ///< name of the entry the framework is attached to
+  std::string fPrefetchName;       ///< name of the process being prepared in background
+  std::thread fPrefetchThread;     ///< the background preparation thread
+  std::mutex fMutex;               ///< protects the entries against the background preparation
+
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  CorrectionCalibrationCache(const CorrectionCalibrationCache &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  CorrectionCalibrationCache &operator=(const CorrectionCalibrationCache &);
+};
+}
+#endif
@@ -0,0 +1,109 @@
+#ifndef QNCORRECTIONS_CALIBRATIONSNAPSHOT_H
+#define QNCORRECTIONS_CALIBRATIONSNAPSHOT_H
+
+/// \file CorrectionCalibrationSnapshot.h
+/// \brief Compact read only calibration parameters for the apply stage of the Q vector correction framework
+
+#include <TNamed.h>
+#include <TArrayI.h>
+#include <TArrayF.h>
+#include <TArrayL64.h>
+
+class THnBase;
+
+namespace Qn {
+/// \class CorrectionCalibrationSnapshot
+/// \brief Flat per bin calibration parameters of a profile
+///
+/// Stores, for each bin of the event class binning of a finished
+/// calibration profile, the number of entries and, for each of the
+/// profile components, the bin mean and the standard deviation of
+/// the bin values. Everything is kept in flat arrays indexed by
+/// the histogram bin number, bin major and component minor, together
+/// with the strides needed to compute the bin number from the bin
+/// on each axis. The apply stage then gets the bin parameters with
+/// plain array lookups and without rebuilding any histogram.
+///
+/// The meaning of each component index is established by the owner
+/// profile. Components not used by the owner profile keep zero values.
+class CorrectionCalibrationSnapshot : public TNamed {
+ public:
+  CorrectionCalibrationSnapshot();
+  CorrectionCalibrationSnapshot(const char *name, const char *title, THnBase *binning, Int_t nNoOfComponents);
+  virtual ~CorrectionCalibrationSnapshot();
+
+  void SetEntries(THnBase *entries);
+  void SetComponent(Int_t component, THnBase *values, THnBase *entries);
+
+  /// Sets the number of entries of the passed bin
+  /// \param bin the histogram bin number
+  /// \param nEntries the number of entries
+  void SetBinEntries(Long64_t bin, Int_t nEntries) { fEntries[bin] = nEntries; }
+  /// Sets the value and spread of a component of the passed bin
+  /// \param bin the histogram bin number
+  /// \param component the component index
+  /// \param value the component value
+  /// \param spread the component spread
+  void SetBinComponent(Long64_t bin, Int_t component, Float_t value, Float_t spread) {
+    fValues[bin*fNoOfComponents + component] = value;
+    fSpreads[bin*fNoOfComponents + component] = spread;
+  }
+  /// Sets the mask of the harmonics stored in the snapshot
+  /// \param mask the harmonics mask
+  void SetHarmonicMask(UInt_t mask) { fHarmonicMask = mask; }
+
+  /// Gets the number of axes of the binning
+  /// \return the number of axes
+  Int_t GetNoOfDimensions() const { return fStrides.GetSize(); }
+  /// Gets the number of bins, under and overflow bins included
+  /// \return the number of bins
+  Long64_t GetNoOfBins() const { return fEntries.GetSize(); }
+  /// Gets the number of components stored for each bin
+  /// \return the number of components
+  Int_t GetNoOfComponents() const { return fNoOfComponents; }
+  /// Gets the mask of the harmonics stored in the snapshot
+  /// \return the harmonics mask
+  UInt_t GetHarmonicMask() const { return fHarmonicMask; }
+
+  /// Gets the bin number for the passed bin on each axis
+  ///
+  /// Follows the histogram bin numbering so the bin on each
+  /// axis includes the underflow bin as bin zero
+  /// \param bins the bin on each of the axes
+  /// \return the associated bin number
+  Long64_t GetBin(const Int_t *bins) const {
+    Long64_t bin = 0;
+    for (Int_t axis = 0; axis < fStrides.GetSize(); axis++) {
+      bin += bins[axis]*fStrides[axis];
+    }
+    return bin;
+  }
+  /// Gets the number of entries of the passed bin
+  /// \param bin the histogram bin number
+  /// \return the number of entries
+  Int_t GetBinEntries(Long64_t bin) const { return fEntries[bin]; }
+  /// Gets the value of a component of the passed bin
+  /// \param bin the histogram bin number
+  /// \param component the component index
+  /// \return the component value
+  Float_t GetBinValue(Long64_t bin, Int_t component) const { return fValues[bin*fNoOfComponents + component]; }
+  /// Gets the spread of a component of the passed bin
+  /// \param bin the histogram bin number
+  /// \param component the component index
+  /// \return the component spread
+  Float_t GetBinSpread(Long64_t bin, Int_t component) const { return fSpreads[bin*fNoOfComponents + component]; }
+
+ private:
+  Int_t fNoOfComponents;   ///< the number of components stored for each bin
+  UInt_t fHarmonicMask;    ///< the harmonics stored in the snapshot, if harmonic based
+  TArrayL64 fStrides;      ///< the bin number stride of each axis
+  TArrayI fEntries;        ///< the number of entries of each bin
+  TArrayF fValues;         ///< the component values, bin major and component minor
+  TArrayF fSpreads;        ///< the component spreads, same layout as fValues
+
+  /// \cond CLASSIMP
+ ClassDef(CorrectionCalibrationSnapshot, 1);
+  /// \endcond
+};
+}
+#endif
@@ -74,11 +74,21 @@ class CorrectionDetector : public TNamed {
   void AddDetectorConfiguration(DetectorConfiguration *detectorConfiguration);
   DetectorConfiguration *FindDetectorConfiguration(const char *name);
   void FillDetectorConfigurationNameList(TList *list) const;
+  void FillEventClassVariablesSetList(TList *list) const;
   void FillOverallInputCorrectionStepList(TList *list) const;
   void FillOverallQnVectorCorrectionStepList(TList *list) const;
   virtual void ReportOnCorrections(TList *steps, TList *calib, TList *apply) const;
+  virtual void FlushHistogramFills();
+  virtual void ExportCalibrationSnapshot(TList *list);
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const;
 
   Int_t AddDataVector(const double *variableContainer, Double_t phi, Double_t weight = 1.0, Int_t channelId = -1);
+  Int_t AddDataVectors(const double *variableContainer,
+                       Int_t nData,
+                       const Float_t *phi,
+                       const Float_t *weight,
+                       Int_t channelId = -1);
+  Int_t AddQnVectorSums(const double *variableContainer, const CorrectionQnVectorSums *sums, Int_t channelId = -1);
 
   virtual void ClearDetector();
 
@@ -125,6 +135,52 @@ inline Int_t CorrectionDetector::AddDataVector(const double *variableContainer,
   return fDataVectorAcceptedConfigurations.GetEntries();
 }
 
+/// New set of data vectors for the detector
+/// The whole set is transmitted in one go to the attached detector
+/// configurations which decide whether they need to copy it.
+/// The passed arrays must stay unchanged until the event has been processed.
+/// \param variableContainer pointer to the variable content bank
+/// \param nData the number of data vectors
+/// \param phi the azimuthal angles of the data vectors
+/// \param weight the weights of the data vectors
+/// \param channelId the channel Id shared by the data vectors. If negative
+/// each data vector gets its position as channel Id.
+/// \return the number of detector configurations that accepted the data vectors
+inline Int_t CorrectionDetector::AddDataVectors(const double *variableContainer,
+                                                Int_t nData,
+                                                const Float_t *phi,
+                                                const Float_t *weight,
+                                                Int_t channelId) {
+  fDataVectorAcceptedConfigurations.Clear();
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    Bool_t ret = fConfigurations.At(ixConfiguration)->AddDataVectors(variableContainer, nData, phi, weight, channelId);
+    if (ret) {
+      fDataVectorAcceptedConfigurations.Add(fConfigurations.At(ixConfiguration));
+    }
+  }
+  return fDataVectorAcceptedConfigurations.GetEntries();
+}
+
+/// New raw Q vector sums for the detector
+/// The sums are transmitted to the attached detector configurations.
+/// The passed sums must stay unchanged until the event has been processed.
+/// \param variableContainer pointer to the variable content bank
+/// \param sums the raw sums of the data vectors
+/// \param channelId the channel Id shared by the data vectors, the bin for differential configurations
+/// \return the number of detector configurations that accepted the sums
+inline Int_t CorrectionDetector::AddQnVectorSums(const double *variableContainer,
+                                                 const CorrectionQnVectorSums *sums,
+                                                 Int_t channelId) {
+  fDataVectorAcceptedConfigurations.Clear();
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    Bool_t ret = fConfigurations.At(ixConfiguration)->AddQnVectorSums(variableContainer, sums, channelId);
+    if (ret) {
+      fDataVectorAcceptedConfigurations.Add(fConfigurations.At(ixConfiguration));
+    }
+  }
+  return fDataVectorAcceptedConfigurations.GetEntries();
+}
+
 /// Ask for processing corrections for the involved detector
 ///
 /// The request is transmitted to the attached detector configurations
@@ -6,6 +6,7 @@
 
 #include <THn.h>
 #include "EventClassVariablesSet.h"
+#include "CorrectionCalibrationSnapshot.h"
 namespace Qn {
 /// \class QnCorrectionsHistogramBase
 /// \brief Base class for the Q vector correction histograms
@@ -28,6 +29,10 @@ namespace Qn {
 /// The encapsulated bin axes values provide an efficient
 /// runtime storage for computing bin numbers.
 ///
+/// The input profiles of the apply stage can be attached either to the
+/// histograms of a finished calibration or to a compact calibration
+/// snapshot of them, exported by a previous attachment to the histograms.
+///
 /// Provides the interface for the whole set of histogram
 /// classes providing error information that helps debugging.
 ///
@@ -60,6 +65,8 @@ class CorrectionHistogramBase : public TNamed {
 
   virtual Long64_t GetBin(const double *variableContainer);
   virtual Long64_t GetBin(const double *variableContainer, Int_t nChannel);
+  virtual Long64_t GetBin(const Int_t *eventClassBin);
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel);
   /// Check the validity of the content of the passed bin
   /// Pure virtual function
   /// \param bin the bin to check its content validity
@@ -105,16 +112,39 @@ class CorrectionHistogramBase : public TNamed {
   virtual void FillXY(Int_t harmonic, const double *variableContainer, Float_t weight);
   virtual void FillYX(Int_t harmonic, const double *variableContainer, Float_t weight);
   virtual void FillYY(Int_t harmonic, const double *variableContainer, Float_t weight);
+  virtual void Fill(const Int_t *eventClassBin, Float_t weight);
+  virtual void Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight);
+  virtual void FillX(Int_t harmonic, const Int_t *eventClassBin, Float_t weight);
+  virtual void FillY(Int_t harmonic, const Int_t *eventClassBin, Float_t weight);
+  virtual void FillXX(const Int_t *eventClassBin, Float_t weight);
+  virtual void FillXY(const Int_t *eventClassBin, Float_t weight);
+  virtual void FillYX(const Int_t *eventClassBin, Float_t weight);
+  virtual void FillYY(const Int_t *eventClassBin, Float_t weight);
+
+  /// Transfers the fills kept in the histogram own fill storage, if any,
+  /// to the histograms
+  ///
+  /// Default behavior: the histograms are filled directly, nothing to transfer
+  virtual void FlushFills() {}
+
+  virtual Bool_t ExportSnapshot(TList *list);
 
  protected:
   void FillBinAxesValues(const double *variableContainer, Int_t chgrpId = -1);
+  void FillBinAxesBins(const Int_t *eventClassBin, Int_t chgrpBin = 0);
+  void FillBinAxesBins(const double *variableContainer, Int_t chgrpBin = 0);
   THnF *DivideTHnF(THnF *values, THnI *entries, THnC *valid = NULL);
   void CopyTHnF(THnF *hDest, THnF *hSource, Int_t *binsArray);
   void CopyTHnFDimension(THnF *hDest, THnF *hSource, Int_t *binsArray, Int_t dimension);
+  Bool_t AttachSnapshot(TList *histogramList);
+  Float_t GetSnapshotBinError(Long64_t bin, Int_t component);
+  static Int_t GetHighestHarmonic(UInt_t harmonicMask);
 
   EventClassVariablesSet fEventClassVariables;  //!<! The variables set that determines the event classes
   Double_t *fBinAxesValues;                                  //!<! Runtime place holder for computing bin number
+  Int_t *fBinAxesBins;                                       //!<! Runtime place holder for computing bin number from the event class bin
   QnCorrectionHistogramErrorMode fErrorMode;                 //!<! The error type for the current instance
+  CorrectionCalibrationSnapshot *fSnapshot;                  //!<! The attached calibration snapshot, if any
   Int_t
       fMinNoOfEntriesToValidate;                           ///< the minimum number of entries for validating a bin content
   /// \cond CLASSIMP
@@ -124,6 +154,7 @@ class CorrectionHistogramBase : public TNamed {
   static const char *szGroupAxisTitle;                   ///< The title for the channel group extra axis
   static const char *szGroupHistoPrefix;                 ///< The prefix for the name of the group histograms
   static const char *szEntriesHistoSuffix;               ///< The suffix for the name of the entries histograms
+  static const char *szSnapshotSuffix;                   ///< The suffix for the name of the calibration snapshots
   static const char *szXComponentSuffix;                 ///< The suffix for the name of X component histograms
   static const char *szYComponentSuffix;                 ///< The suffix for the name of Y component histograms
   static const char
@@ -159,5 +190,37 @@ inline void CorrectionHistogramBase::FillBinAxesValues(const double *variableCon
   fBinAxesValues[fEventClassVariables.GetEntriesFast()] = chgrpId;
 }
 
+/// Fills the axes bins for the current passed event class bin
+///
+/// Core of the event class bin based GetBin members. Stores the
+/// event class bin on each of the involved variables in the internal
+/// place holder. Space is prepared for potential channel or group bin.
+///
+/// \param eventClassBin the current event class bin on each of the variables
+/// \param chgrpBin additional optional channel or group axis bin
+inline void CorrectionHistogramBase::FillBinAxesBins(const Int_t *eventClassBin, Int_t chgrpBin) {
+  for (Int_t var = 0; var < fEventClassVariables.GetEntriesFast(); var++) {
+    fBinAxesBins[var] = eventClassBin[var];
+  }
+  fBinAxesBins[fEventClassVariables.GetEntriesFast()] = chgrpBin;
+}
+
+/// Fills the axes bins for the current passed variable container
+///
+/// Core of the calibration snapshot based GetBin members. Stores the
+/// bin the current value of each of the involved variables falls in
+/// in the internal place holder. Space is prepared for potential
+/// channel or group bin.
+///
+/// \param variableContainer the current variables content addressed by var Id
+/// \param chgrpBin additional optional channel or group axis bin
+inline void CorrectionHistogramBase::FillBinAxesBins(const double *variableContainer, Int_t chgrpBin) {
+  for (Int_t var = 0; var < fEventClassVariables.GetEntriesFast(); var++) {
+    fBinAxesBins[var] =
+        fEventClassVariables.At(var)->FindBin(variableContainer[fEventClassVariables.At(var)->GetVariableId()]);
+  }
+  fBinAxesBins[fEventClassVariables.GetEntriesFast()] = chgrpBin;
+}
+
 }
 #endif
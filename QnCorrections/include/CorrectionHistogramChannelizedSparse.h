@@ -46,6 +46,9 @@ class CorrectionHistogramChannelizedSparse : public CorrectionHistogramBase {
   /// wrong call for this class invoke base class behaviour
   virtual Long64_t GetBin(const double *variableContainer) { return CorrectionHistogramBase::GetBin(variableContainer); }
   virtual Long64_t GetBin(const double *variableContainer, Int_t nChannel);
+  /// wrong call for this class invoke base class behaviour
+  virtual Long64_t GetBin(const Int_t *eventClassBin) { return CorrectionHistogramBase::GetBin(eventClassBin); }
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel);
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetBinContent(Long64_t bin);
   virtual Float_t GetBinError(Long64_t bin);
@@ -56,6 +59,12 @@ class CorrectionHistogramChannelizedSparse : public CorrectionHistogramBase {
                                      weight);
   }
   virtual void Fill(const double *variableContainer, Int_t nChannel, Float_t weight);
+  /// wrong call for this class invoke base class behavior
+  virtual void Fill(const Int_t *eventClassBin, Float_t weight) {
+    CorrectionHistogramBase::Fill(eventClassBin,
+                                     weight);
+  }
+  virtual void Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight);
  private:
   THnSparseF *fValues;              //!<! Cumulates values for each of the event classes
   Bool_t *fUsedChannel;       //!<! array, which of the detector channels is used for this configuration
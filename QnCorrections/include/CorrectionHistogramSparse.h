@@ -39,6 +39,12 @@ class CorrectionHistogramSparse : public CorrectionHistogramBase {
     return CorrectionHistogramBase::GetBin(variableContainer,
                                               nChannel);
   }
+  virtual Long64_t GetBin(const Int_t *eventClassBin);
+  /// wrong call for this class invoke base class behaviour
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+    return CorrectionHistogramBase::GetBin(eventClassBin,
+                                              nChannel);
+  }
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetBinContent(Long64_t bin);
   virtual Float_t GetBinError(Long64_t bin);
@@ -50,6 +56,13 @@ class CorrectionHistogramSparse : public CorrectionHistogramBase {
                                      nChannel,
                                      weight);
   }
+  virtual void Fill(const Int_t *eventClassBin, Float_t weight);
+  /// wrong call for this class invoke base class behavior
+  virtual void Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight) {
+    CorrectionHistogramBase::Fill(eventClassBin,
+                                     nChannel,
+                                     weight);
+  }
  private:
   THnSparseF *fValues;              //!<! Cumulates values for each of the event classes
 
@@ -5,6 +5,7 @@
 /// \brief Three detector correlation components based set of profiles with harmonic support for the Q vector correction framework
 
 #include "CorrectionHistogramBase.h"
+#include "CorrectionProfileAccumulator.h"
 namespace Qn {
 class CorrectionQnVector;
 
@@ -39,12 +40,34 @@ class CorrectionQnVector;
 /// Only in the histograms name it appears the proper mxn harmonic to
 /// not confuse the external user which browse the histograms.
 ///
+/// The fills are kept in a dense storage which holds the entries and
+/// the four components of every combination and harmonic of a bin
+/// together. They are transferred to the histograms by FlushFills,
+/// which has to be invoked before the histograms content is used or
+/// persisted.
+///
 /// \author Jaap Onderwaater <jacobus.onderwaater@cern.ch>, GSI
 /// \author Ilya Selyuzhenkov <ilya.selyuzhenkov@gmail.com>, GSI
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
 /// \date Jan 19, 2016
 class CorrectionProfile3DCorrelations : public CorrectionHistogramBase {
  public:
+  /// The Qn vector correlation combinations
+  enum QnCorrelationCombination {
+    kAB = 0,             ///< A and B Qn vectors correlation
+    kBC,                 ///< B and C Qn vectors correlation
+    kAC,                 ///< A and C Qn vectors correlation
+    kNoOfCombinations    ///< the number of Qn vector correlation combinations
+  };
+  /// The averaged correlation components of the three Qn vector
+  /// combinations for one harmonic and event class
+  struct QnCorrelationComponents {
+    Float_t fXX[kNoOfCombinations];   ///< XX component for each combination
+    Float_t fXY[kNoOfCombinations];   ///< XY component for each combination
+    Float_t fYX[kNoOfCombinations];   ///< YX component for each combination
+    Float_t fYY[kNoOfCombinations];   ///< YY component for each combination
+  };
+
   CorrectionProfile3DCorrelations();
   CorrectionProfile3DCorrelations(
       const char *name,
@@ -76,6 +99,12 @@ class CorrectionProfile3DCorrelations : public CorrectionHistogramBase {
     return CorrectionHistogramBase::GetBin(variableContainer,
                                               nChannel);
   }
+  virtual Long64_t GetBin(const Int_t *eventClassBin);
+  /// wrong call for this class invoke base class behavior
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+    return CorrectionHistogramBase::GetBin(eventClassBin,
+                                              nChannel);
+  }
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetXXBinContent(const char *comb, Int_t harmonic, Long64_t bin);
   virtual Float_t GetXYBinContent(const char *comb, Int_t harmonic, Long64_t bin);
@@ -85,11 +114,28 @@ class CorrectionProfile3DCorrelations : public CorrectionHistogramBase {
   virtual Float_t GetXYBinError(const char *comb, Int_t harmonic, Long64_t bin);
   virtual Float_t GetYXBinError(const char *comb, Int_t harmonic, Long64_t bin);
   virtual Float_t GetYYBinError(const char *comb, Int_t harmonic, Long64_t bin);
+  Float_t GetXXBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetXYBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetYXBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetYYBinContent(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetXXBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetXYBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetYXBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Float_t GetYYBinError(QnCorrelationCombination comb, Int_t harmonic, Long64_t bin);
+  Bool_t GetBinCorrelations(Int_t harmonic, Long64_t bin, QnCorrelationComponents &correlations);
 
   void Fill(const CorrectionQnVector *QnA,
             const CorrectionQnVector *QnB,
             const CorrectionQnVector *QnC,
             const double *variableContainer);
+  void Fill(const CorrectionQnVector *QnA,
+            const CorrectionQnVector *QnB,
+            const CorrectionQnVector *QnC,
+            const Int_t *eventClassBin);
+
+  virtual void FlushFills();
+
+  virtual Bool_t ExportSnapshot(TList *list);
 
   /// wrong call for this class invoke base class behavior
   virtual Float_t GetXXBinContent(Long64_t bin) { return CorrectionHistogramBase::GetXXBinContent(bin); }
@@ -160,8 +206,27 @@ class CorrectionProfile3DCorrelations : public CorrectionHistogramBase {
                                      nChannel,
                                      weight);
   }
+  /// wrong call for this class invoke base class behavior
+  virtual void Fill(const Int_t *eventClassBin, Float_t weight) {
+    CorrectionHistogramBase::Fill(eventClassBin,
+                                     weight);
+  }
+  /// wrong call for this class invoke base class behavior
+  virtual void Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight) {
+    CorrectionHistogramBase::Fill(eventClassBin,
+                                     nChannel,
+                                     weight);
+  }
 
  private:
+  static QnCorrelationCombination GetCombination(const char *comb);
+  /// Gets the fill storage component for the XX component of the passed
+  /// Qn vector combination and harmonic. The XY, YX and YY components follow it.
+  /// \param ixComb the Qn vector combination
+  /// \param harmonic the external harmonic number
+  /// \return the fill storage component index
+  Int_t FirstComponent(Int_t ixComb, Int_t harmonic) const { return 1 + 4*(ixComb*fNoOfSlots + harmonic); }
+
   THnF ***fXXValues;            //!<! XX component histogram for each requested harmonic
   THnF ***fXYValues;            //!<! XY component histogram for each requested harmonic
   THnF ***fYXValues;            //!<! YX component histogram for each requested harmonic
@@ -171,6 +236,8 @@ class CorrectionProfile3DCorrelations : public CorrectionHistogramBase {
   TString fNameB;               ///< the name of the B detector
   TString fNameC;               ///< the name of the C detector
   Int_t fHarmonicMultiplier;    ///< the multiplier for the harmonic number
+  Int_t fNoOfSlots;             //!<! the number of harmonic slots for each Qn vector combination
+  CorrectionProfileAccumulator fAccumulator; //!<! fill storage, entries in component 0
   /// \cond CLASSIMP
  ClassDef(CorrectionProfile3DCorrelations, 1);
   /// \endcond
@@ -0,0 +1,126 @@
+#ifndef QNCORRECTIONS_PROFILEACCUMULATOR_H
+#define QNCORRECTIONS_PROFILEACCUMULATOR_H
+
+/// \file CorrectionProfileAccumulator.h
+/// \brief Dense fill storage for the component based profiles of the Q vector correction framework
+
+#include <algorithm>
+#include <vector>
+
+#include <Rtypes.h>
+#include <THnBase.h>
+
+namespace Qn {
+/// \class CorrectionProfileAccumulator
+/// \brief Contiguous storage of the fills of a set of profile components
+///
+/// The component based profiles keep one THn per harmonic and component,
+/// plus an entries histogram, all of them sharing the event class binning.
+/// Filling them component by component scatters the writes of each event
+/// over as many histograms as components and pays the THn fill overhead
+/// for each of them.
+///
+/// The accumulator keeps instead, for each bin of the shared binning, the
+/// sum of weights and the sum of squared weights of every component next
+/// to each other, addressed by the bin number already located for the
+/// event class. The accumulated sums are transferred to the THn histograms
+/// on request, before the histograms are used or persisted.
+///
+/// Components are identified by an index in [0, number of components)
+/// whose meaning is established by the owner profile.
+class CorrectionProfileAccumulator {
+ public:
+  /// Default constructor
+  CorrectionProfileAccumulator() :
+      fNoOfBins(0),
+      fNoOfComponents(0),
+      fSumW(),
+      fSumW2(),
+      fFills(),
+      fPending(kFALSE) {}
+
+  /// Prepares the storage for the passed histogram binning
+  ///
+  /// Any previous content is discarded
+  /// \param nBins total number of bins of the histograms, under and overflow bins included
+  /// \param nComponents number of components stored for each bin
+  void Allocate(Long64_t nBins, Int_t nComponents) {
+    fNoOfBins = nBins;
+    fNoOfComponents = nComponents;
+    fSumW.assign(nBins*nComponents, 0.0);
+    fSumW2.assign(nBins*nComponents, 0.0);
+    fFills.assign(nComponents, 0);
+    fPending = kFALSE;
+  }
+  /// Returns the storage to its non allocated state
+  void Release() {
+    fNoOfBins = 0;
+    fNoOfComponents = 0;
+    std::vector<Double_t>().swap(fSumW);
+    std::vector<Double_t>().swap(fSumW2);
+    std::vector<Long64_t>().swap(fFills);
+    fPending = kFALSE;
+  }
+  /// Gets the number of components stored for each bin
+  /// \return the number of components
+  Int_t GetNoOfComponents() const { return fNoOfComponents; }
+  /// Checks whether the storage has been allocated
+  /// \return kTRUE if the storage is allocated
+  Bool_t IsAllocated() const { return fNoOfComponents > 0; }
+  /// Checks whether there are fills not yet transferred to the histograms
+  /// \return kTRUE if there are pending fills
+  Bool_t IsPending() const { return fPending; }
+
+  /// Increases the component of the passed bin by the given weight
+  /// \param bin the histogram bin number
+  /// \param component the component index
+  /// \param weight the increment in the component content
+  void Fill(Long64_t bin, Int_t component, Double_t weight) {
+    Long64_t index = bin*fNoOfComponents + component;
+    fSumW[index] += weight;
+    fSumW2[index] += weight*weight;
+    fFills[component]++;
+    fPending = kTRUE;
+  }
+
+  /// Transfers the accumulated content of a component to its histogram
+  ///
+  /// The component sums are added to the histogram bins, the squared
+  /// weights only if the histogram computes errors, and the histogram
+  /// entries are increased by the number of fills of the component.
+  /// The accumulator content is not modified, use Reset for that.
+  /// \param component the component index
+  /// \param histogram the histogram associated to the component
+  void Flush(Int_t component, THnBase *histogram) const {
+    Double_t nEntries = histogram->GetEntries();
+    Bool_t bErrors = histogram->GetCalculateErrors();
+
+    for (Long64_t bin = 0; bin < fNoOfBins; bin++) {
+      Long64_t index = bin*fNoOfComponents + component;
+      /* the sum of squares only vanishes if the bin never got a non zero weight */
+      if (fSumW2[index]==0.0) continue;
+      histogram->AddBinContent(bin, fSumW[index]);
+      if (bErrors)
+        histogram->AddBinError2(bin, fSumW2[index]);
+    }
+    histogram->SetEntries(nEntries + fFills[component]);
+  }
+
+  /// Clears the accumulated content keeping the storage
+  void Reset() {
+    std::fill(fSumW.begin(), fSumW.end(), 0.0);
+    std::fill(fSumW2.begin(), fSumW2.end(), 0.0);
+    std::fill(fFills.begin(), fFills.end(), 0);
+    fPending = kFALSE;
+  }
+
+ private:
+  Long64_t fNoOfBins;            ///< number of histogram bins, under and overflow bins included
+  Int_t fNoOfComponents;         ///< number of components stored for each bin
+  std::vector<Double_t> fSumW;   ///< sum of weights, bin major and component minor
+  std::vector<Double_t> fSumW2;  ///< sum of squared weights, same layout as fSumW
+  std::vector<Long64_t> fFills;  ///< number of fills of each component
+  Bool_t fPending;               ///< there are fills not yet transferred to the histograms
+};
+}
+#endif
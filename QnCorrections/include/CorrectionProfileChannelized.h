@@ -66,6 +66,9 @@ class CorrectionProfileChannelized : public CorrectionHistogramBase {
   virtual Long64_t GetBin(const double *variableContainer, Int_t nChannel);
   /// wrong call for this class invoke base class behavior
   virtual Long64_t GetBin(const double *variableContainer) { return CorrectionHistogramBase::GetBin(variableContainer); }
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel);
+  /// wrong call for this class invoke base class behavior
+  virtual Long64_t GetBin(const Int_t *eventClassBin) { return CorrectionHistogramBase::GetBin(eventClassBin); }
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetBinContent(Long64_t bin);
   virtual Float_t GetBinError(Long64_t bin);
@@ -76,6 +79,12 @@ class CorrectionProfileChannelized : public CorrectionHistogramBase {
     CorrectionHistogramBase::Fill(variableContainer,
                                      weight);
   }
+  virtual void Fill(const Int_t *eventClassBin, Int_t nChannel, Float_t weight);
+  /// wrong call for this class invoke base class behavior
+  virtual void Fill(const Int_t *eventClassBin, Float_t weight) {
+    CorrectionHistogramBase::Fill(eventClassBin,
+                                     weight);
+  }
  private:
   THnF *fValues;              //!<! Cumulates values for each of the event classes
   THnI *fEntries;             //!<! Cumulates the number on each of the event classes
@@ -58,12 +58,18 @@ class CorrectionProfileChannelizedIngress : public CorrectionHistogramBase {
   virtual Long64_t GetGrpBin(const double *variableContainer, Int_t nChannel);
   /// wrong call for this class invoke base class behavior
   virtual Long64_t GetBin(const double *variableContainer) { return CorrectionHistogramBase::GetBin(variableContainer); }
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel);
+  virtual Long64_t GetGrpBin(const Int_t *eventClassBin, Int_t nChannel);
+  /// wrong call for this class invoke base class behavior
+  virtual Long64_t GetBin(const Int_t *eventClassBin) { return CorrectionHistogramBase::GetBin(eventClassBin); }
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetBinContent(Long64_t bin);
   virtual Float_t GetGrpBinContent(Long64_t bin);
   virtual Float_t GetBinError(Long64_t bin);
   virtual Float_t GetGrpBinError(Long64_t bin);
 
+  virtual Bool_t ExportSnapshot(TList *list);
+
  private:
   THnF *fValues;              //!<! the values and errors on each event class and channel
   THnF *fGroupValues;         //!<! the values and errors on each event class and group
@@ -78,6 +84,7 @@ class CorrectionProfileChannelizedIngress : public CorrectionHistogramBase {
   Int_t fNoOfGroups;          //!<! the number of groups associated with the whole detector
   Int_t fActualNoOfGroups;    //!<! The actual number of groups handled by the histogram
   Int_t *fGroupMap;           //!<! array, the map from histo to detector channel group number
+  CorrectionCalibrationSnapshot *fGroupSnapshot; //!<! the attached group calibration snapshot, if any
 
 
   /// \cond CLASSIMP
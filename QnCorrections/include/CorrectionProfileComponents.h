@@ -5,6 +5,7 @@
 /// \brief Component based set of profiles for the Q vector correction framework
 
 #include "CorrectionHistogramBase.h"
+#include "CorrectionProfileAccumulator.h"
 namespace Qn {
 /// \class QnCorrectionsProfileComponents
 /// \brief Base class for the components based set of profiles
@@ -35,6 +36,11 @@ namespace Qn {
 /// component before the whole set is filled you will get an execution
 /// error because you are doing something that shall be corrected
 ///
+/// The fills are kept in a dense storage which holds the entries and
+/// all the components of a bin together. They are transferred to the
+/// histograms by FlushFills, which has to be invoked before the
+/// histograms content is used or persisted.
+///
 /// \author Jaap Onderwaater <jacobus.onderwaater@cern.ch>, GSI
 /// \author Ilya Selyuzhenkov <ilya.selyuzhenkov@gmail.com>, GSI
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
@@ -65,6 +71,12 @@ class CorrectionProfileComponents : public CorrectionHistogramBase {
     return CorrectionHistogramBase::GetBin(variableContainer,
                                               nChannel);
   }
+  virtual Long64_t GetBin(const Int_t *eventClassBin);
+  /// wrong call for this class invoke base class behavior
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+    return CorrectionHistogramBase::GetBin(eventClassBin,
+                                              nChannel);
+  }
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetXBinContent(Int_t harmonic, Long64_t bin);
   virtual Float_t GetYBinContent(Int_t harmonic, Long64_t bin);
@@ -73,14 +85,31 @@ class CorrectionProfileComponents : public CorrectionHistogramBase {
 
   virtual void FillX(Int_t harmonic, const double *variableContainer, Float_t weight);
   virtual void FillY(Int_t harmonic, const double *variableContainer, Float_t weight);
+  virtual void FillX(Int_t harmonic, const Int_t *eventClassBin, Float_t weight);
+  virtual void FillY(Int_t harmonic, const Int_t *eventClassBin, Float_t weight);
+
+  virtual void FlushFills();
+
+  virtual Bool_t ExportSnapshot(TList *list);
 
  private:
+  /// Gets the fill storage component for the X component of the passed harmonic
+  /// \param harmonic the external harmonic number
+  /// \return the fill storage component index
+  static Int_t XComponent(Int_t harmonic) { return 1 + 2*harmonic; }
+  /// Gets the fill storage component for the Y component of the passed harmonic
+  /// \param harmonic the external harmonic number
+  /// \return the fill storage component index
+  static Int_t YComponent(Int_t harmonic) { return 2 + 2*harmonic; }
+
+
   THnF **fXValues;            //!<! X component histogram for each requested harmonic
   THnF **fYValues;            //!<! Y component histogram for each requested harmonic
   UInt_t fXharmonicFillMask;  //!<! keeps track of harmonic X component filled values
   UInt_t fYharmonicFillMask;  //!<! keeps track of harmonic Y component filled values
   UInt_t fFullFilled;         //!<! mask for the fully filled condition
   THnI *fEntries;            //!<! Cumulates the number on each of the event classes
+  CorrectionProfileAccumulator fAccumulator; //!<! fill storage, entries in component 0
   /// \cond CLASSIMP
  ClassDef(CorrectionProfileComponents, 1);
   /// \endcond
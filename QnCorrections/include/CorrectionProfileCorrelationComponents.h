@@ -5,6 +5,7 @@
 /// \brief Correlation components based set of profiles for the Q vector correction framework
 
 #include "CorrectionHistogramBase.h"
+#include "CorrectionProfileAccumulator.h"
 namespace Qn {
 /// \class QnCorrectionsProfileCorrelationComponents
 /// \brief Base class for the correlation components based set of profiles
@@ -18,6 +19,11 @@ namespace Qn {
 /// Of course,  the base name and base title for the different
 /// histograms has also to be provided.
 ///
+/// The fills are kept in a dense storage which holds the entries and
+/// the four components of a bin together. They are transferred to the
+/// histograms by FlushFills, which has to be invoked before the
+/// histograms content is used or persisted.
+///
 /// \author Jaap Onderwaater <jacobus.onderwaater@cern.ch>, GSI
 /// \author Ilya Selyuzhenkov <ilya.selyuzhenkov@gmail.com>, GSI
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
@@ -49,6 +55,12 @@ class CorrectionProfileCorrelationComponents : public CorrectionHistogramBase {
     return CorrectionHistogramBase::GetBin(variableContainer,
                                               nChannel);
   }
+  virtual Long64_t GetBin(const Int_t *eventClassBin);
+  /// wrong call for this class invoke base class behavior
+  virtual Long64_t GetBin(const Int_t *eventClassBin, Int_t nChannel) {
+    return CorrectionHistogramBase::GetBin(eventClassBin,
+                                              nChannel);
+  }
   virtual Bool_t BinContentValidated(Long64_t bin);
   virtual Float_t GetXXBinContent(Long64_t bin);
   virtual Float_t GetXYBinContent(Long64_t bin);
@@ -63,6 +75,14 @@ class CorrectionProfileCorrelationComponents : public CorrectionHistogramBase {
   virtual void FillXY(const double *variableContainer, Float_t weight);
   virtual void FillYX(const double *variableContainer, Float_t weight);
   virtual void FillYY(const double *variableContainer, Float_t weight);
+  virtual void FillXX(const Int_t *eventClassBin, Float_t weight);
+  virtual void FillXY(const Int_t *eventClassBin, Float_t weight);
+  virtual void FillYX(const Int_t *eventClassBin, Float_t weight);
+  virtual void FillYY(const Int_t *eventClassBin, Float_t weight);
+
+  virtual void FlushFills();
+
+  virtual Bool_t ExportSnapshot(TList *list);
 
   /// wrong call for this class invoke base class behavior
   virtual Float_t GetXXBinContent(Int_t harmonic, Long64_t bin) {
@@ -139,6 +159,16 @@ class CorrectionProfileCorrelationComponents : public CorrectionHistogramBase {
   }
 
  private:
+  /// The components within the fill storage
+  enum FillComponent {
+    kEntriesComponent = 0,    ///< the entries
+    kXXComponent,             ///< the XX correlation component
+    kXYComponent,             ///< the XY correlation component
+    kYXComponent,             ///< the YX correlation component
+    kYYComponent,             ///< the YY correlation component
+    kNoOfComponents           ///< the number of components in the fill storage
+  };
+
   THnF *fXXValues;            //!<! XX component histogram
   THnF *fXYValues;            //!<! XY component histogram
   THnF *fYXValues;            //!<! YX component histogram
@@ -146,6 +176,7 @@ class CorrectionProfileCorrelationComponents : public CorrectionHistogramBase {
   UInt_t fXXXYYXYYFillMask;   //!<! keeps track of component filled values
   UInt_t fFullFilled;          //!<! mask for the fully filled condition
   THnI *fEntries;             //!<! Cumulates the number on each of the event classes
+  CorrectionProfileAccumulator fAccumulator; //!<! fill storage for the entries and the components
   /// \cond CLASSIMP
  ClassDef(CorrectionProfileCorrelationComponents, 1);
   /// \endcond
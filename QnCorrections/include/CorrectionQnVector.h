@@ -67,6 +67,9 @@ class CorrectionQnVector : public TNamed {
   /// Get the harmonic multiplier
   /// \return the harmonic multiplier
   Int_t GetHarmonicMultiplier() const { return fHarmonicMultiplier; }
+  /// Get the minimum value considered as meaningful for processing
+  /// \return the minimum significant value
+  static Float_t GetMinimumSignificantValue() { return fMinimumSignificantValue; }
 
   /// Sets the X component for the considered harmonic
   /// \param harmonic the intended harmonic
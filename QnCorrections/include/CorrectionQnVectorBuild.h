@@ -16,6 +16,7 @@
 
 #include "CorrectionQnVector.h"
 namespace Qn {
+class CorrectionQnVectorSums;
 /// \class CorrectionQnVectorBuild
 /// \brief Class that models and encapsulates a Q vector set while building it
 ///
@@ -42,6 +43,9 @@ class CorrectionQnVectorBuild : public CorrectionQnVector {
 
   void Add(CorrectionQnVectorBuild *qvec);
   void Add(Double_t phi, Double_t weight = 1.0);
+  void Add(Int_t nChannels, Double_t *weights, const Double_t *cosTable, const Double_t *sinTable);
+  void Add(Int_t nEntries, const Float_t *phi, const Float_t *weight);
+  void Add(const CorrectionQnVectorSums &sums);
 
   /// Check the quality of the constructed Qn vector
   /// Current criteria is number of contributors should be at least one.
@@ -57,6 +61,7 @@ class CorrectionQnVectorBuild : public CorrectionQnVector {
   virtual void Print(Option_t *) const;
 
  private:
+  static const Int_t nBuildLanes = 8; ///< number of independent lanes used when adding batches of contributions
   /// Assignment operator
   ///
   /// Default implementation to protect against its accidental use.
@@ -88,6 +93,43 @@ inline void CorrectionQnVectorBuild::Add(Double_t phi, Double_t weight) {
   fN += 1;
 }
 
+/// Adds the contributions of a set of channels with precomputed harmonic tables
+/// The tables store cos(k phi) and sin(k phi) of each channel at position
+/// k*nChannels + channel, for all the harmonics multiples k handled. With this layout
+/// each harmonic component is a dot product of the weights with a contiguous table row.
+/// Weights below the significant value are set to zero and are not counted as contributions.
+/// \param nChannels the number of channels
+/// \param weights the weight of each channel
+/// \param cosTable the cosine table of the channels
+/// \param sinTable the sine table of the channels
+inline void CorrectionQnVectorBuild::Add(Int_t nChannels,
+                                         Double_t *weights,
+                                         const Double_t *cosTable,
+                                         const Double_t *sinTable) {
+  for (Int_t ixChannel = 0; ixChannel < nChannels; ixChannel++) {
+    if (weights[ixChannel] < fMinimumSignificantValue) {
+      weights[ixChannel] = 0.0;
+    } else {
+      fSumW += weights[ixChannel];
+      fN += 1;
+    }
+  }
+  for (Int_t h = 1; h < fHighestHarmonic + 1; h++) {
+    if ((fHarmonicMask & harmonicNumberMask[h])==harmonicNumberMask[h]) {
+      const Double_t *cosRow = cosTable + h*fHarmonicMultiplier*nChannels;
+      const Double_t *sinRow = sinTable + h*fHarmonicMultiplier*nChannels;
+      Double_t qx = 0.0;
+      Double_t qy = 0.0;
+      for (Int_t ixChannel = 0; ixChannel < nChannels; ixChannel++) {
+        qx += weights[ixChannel]*cosRow[ixChannel];
+        qy += weights[ixChannel]*sinRow[ixChannel];
+      }
+      fQnX[h] += qx;
+      fQnY[h] += qy;
+    }
+  }
+}
+
 /// Calibrates the Q vector according to the method passed
 /// \param method the method of calibration
 inline void CorrectionQnVectorBuild::Normalize(Normalization method) {
@@ -0,0 +1,105 @@
+#ifndef QNCORRECTIONS_QNVECTORSUMS_H
+#define QNCORRECTIONS_QNVECTORSUMS_H
+
+/// \file CorrectionQnVectorSums.h
+/// \brief Streaming accumulation of the raw Q vector sums of the Q vector correction framework
+
+#include <Rtypes.h>
+#include <TMath.h>
+
+#include "CorrectionQnVector.h"
+#include "CorrectionLog.h"
+
+namespace Qn {
+/// \class CorrectionQnVectorSums
+/// \brief Raw weighted sums of the harmonic multiples of a set of azimuthal angles
+///
+/// Keeps, for each harmonic multiple k up to the configured highest one,
+/// the sums of w cos(k phi) and w sin(k phi), together with the sum of
+/// weights and the number of contributions. A build Q vector with any
+/// harmonic multiplier takes from them its components as long as its
+/// highest harmonic times its multiplier does not exceed the highest
+/// multiple kept. A single set of sums then serves both the Qn and the
+/// Q2n vectors of a detector configuration.
+///
+/// The contributions are accumulated as they come, without storing them.
+/// Only one sine and one cosine are evaluated per contribution, the higher
+/// multiples are obtained by complex multiplication so each of them costs
+/// a few multiply-adds. Contributions with weight below the significant
+/// value of the Q vectors are ignored.
+class CorrectionQnVectorSums {
+ public:
+  /// Default constructor
+  CorrectionQnVectorSums() : fHighestMultiple(0) { Reset(); }
+
+  /// Sets the highest harmonic multiple to keep
+  /// \param multiple the highest harmonic multiple
+  void SetHighestMultiple(Int_t multiple) {
+    if (nMaxMultiple < multiple) {
+      QnCorrectionsFatal(Form("You requested harmonic multiples up to %d while the highest supported is %d. " \
+          "FIX IT, PLEASE.", multiple, nMaxMultiple));
+      return;
+    }
+    fHighestMultiple = multiple;
+  }
+  /// Gets the highest harmonic multiple kept
+  /// \return the highest harmonic multiple
+  Int_t GetHighestMultiple() const { return fHighestMultiple; }
+
+  /// Clears the sums to accept a new event
+  void Reset() {
+    for (Int_t k = 0; k < nMaxMultiple + 1; k++) {
+      fCos[k] = 0.0;
+      fSin[k] = 0.0;
+    }
+    fSumW = 0.0;
+    fN = 0;
+  }
+
+  /// Adds a contribution to the sums
+  /// \param phi azimuthal angle of the contribution
+  /// \param weight the weight of the contribution
+  void Add(Double_t phi, Double_t weight) {
+    if (weight < CorrectionQnVector::GetMinimumSignificantValue()) return;
+    Double_t c1 = TMath::Cos(phi);
+    Double_t s1 = TMath::Sin(phi);
+    Double_t cn = c1;
+    Double_t sn = s1;
+    fCos[1] += weight*cn;
+    fSin[1] += weight*sn;
+    for (Int_t k = 2; k < fHighestMultiple + 1; k++) {
+      Double_t c = cn*c1 - sn*s1;
+      sn = sn*c1 + cn*s1;
+      cn = c;
+      fCos[k] += weight*cn;
+      fSin[k] += weight*sn;
+    }
+    fSumW += weight;
+    fN += 1;
+  }
+
+  /// Gets the sum of the weighted cosines of the harmonic multiple
+  /// \param multiple the harmonic multiple
+  /// \return the sum of w cos(multiple phi)
+  Double_t Cos(Int_t multiple) const { return fCos[multiple]; }
+  /// Gets the sum of the weighted sines of the harmonic multiple
+  /// \param multiple the harmonic multiple
+  /// \return the sum of w sin(multiple phi)
+  Double_t Sin(Int_t multiple) const { return fSin[multiple]; }
+  /// Gets the sum of weights of the contributions
+  /// \return sum of weights
+  Double_t GetSumOfWeights() const { return fSumW; }
+  /// Gets the number of contributions
+  /// \return number of contributions
+  Int_t GetN() const { return fN; }
+
+ private:
+  static const Int_t nMaxMultiple = 2*MAXHARMONICNUMBERSUPPORTED; ///< the highest harmonic multiple supported
+  Int_t fHighestMultiple;                ///< the highest harmonic multiple kept
+  Double_t fCos[nMaxMultiple + 1];       ///< the sums of w cos(k phi)
+  Double_t fSin[nMaxMultiple + 1];       ///< the sums of w sin(k phi)
+  Double_t fSumW;                        ///< the sum of weights
+  Int_t fN;                              ///< the number of contributions
+};
+}
+#endif
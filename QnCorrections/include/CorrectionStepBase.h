@@ -133,6 +133,26 @@ class CorrectionStepBase : public TNamed {
   /// \param applyList list containing the correction steps applying corrections
   /// \return kTRUE if the correction step is being applied
   virtual Bool_t ReportUsage(TList *calibrationList, TList *applyList) = 0;
+  /// Transfers the pending fills of the correction step histograms
+  ///
+  /// Default behavior: the correction step histograms are filled directly,
+  /// nothing to transfer
+  virtual void FlushHistogramFills() {}
+  /// Exports the attached input calibration information as calibration snapshots
+  ///
+  /// Default behavior: the correction step has no input calibration, nothing to export
+  /// \param list list where the snapshots should be incorporated
+  virtual void ExportCalibrationSnapshot(TList *list) { (void) list; }
+  /// Prepares calibration snapshots from the passed input calibration information
+  ///
+  /// Builds scratch input histograms, attaches them to the passed list and exports
+  /// them as calibration snapshots. The correction step state is not modified so
+  /// the preparation can run concurrently with the event processing.
+  ///
+  /// Default behavior: the correction step has no input calibration, nothing to prepare
+  /// \param source list where the input calibration information should be found
+  /// \param list list where the snapshots should be incorporated
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const { (void) source; (void) list; }
  protected:
   /// Stores the detector configuration owner
   /// \param detectorConfiguration the detector configuration owner
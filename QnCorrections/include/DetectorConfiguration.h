@@ -32,6 +32,7 @@ namespace Qn {
 class DetectorConfigurationsSet;
 class CorrectionDetector;
 class CorrectionCalculator;
+class CorrectionQnVectorSums;
 
 /// \class QnCorrectionsDetectorConfigurationBase
 /// \brief The base of a concrete detector configuration within Q vector correction framework
@@ -246,6 +247,21 @@ class DetectorConfiguration : public TNamed {
   /// \param calib list for incorporating the list of steps in calibrating status
   /// \param apply list for incorporating the list of steps in applying status
   virtual void ReportOnCorrections(TList *steps, TList *calib, TList *apply) const = 0;
+  /// Transfers the pending fills of the configuration histograms
+  ///
+  /// Pure virtual function
+  virtual void FlushHistogramFills() = 0;
+  /// Exports the attached input calibration information as calibration snapshots
+  ///
+  /// Pure virtual function
+  /// \param list list where the detector configuration snapshots list should be incorporated
+  virtual void ExportCalibrationSnapshot(TList *list) = 0;
+  /// Prepares calibration snapshots from the passed input calibration information
+  ///
+  /// Pure virtual function
+  /// \param source list where the detector configuration input calibration list should be found
+  /// \param list list where the detector configuration snapshots list should be incorporated
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const = 0;
 
   /// New data vector for the detector configuration
   /// Pure virtual function
@@ -255,6 +271,12 @@ class DetectorConfiguration : public TNamed {
   /// \param channelId the channel Id that originates the data vector
   /// \return kTRUE if the data vector was accepted and stored
   virtual Bool_t AddDataVector(const double *variableContainer, Double_t phi, Double_t weight, Int_t channelId) = 0;
+  virtual Bool_t AddDataVectors(const double *variableContainer,
+                                Int_t nData,
+                                const Float_t *phi,
+                                const Float_t *weight,
+                                Int_t id = -1);
+  virtual Bool_t AddQnVectorSums(const double *variableContainer, const CorrectionQnVectorSums *sums, Int_t id = -1);
 
   virtual Bool_t IsSelected(const double *variableContainer) = 0;
   virtual Bool_t IsSelected(const double *variableContainer, Int_t nChannel) = 0;
@@ -107,13 +107,23 @@ class DetectorConfigurationChannels :
   virtual void AddCorrectionOnInputData(CorrectionOnInputData *correctionOnInputData);
 
   virtual Bool_t AddDataVector(const double *variableContainer, Double_t phi, Double_t weight, Int_t channelId);
+  virtual Bool_t AddDataVectors(const double *variableContainer,
+                                Int_t nData,
+                                const Float_t *phi,
+                                const Float_t *weight,
+                                Int_t channelId = -1);
 
   virtual void BuildQnVector();
   void BuildRawQnVector();
+  void FillChannelsWeights(Bool_t equalized);
+  void SetChannelHarmonics(Int_t channel, Float_t phi);
   virtual void IncludeQnVectors(TList *list);
   virtual void FillOverallInputCorrectionStepList(TList *list) const;
   virtual void FillOverallQnVectorCorrectionStepList(TList *list) const;
   virtual void ReportOnCorrections(TList *steps, TList *calib, TList *apply) const;
+  virtual void FlushHistogramFills();
+  virtual void ExportCalibrationSnapshot(TList *list);
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const;
 
   /// Checks if the current content of the variable bank applies to
   /// the detector configuration for the passed channel.
@@ -148,6 +158,12 @@ class DetectorConfigurationChannels :
   /// array, group hard coded weight
   Float_t *fHardCodedGroupWeights;         //[fNoOfChannels]
   CorrectionsSetOnInputData fInputDataCorrections; ///< set of corrections to apply on input data vectors
+  /// the number of harmonic multiples stored in the channels harmonic tables (Q2n needs twice the harmonic)
+  static const Int_t nHarmonicTableSize = 2*MAXHARMONICNUMBERSUPPORTED + 1;
+  Float_t *fChannelPhi;                    //!<! the azimuthal angle each channel harmonic table was built for
+  Double_t *fChannelCos;                   //!<! cos(k phi) of each channel at k*fNoOfChannels + channel
+  Double_t *fChannelSin;                   //!<! sin(k phi) of each channel at k*fNoOfChannels + channel
+  Double_t *fChannelWeights;               //!<! the current event weight of each channel
 
   /* QA section */
   void FillQAHistograms(const double *variableContainer);
@@ -196,6 +212,66 @@ inline Bool_t DetectorConfigurationChannels::AddDataVector(
   return kFALSE;
 }
 
+/// New set of data vectors for the detector configuration.
+///
+/// The input data corrections work on the data vector bank so each
+/// data vector is checked against its channel and stored in the bank.
+/// \param variableContainer pointer to the variable content bank
+/// \param nData the number of data vectors
+/// \param phi the azimuthal angles of the data vectors
+/// \param weight the weights of the data vectors
+/// \param channelId the channel Id shared by the data vectors. If negative
+/// each data vector gets its position as channel Id.
+/// \return kTRUE if any of the data vectors was accepted and stored
+inline Bool_t DetectorConfigurationChannels::AddDataVectors(const double *variableContainer,
+                                                            Int_t nData,
+                                                            const Float_t *phi,
+                                                            const Float_t *weight,
+                                                            Int_t channelId) {
+  Bool_t accepted = kFALSE;
+  for (Int_t ixData = 0; ixData < nData; ixData++) {
+    if (DetectorConfigurationChannels::AddDataVector(variableContainer,
+                                                     phi[ixData],
+                                                     weight[ixData],
+                                                     (channelId < 0) ? ixData : channelId))
+      accepted = kTRUE;
+  }
+  return accepted;
+}
+
+/// Stores the harmonic table of a channel
+/// The cosine and sine of all the harmonic multiples handled are computed for the
+/// channel azimuthal angle. As the channels azimuthal angles are fixed by the detector
+/// geometry this only happens the first time the channel gets data.
+/// \param channel the channel number
+/// \param phi the channel azimuthal angle
+inline void DetectorConfigurationChannels::SetChannelHarmonics(Int_t channel, Float_t phi) {
+  fChannelPhi[channel] = phi;
+  for (Int_t k = 0; k < nHarmonicTableSize; k++) {
+    fChannelCos[k*fNoOfChannels + channel] = TMath::Cos(k*Double_t(phi));
+    fChannelSin[k*fNoOfChannels + channel] = TMath::Sin(k*Double_t(phi));
+  }
+}
+
+/// Fills the current event weight of each channel from the data vector bank
+/// Channels without data vector get zero weight. The harmonic table of a channel
+/// is refreshed if its azimuthal angle does not match the stored one.
+/// \param equalized kTRUE if the equalized weights have to be used
+inline void DetectorConfigurationChannels::FillChannelsWeights(Bool_t equalized) {
+  for (Int_t ixChannel = 0; ixChannel < fNoOfChannels; ixChannel++) {
+    fChannelWeights[ixChannel] = 0.0;
+  }
+  for (Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++) {
+    CorrectionDataVectorChannelized
+        *dataVector = static_cast<CorrectionDataVectorChannelized *>(fDataVectorBank->At(ixData));
+    Int_t channel = dataVector->GetId();
+    if (fChannelPhi[channel]!=dataVector->Phi()) {
+      SetChannelHarmonics(channel, dataVector->Phi());
+    }
+    fChannelWeights[channel] += (equalized ? dataVector->EqualizedWeight() : dataVector->Weight());
+  }
+}
+
 /// Builds raw Qn vector before Q vector corrections and before input
 /// data corrections but considering the chosen calibration method.
 /// This is a channelized configuration so this Q vector will NOT be
@@ -203,11 +279,8 @@ inline Bool_t DetectorConfigurationChannels::AddDataVector(
 inline void DetectorConfigurationChannels::BuildRawQnVector() {
   fTempQnVector.Reset();
 
-  for (Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++) {
-    CorrectionDataVectorChannelized
-        *dataVector = static_cast<CorrectionDataVectorChannelized *>(fDataVectorBank->At(ixData));
-    fTempQnVector.Add(dataVector->Phi(), dataVector->Weight());
-  }
+  FillChannelsWeights(kFALSE);
+  fTempQnVector.Add(fNoOfChannels, fChannelWeights, fChannelCos, fChannelSin);
   fTempQnVector.CheckQuality();
   fTempQnVector.Normalize(fQnNormalizationMethod);
   fRawQnVector.Set(&fTempQnVector, kFALSE);
@@ -221,12 +294,9 @@ inline void DetectorConfigurationChannels::BuildQnVector() {
   fTempQnVector.Reset();
   fTempQ2nVector.Reset();
 
-  for (Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++) {
-    CorrectionDataVectorChannelized
-        *dataVector = static_cast<CorrectionDataVectorChannelized *>(fDataVectorBank->At(ixData));
-    fTempQnVector.Add(dataVector->Phi(), dataVector->EqualizedWeight());
-    fTempQ2nVector.Add(dataVector->Phi(), dataVector->EqualizedWeight());
-  }
+  FillChannelsWeights(kTRUE);
+  fTempQnVector.Add(fNoOfChannels, fChannelWeights, fChannelCos, fChannelSin);
+  fTempQ2nVector.Add(fNoOfChannels, fChannelWeights, fChannelCos, fChannelSin);
   fTempQnVector.CheckQuality();
   fTempQ2nVector.CheckQuality();
   fTempQnVector.Normalize(fQnNormalizationMethod);
@@ -15,7 +15,10 @@
 /// \brief Track detector configuration class for Q vector correction framework
 ///
 
+#include <vector>
+
 #include "CorrectionDataVector.h"
+#include "CorrectionQnVectorSums.h"
 #include "DetectorConfiguration.h"
 #include "CorrectionLog.h"
 namespace Qn {
@@ -65,12 +68,21 @@ class DetectorConfigurationTracks :
                                Double_t phi,
                                Double_t weight = 1.0,
                                Int_t channelId = -1);
+  virtual Bool_t AddDataVectors(const double *variableContainer,
+                                Int_t nData,
+                                const Float_t *phi,
+                                const Float_t *weight,
+                                Int_t id = -1);
+  virtual Bool_t AddQnVectorSums(const double *variableContainer, const CorrectionQnVectorSums *sums, Int_t id = -1);
 
   virtual void BuildQnVector();
   virtual void IncludeQnVectors(TList *list);
   virtual void FillOverallInputCorrectionStepList(TList *list) const;
   virtual void FillOverallQnVectorCorrectionStepList(TList *list) const;
   virtual void ReportOnCorrections(TList *steps, TList *calib, TList *apply) const;
+  virtual void FlushHistogramFills();
+  virtual void ExportCalibrationSnapshot(TList *list);
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const;
 
   /// Checks if the current content of the variable bank applies to
   /// the detector configuration
@@ -91,13 +103,46 @@ class DetectorConfigurationTracks :
 
   virtual void ClearConfiguration();
 
+  void SetDifferentialBins(Int_t nNoOfBins, Double_t *binVariable);
+  /// Get if the detector configuration builds one Qn vector per bin
+  /// \return kTRUE if it is a differential detector configuration
+  Bool_t GetIsDifferential() const { return (fNoOfBins > 0); }
+
  private:
+  /// Data vectors handed in bulk, or their raw Q vector sums, consumed in place
+  struct DataVectorSpan {
+    Int_t fNoOfData;        ///< the number of data vectors
+    const Float_t *fPhi;    ///< the azimuthal angles of the data vectors
+    const Float_t *fWeight; ///< the weights of the data vectors
+    Int_t fId;              ///< the id shared by the data vectors
+    const CorrectionQnVectorSums *fSums; ///< the raw sums of the data vectors, if handed as such
+  };
+
+  void ClearQnVectors();
+  void BuildQnVector(Int_t nSpans, const DataVectorSpan *spans);
+  Bool_t ProcessBinnedDataCollection(const double *variableContainer);
+  void IncludeBinQnVectors(TList *list);
+  void StoreBinQnVectors(Int_t bin);
+
   /* QA section */
   void FillQAHistograms(const double *variableContainer);
   static const char
       *szQAQnAverageHistogramName; ///< name and title for plain Qn vector components average QA histograms
   CorrectionProfileComponents *fQAQnAverageHistogram; //!<! the plain average Qn components QA histogram
 
+  std::vector<Float_t> fPhiBuffer;    //!<! azimuthal angles of the current event data vectors
+  std::vector<Float_t> fWeightBuffer; //!<! weights of the current event data vectors
+  std::vector<DataVectorSpan> fDataVectorSpans; //!<! the data vectors handed in bulk for the current event
+  std::vector<DataVectorSpan> fBuildSpans;      //!<! the data vectors a Qn vector is being built from
+
+  /* differential section */
+  Int_t fNoOfBins;                  //!<! number of bins of a differential configuration, zero otherwise
+  Double_t *fBinVariable;           //!<! variable bank slot holding the bin being processed
+  std::vector<Int_t> fBinOffsets;   //!<! offset of the first data vector of each bin in the buffers
+  std::vector<Int_t> fBinPositions; //!<! insert position of each bin while sorting the data vectors
+  TList fBinLiveQnVectors;          //!<! the Qn vectors to be stored after processing each bin
+  TObjArray fBinQnVectorLists;      //!<! the lists with the stored Qn vectors of each bin
+
 /// \cond CLASSIMP
  ClassDef(DetectorConfigurationTracks, 2);
 /// \endcond
@@ -122,12 +167,82 @@ inline Bool_t DetectorConfigurationTracks::AddDataVector(
   return kFALSE;
 }
 
+/// New set of data vectors for the detector configuration.
+/// A check is made to see if the current variable bank content passes
+/// the associated cuts. If so, the data vectors are accepted.
+///
+/// Track detector configurations have no input data corrections so the
+/// data vectors are not copied into the data vector bank. The passed arrays
+/// are kept and consumed in place when the Qn vectors are built, so they
+/// must stay unchanged until the event has been processed.
+/// \param variableContainer pointer to the variable content bank
+/// \param nData the number of data vectors
+/// \param phi the azimuthal angles of the data vectors
+/// \param weight the weights of the data vectors
+/// \param id the Id shared by the data vectors, the bin for differential
+/// configurations. If negative each data vector gets its position as Id.
+/// \return kTRUE if the data vectors were accepted
+inline Bool_t DetectorConfigurationTracks::AddDataVectors(const double *variableContainer,
+                                                          Int_t nData,
+                                                          const Float_t *phi,
+                                                          const Float_t *weight,
+                                                          Int_t id) {
+  /* differential configurations take the bin from the id so we store them one by one */
+  if ((fNoOfBins > 0) && (id < 0))
+    return DetectorConfiguration::AddDataVectors(variableContainer, nData, phi, weight, id);
+
+  if ((nData > 0) && IsSelected(variableContainer)) {
+    fDataVectorSpans.push_back({nData, phi, weight, id, nullptr});
+    return kTRUE;
+  }
+  return kFALSE;
+}
+
+/// New raw Q vector sums for the detector configuration.
+/// A check is made to see if the current variable bank content passes
+/// the associated cuts. If so, the sums are accepted.
+///
+/// The data vectors have already been accumulated so they do not go through
+/// any data vector bank. The passed sums are kept and consumed in place when
+/// the Qn vectors are built, so they must stay unchanged until the event has
+/// been processed. Sums without contributions are ignored.
+/// \param variableContainer pointer to the variable content bank
+/// \param sums the raw sums of the data vectors
+/// \param id the Id shared by the data vectors, the bin for differential configurations
+/// \return kTRUE if the sums were accepted
+inline Bool_t DetectorConfigurationTracks::AddQnVectorSums(const double *variableContainer,
+                                                           const CorrectionQnVectorSums *sums,
+                                                           Int_t id) {
+  if ((fNoOfBins > 0) && (id < 0)) {
+    QnCorrectionsFatal(Form("The differential detector configuration %s needs the bin of the raw Q vector sums. " \
+        "FIX IT, PLEASE.", GetName()));
+    return kFALSE;
+  }
+
+  if ((sums->GetN() > 0) && IsSelected(variableContainer)) {
+    fDataVectorSpans.push_back({0, nullptr, nullptr, id, sums});
+    return kTRUE;
+  }
+  return kFALSE;
+}
+
 /// Clean the configuration to accept a new event
 ///
 /// Transfers the order to the Q vector correction steps and
 /// cleans the own Q vector and the input data vector bank
 /// for accepting the next event.
 inline void DetectorConfigurationTracks::ClearConfiguration() {
+  ClearQnVectors();
+  /* and now clear the the input data bank */
+  fDataVectorBank->Clear("C");
+  fDataVectorSpans.clear();
+}
+
+/// Clean the Q vectors
+///
+/// Transfers the order to the Q vector correction steps and
+/// cleans the own Q vectors. The input data vector bank is kept.
+inline void DetectorConfigurationTracks::ClearQnVectors() {
   /* transfer the order to the Q vector corrections */
   for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
     fQnVectorCorrections.At(ixCorrection)->ClearCorrectionStep();
@@ -137,8 +252,6 @@ inline void DetectorConfigurationTracks::ClearConfiguration() {
   fPlainQ2nVector.Reset();
   fCorrectedQnVector.Reset();
   fCorrectedQ2nVector.Reset();
-  /* and now clear the the input data bank */
-  fDataVectorBank->Clear("C");
 }
 
 /// Builds Qn vectors before Q vector corrections but
@@ -147,13 +260,39 @@ inline void DetectorConfigurationTracks::ClearConfiguration() {
 /// approach so, the built Q vectors are the ones to be used for
 /// subsequent corrections.
 inline void DetectorConfigurationTracks::BuildQnVector() {
+  fBuildSpans.clear();
+  /* gather the data vectors stored one by one to build the Q vectors in batches */
+  Int_t nData = fDataVectorBank->GetEntriesFast();
+  if (nData > 0) {
+    fPhiBuffer.resize(nData);
+    fWeightBuffer.resize(nData);
+    for (Int_t ixData = 0; ixData < nData; ixData++) {
+      CorrectionDataVector *dataVector = static_cast<CorrectionDataVector *>(fDataVectorBank->At(ixData));
+      fPhiBuffer[ixData] = dataVector->Phi();
+      fWeightBuffer[ixData] = dataVector->Weight();
+    }
+    fBuildSpans.push_back({nData, fPhiBuffer.data(), fWeightBuffer.data(), -1, nullptr});
+  }
+  /* the data vectors handed in bulk are used in place */
+  fBuildSpans.insert(fBuildSpans.end(), fDataVectorSpans.begin(), fDataVectorSpans.end());
+  BuildQnVector(Int_t(fBuildSpans.size()), fBuildSpans.data());
+}
+
+/// Builds Qn vectors out of the passed sets of data vectors
+/// \param nSpans the number of sets of data vectors
+/// \param spans the sets of data vectors
+inline void DetectorConfigurationTracks::BuildQnVector(Int_t nSpans, const DataVectorSpan *spans) {
   fTempQnVector.Reset();
   fTempQ2nVector.Reset();
 
-  for (Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++) {
-    CorrectionDataVector *dataVector = static_cast<CorrectionDataVector *>(fDataVectorBank->At(ixData));
-    fTempQnVector.Add(dataVector->Phi(), dataVector->Weight());
-    fTempQ2nVector.Add(dataVector->Phi(), dataVector->Weight());
+  for (Int_t ixSpan = 0; ixSpan < nSpans; ixSpan++) {
+    if (spans[ixSpan].fSums!=nullptr) {
+      fTempQnVector.Add(*spans[ixSpan].fSums);
+      fTempQ2nVector.Add(*spans[ixSpan].fSums);
+    } else {
+      fTempQnVector.Add(spans[ixSpan].fNoOfData, spans[ixSpan].fPhi, spans[ixSpan].fWeight);
+      fTempQ2nVector.Add(spans[ixSpan].fNoOfData, spans[ixSpan].fPhi, spans[ixSpan].fWeight);
+    }
   }
   /* check the quality of the Qn vector */
   fTempQnVector.CheckQuality();
@@ -169,9 +308,13 @@ inline void DetectorConfigurationTracks::BuildQnVector() {
 /// Ask for processing corrections for the involved detector configuration
 ///
 /// The request is transmitted to the Q vector correction steps.
-/// The first not applied correction step breaks the loop and kFALSE is returned
+/// The first not applied correction step breaks the loop and kFALSE is returned.
+/// Differential configurations process their bins at data collection time.
 /// \return kTRUE if all correction steps were applied
 inline Bool_t DetectorConfigurationTracks::ProcessCorrections(const double *variableContainer) {
+  if (fNoOfBins > 0)
+    return kTRUE;
+
   /* first we build the Q vector with the chosen calibration */
   BuildQnVector();
 
@@ -193,6 +336,8 @@ inline Bool_t DetectorConfigurationTracks::ProcessCorrections(const double *vari
 /// The first not applied correction step breaks the loop and kFALSE is returned
 /// \return kTRUE if all correction steps were applied
 inline Bool_t DetectorConfigurationTracks::ProcessDataCollection(const double *variableContainer) {
+  if (fNoOfBins > 0)
+    return ProcessBinnedDataCollection(variableContainer);
 
   /* fill QA information */
   FillQAHistograms(variableContainer);
@@ -28,6 +28,7 @@
 
 #include <TObject.h>
 #include <TObjArray.h>
+#include <TMath.h>
 
 namespace Qn {
 class EventClassVariable : public TObject {
@@ -59,6 +60,17 @@ class EventClassVariable : public TObject {
   Double_t GetLowerEdge() { return fBins[0]; }
   /// Gets the highest variabel value considered
   Double_t GetUpperEdge() { return fBins[fNBins]; }
+  /// Gets the bin number for the passed variable value
+  ///
+  /// Follows the histogram axis convention: zero for underflow
+  /// and the number of bins plus one for overflow
+  /// \param value the variable value
+  /// \return the bin number
+  Int_t FindBin(Double_t value) const {
+    if (value < fBins[0]) return 0;
+    if (!(value < fBins[fNBins])) return fNBins + 1;
+    return 1 + TMath::BinarySearch(fNBinsPlusOne, fBins, value);
+  }
 
  private:
   Int_t fVarId;        ///< The external Id for the variable in the data bank
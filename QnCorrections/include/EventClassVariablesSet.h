@@ -13,6 +13,7 @@
 /// \file QnCorrectionsEventClassVariablesSet.h
 /// \brief Class that models the set of variables that define an event class for the Q vector correction framework
 
+#include <vector>
 #include "EventClassVariable.h"
 namespace Qn {
 /// \class QnCorrectionsEventClassVariablesSet
@@ -61,6 +62,15 @@ class EventClassVariablesSet : public TObjArray {
   }
 
   void GetMultidimensionalConfiguration(Int_t *nbins, Double_t *minvals, Double_t *maxvals);
+  void UpdateEventClassBin(const double *variableContainer);
+  /// Gets the event class bin of the current event
+  ///
+  /// Only valid after UpdateEventClassBin has been called for the event
+  /// \return the bin number, histogram axis convention, on each variable
+  const Int_t *GetEventClassBin() const { return fEventClassBin.data(); }
+
+ private:
+  std::vector<Int_t> fEventClassBin; //!<! the bin number of the current event on each variable
 
 /// \cond CLASSIMP
  ClassDef(EventClassVariablesSet, 1);
@@ -152,6 +152,8 @@ class GainEqualization : public CorrectionOnInputData {
   /// Does nothing for the time being
   virtual void ClearCorrectionStep() {}
   virtual Bool_t ReportUsage(TList *calibrationList, TList *applyList);
+  virtual void ExportCalibrationSnapshot(TList *list);
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const;
 
  private:
   static const Float_t
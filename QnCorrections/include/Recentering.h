@@ -134,6 +134,9 @@ class Recentering : public CorrectionOnQvector {
   virtual void ClearCorrectionStep();
   virtual Bool_t IsBeingApplied() const;
   virtual Bool_t ReportUsage(TList *calibrationList, TList *applyList);
+  virtual void FlushHistogramFills();
+  virtual void ExportCalibrationSnapshot(TList *list);
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const;
 
  private:
   static const Int_t fDefaultMinNoOfEntries;         ///< the minimum number of entries for bin content validation
@@ -179,6 +179,9 @@ class TwistAndRescale : public CorrectionOnQvector {
   virtual void IncludeCorrectedQnVector(TList *list);
   virtual Bool_t IsBeingApplied() const;
   virtual Bool_t ReportUsage(TList *calibrationList, TList *applyList);
+  virtual void FlushHistogramFills();
+  virtual void ExportCalibrationSnapshot(TList *list);
+  virtual void PrepareCalibrationSnapshot(TList *source, TList *list) const;
 
  private:
   static const Int_t fDefaultMinNoOfEntries;         ///< the minimum number of entries for bin content validation
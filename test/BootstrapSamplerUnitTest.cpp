@@ -25,6 +25,28 @@ TEST(BootStrapSamplerTest, Constructor) {
     EXPECT_EQ(nevents, size_of_sample[i]);
   }
 }
+
+TEST(BootStrapSamplerTest, PoissonBootstrap) {
+  const int nsamples = 100;
+  const int nevents = 10000;
+  Qn::Sampler test(nevents, Qn::Sampler::Method::POISSONBOOTSTRAP, nsamples, 42);
+  Qn::Sampler other(0, Qn::Sampler::Method::POISSONBOOTSTRAP, nsamples, 42);
+  test.CreateSamples();
+  EXPECT_TRUE(test.GetSamples().empty());
+  std::array<int, nsamples> size_of_sample{{0}};
+  std::vector<Qn::Sampler::size_type> buffer;
+  std::vector<Qn::Sampler::size_type> other_buffer;
+  for (int ievent = nevents - 1; ievent >= 0; --ievent) {
+    const auto &samples = test.GetFillVector(ievent, buffer);
+    EXPECT_EQ(samples, other.GetFillVector(ievent, other_buffer));
+    for (auto b : samples) {
+      size_of_sample[b] += 1;
+    }
+  }
+  for (int i = 0; i < nsamples; ++i) {
+    EXPECT_NEAR(nevents, size_of_sample[i], 5*std::sqrt(nevents));
+  }
+}
 //
 //TEST(BootStrapSamplerTest, Constructor3) {
 //  const int nsamples = 50;
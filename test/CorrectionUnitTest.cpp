@@ -1,8 +1,19 @@
 
 
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include "gtest/gtest.h"
 #include "CorrectionManager.h"
+#include "CorrectionQnVectorBuild.h"
+#include "CorrectionQnVectorSums.h"
+#include "CorrectionProfileComponents.h"
+#include "CorrectionProfileAccumulator.h"
+#include "CorrectionCalibrationCache.h"
+#include "CorrectionProfile3DCorrelations.h"
+#include "TTreeReader.h"
+#include "TTreeReaderValue.h"
+#include "THnBase.h"
 
 
 TEST(CorrectionUnitTest, Correction) {
@@ -92,4 +103,678 @@ TEST(CorrectionUnitTest, Correction) {
   calibqalist->Write(calibqalist->GetName(),TDirectoryFile::kSingleKey);
   treefile->Close();
   delete treefile;
-}
\ No newline at end of file
+}
+
+TEST(CorrectionUnitTest, ChannelHarmonicTables) {
+  const int nchannels = 8;
+  const int nharmonics = 4;
+  const int tablesize = 2*MAXHARMONICNUMBERSUPPORTED + 1;
+  std::default_random_engine gen;
+  std::uniform_real_distribution<double> piform(0, 2*TMath::Pi());
+  std::uniform_real_distribution<double> weightform(-0.2, 2.);
+  double cosTable[tablesize*nchannels];
+  double sinTable[tablesize*nchannels];
+  float phi[nchannels];
+  for (int ich = 0; ich < nchannels; ++ich) {
+    phi[ich] = piform(gen);
+    for (int k = 0; k < tablesize; ++k) {
+      cosTable[k*nchannels + ich] = TMath::Cos(k*phi[ich]);
+      sinTable[k*nchannels + ich] = TMath::Sin(k*phi[ich]);
+    }
+  }
+  for (int multiplier = 1; multiplier <= 2; ++multiplier) {
+    Qn::CorrectionQnVectorBuild expected("expected", nharmonics);
+    Qn::CorrectionQnVectorBuild tables("tables", nharmonics);
+    expected.SetHarmonicMultiplier(multiplier);
+    tables.SetHarmonicMultiplier(multiplier);
+    double weights[nchannels];
+    for (int ich = 0; ich < nchannels; ++ich) {
+      weights[ich] = weightform(gen);
+      expected.Add(phi[ich], weights[ich]);
+    }
+    tables.Add(nchannels, weights, cosTable, sinTable);
+    EXPECT_EQ(expected.GetN(), tables.GetN());
+    EXPECT_FLOAT_EQ(expected.GetSumOfWeights(), tables.GetSumOfWeights());
+    for (int h = 1; h <= nharmonics; ++h) {
+      EXPECT_NEAR(expected.Qx(h), tables.Qx(h), 1e-5);
+      EXPECT_NEAR(expected.Qy(h), tables.Qy(h), 1e-5);
+    }
+  }
+}
+
+TEST(CorrectionUnitTest, BatchedTrackQnVectorBuild) {
+  const int ntracks = 2000;
+  const int nharmonics = 8;
+  std::default_random_engine gen;
+  std::uniform_real_distribution<float> piform(0, 2*TMath::Pi());
+  std::uniform_real_distribution<float> weightform(-0.2, 2.);
+  std::vector<float> phi(ntracks);
+  std::vector<float> weights(ntracks);
+  for (int i = 0; i < ntracks; ++i) {
+    phi[i] = piform(gen);
+    weights[i] = weightform(gen);
+  }
+  for (int multiplier = 1; multiplier <= 2; ++multiplier) {
+    Qn::CorrectionQnVectorBuild expected("expected", nharmonics);
+    Qn::CorrectionQnVectorBuild batched("batched", nharmonics);
+    expected.SetHarmonicMultiplier(multiplier);
+    batched.SetHarmonicMultiplier(multiplier);
+    for (int i = 0; i < ntracks; ++i) {
+      expected.Add(phi[i], weights[i]);
+    }
+    batched.Add(ntracks, phi.data(), weights.data());
+    EXPECT_EQ(expected.GetN(), batched.GetN());
+    EXPECT_FLOAT_EQ(expected.GetSumOfWeights(), batched.GetSumOfWeights());
+    for (int h = 1; h <= nharmonics; ++h) {
+      EXPECT_NEAR(expected.Qx(h), batched.Qx(h), 1e-3);
+      EXPECT_NEAR(expected.Qy(h), batched.Qy(h), 1e-3);
+    }
+  }
+}
+
+TEST(CorrectionUnitTest, StreamingQnVectorSums) {
+  const int ntracks = 2000;
+  const int nharmonics = 8;
+  std::default_random_engine gen;
+  std::uniform_real_distribution<float> piform(0, 2*TMath::Pi());
+  std::uniform_real_distribution<float> weightform(-0.2, 2.);
+  Qn::CorrectionQnVectorSums sums;
+  sums.SetHighestMultiple(2*nharmonics);
+  std::vector<float> phi(ntracks);
+  std::vector<float> weights(ntracks);
+  for (int i = 0; i < ntracks; ++i) {
+    phi[i] = piform(gen);
+    weights[i] = weightform(gen);
+    sums.Add(phi[i], weights[i]);
+  }
+  for (int multiplier = 1; multiplier <= 2; ++multiplier) {
+    Qn::CorrectionQnVectorBuild expected("expected", nharmonics);
+    Qn::CorrectionQnVectorBuild streamed("streamed", nharmonics);
+    expected.SetHarmonicMultiplier(multiplier);
+    streamed.SetHarmonicMultiplier(multiplier);
+    for (int i = 0; i < ntracks; ++i) {
+      expected.Add(phi[i], weights[i]);
+    }
+    streamed.Add(sums);
+    EXPECT_EQ(expected.GetN(), streamed.GetN());
+    EXPECT_FLOAT_EQ(expected.GetSumOfWeights(), streamed.GetSumOfWeights());
+    for (int h = 1; h <= nharmonics; ++h) {
+      EXPECT_NEAR(expected.Qx(h), streamed.Qx(h), 1e-3);
+      EXPECT_NEAR(expected.Qy(h), streamed.Qy(h), 1e-3);
+    }
+  }
+}
+
+TEST(CorrectionUnitTest, EventClassBin) {
+  double centbins[] = {0., 5., 10., 20., 40., 80.};
+  Qn::EventClassVariable centrality(0, "Centrality", 5, centbins);
+  Qn::EventClassVariable vertex(1, "VtxZ", 8, -10., 10.);
+  Qn::EventClassVariablesSet set(2);
+  set.Add(&centrality);
+  set.Add(&vertex);
+  Qn::CorrectionProfileComponents byvalue("byvalue", "byvalue", set);
+  Qn::CorrectionProfileComponents bybin("bybin", "bybin", set);
+  TList list;
+  list.SetOwner(kTRUE);
+  byvalue.CreateComponentsProfileHistograms(&list, 2);
+  bybin.CreateComponentsProfileHistograms(&list, 2);
+  std::default_random_engine gen;
+  std::uniform_real_distribution<double> centform(-5., 90.);
+  std::uniform_real_distribution<double> vtxform(-12., 12.);
+  double values[2];
+  for (int i = 0; i < 1000; ++i) {
+    values[0] = centform(gen);
+    values[1] = vtxform(gen);
+    set.UpdateEventClassBin(values);
+    const Int_t *eventClassBin = set.GetEventClassBin();
+    EXPECT_EQ(byvalue.GetBin(values), bybin.GetBin(eventClassBin));
+    for (int h = 1; h <= 2; ++h) {
+      byvalue.FillX(h, values, values[0]);
+      byvalue.FillY(h, values, values[1]);
+      bybin.FillX(h, eventClassBin, values[0]);
+      bybin.FillY(h, eventClassBin, values[1]);
+    }
+  }
+  byvalue.FlushFills();
+  bybin.FlushFills();
+  for (int icent = 0; icent < 5; ++icent) {
+    for (int ivtx = 0; ivtx < 8; ++ivtx) {
+      values[0] = 0.5*(centbins[icent] + centbins[icent + 1]);
+      values[1] = -10. + 2.5*ivtx + 1.25;
+      Long64_t bin = byvalue.GetBin(values);
+      for (int h = 1; h <= 2; ++h) {
+        EXPECT_FLOAT_EQ(byvalue.GetXBinContent(h, bin), bybin.GetXBinContent(h, bin));
+        EXPECT_FLOAT_EQ(byvalue.GetYBinContent(h, bin), bybin.GetYBinContent(h, bin));
+      }
+    }
+  }
+}
+
+TEST(CorrectionUnitTest, ProfileAccumulator) {
+  Int_t nbins[2] = {4, 3};
+  Double_t minvals[2] = {0., -1.};
+  Double_t maxvals[2] = {8., 2.};
+  THnF direct("direct", "direct", 2, nbins, minvals, maxvals);
+  THnF flushed("flushed", "flushed", 2, nbins, minvals, maxvals);
+  THnI entries("entries", "entries", 2, nbins, minvals, maxvals);
+  direct.Sumw2();
+  flushed.Sumw2();
+  Qn::CorrectionProfileAccumulator accumulator;
+  accumulator.Allocate(direct.GetNbins(), 2);
+  std::default_random_engine gen;
+  std::uniform_real_distribution<double> xform(-1., 9.);
+  std::uniform_real_distribution<double> yform(-2., 3.);
+  std::normal_distribution<double> wform(0., 1.);
+  Double_t x[2];
+  for (int i = 0; i < 1000; ++i) {
+    x[0] = xform(gen);
+    x[1] = yform(gen);
+    Double_t w = wform(gen);
+    Long64_t bin = direct.GetBin(x);
+    direct.Fill(x, w);
+    accumulator.Fill(bin, 1, w);
+    accumulator.Fill(bin, 0, 1.0);
+  }
+  EXPECT_TRUE(accumulator.IsPending());
+  accumulator.Flush(1, &flushed);
+  accumulator.Flush(0, &entries);
+  accumulator.Reset();
+  EXPECT_FALSE(accumulator.IsPending());
+  EXPECT_EQ(direct.GetEntries(), flushed.GetEntries());
+  EXPECT_EQ(1000, entries.GetEntries());
+  Double_t nentries = 0.;
+  for (Long64_t bin = 0; bin < direct.GetNbins(); ++bin) {
+    EXPECT_FLOAT_EQ(direct.GetBinContent(bin), flushed.GetBinContent(bin));
+    EXPECT_NEAR(direct.GetBinError2(bin), flushed.GetBinError2(bin), 1e-4);
+    nentries += entries.GetBinContent(bin);
+  }
+  EXPECT_EQ(1000, nentries);
+}
+
+TEST(CorrectionUnitTest, Profile3DCorrelationsAccessors) {
+  using Qn::CorrectionProfile3DCorrelations;
+  Qn::EventClassVariable centrality(0, "Centrality", 4, 0., 80.);
+  Qn::EventClassVariablesSet set(1);
+  set.Add(&centrality);
+  CorrectionProfile3DCorrelations profile("corr", "corr", "A", "B", "C", set);
+  TList list;
+  list.SetOwner(kTRUE);
+  profile.CreateCorrelationComponentsProfileHistograms(&list, 2);
+  profile.SetNoOfEntriesThreshold(1);
+  Qn::CorrectionQnVector qa("A", 2), qb("B", 2), qc("C", 2);
+  qa.SetGood(kTRUE);
+  qb.SetGood(kTRUE);
+  qc.SetGood(kTRUE);
+  std::default_random_engine gen;
+  std::uniform_real_distribution<float> qform(-1., 1.);
+  double values[1];
+  for (int i = 0; i < 400; ++i) {
+    for (int h = 1; h <= 2; ++h) {
+      qa.SetQx(h, qform(gen));
+      qa.SetQy(h, qform(gen));
+      qb.SetQx(h, qform(gen));
+      qb.SetQy(h, qform(gen));
+      qc.SetQx(h, qform(gen));
+      qc.SetQy(h, qform(gen));
+    }
+    values[0] = 0.2*i;
+    profile.Fill(&qa, &qb, &qc, values);
+  }
+  profile.FlushFills();
+  const char *names[CorrectionProfile3DCorrelations::kNoOfCombinations] = {"AB", "BC", "AC"};
+  CorrectionProfile3DCorrelations::QnCorrelationComponents correlations;
+  for (int icent = 0; icent < 4; ++icent) {
+    values[0] = 10. + 20.*icent;
+    Long64_t bin = profile.GetBin(values);
+    for (int h = 1; h <= 2; ++h) {
+      EXPECT_TRUE(profile.GetBinCorrelations(h, bin, correlations));
+      for (int ic = 0; ic < CorrectionProfile3DCorrelations::kNoOfCombinations; ++ic) {
+        auto comb = CorrectionProfile3DCorrelations::QnCorrelationCombination(ic);
+        EXPECT_FLOAT_EQ(profile.GetXXBinContent(names[ic], h, bin), profile.GetXXBinContent(comb, h, bin));
+        EXPECT_FLOAT_EQ(profile.GetYYBinError(names[ic], h, bin), profile.GetYYBinError(comb, h, bin));
+        EXPECT_FLOAT_EQ(profile.GetXXBinContent(comb, h, bin), correlations.fXX[ic]);
+        EXPECT_FLOAT_EQ(profile.GetXYBinContent(comb, h, bin), correlations.fXY[ic]);
+        EXPECT_FLOAT_EQ(profile.GetYXBinContent(comb, h, bin), correlations.fYX[ic]);
+        EXPECT_FLOAT_EQ(profile.GetYYBinContent(comb, h, bin), correlations.fYY[ic]);
+      }
+    }
+  }
+}
+
+TEST(CorrectionUnitTest, DifferentialDetector) {
+  using namespace Qn;
+  enum values {
+    kCent,
+    kPhi,
+    kPt
+  };
+  Qn::CorrectionManager man;
+  auto tree = new TTree("tree", "tree");
+  tree->SetDirectory(nullptr);
+  man.SetTree(tree);
+  man.AddVariable("Cent", kCent, 1);
+  man.AddVariable("Phi", kPhi, 1);
+  man.AddVariable("Pt", kPt, 1);
+  auto correction = [](Qn::DetectorConfiguration *config) {
+    config->SetNormalization(Qn::QVector::Normalization::M);
+    config->AddCorrectionOnQnVector(new Qn::Recentering());
+  };
+  man.AddDetector("Bins", DetectorType::TRACK, "Phi", "Ones", {{"Pt", 4, 0, 2}}, {1, 2});
+  man.SetCorrectionSteps("Bins", correction);
+  man.AddDetector("Differential", DetectorType::TRACK, "Phi", "Ones", {{"Pt", 4, 0, 2}}, {1, 2});
+  man.SetCorrectionSteps("Differential", correction);
+  man.SetDifferentialMode("Differential");
+  man.AddCorrectionAxis({"Cent", 10, 0, 100});
+  man.Initialize(nullptr);
+  man.SetProcessName("test");
+
+  std::default_random_engine gen;
+  std::uniform_real_distribution<double> uniform(0, 100);
+  std::uniform_real_distribution<double> piform(0, 2*TMath::Pi());
+  std::uniform_real_distribution<double> ptform(0, 2);
+  auto values = man.GetVariableContainer();
+  for (unsigned int iev = 0; iev < 100; ++iev) {
+    man.Reset();
+    values[kCent] = uniform(gen);
+    man.ProcessEvent();
+    for (unsigned int itrack = 0; itrack < 50; ++itrack) {
+      values[kPhi] = piform(gen);
+      values[kPt] = ptform(gen);
+      man.FillTrackingDetectors();
+    }
+    man.ProcessQnVectors();
+  }
+
+  TTreeReader reader(tree);
+  TTreeReaderValue<Qn::DataContainerQVector> bins(reader, "Bins");
+  TTreeReaderValue<Qn::DataContainerQVector> differential(reader, "Differential");
+  while (reader.Next()) {
+    ASSERT_EQ(bins->size(), differential->size());
+    for (std::size_t ibin = 0; ibin < bins->size(); ++ibin) {
+      const auto &expected = bins->At(ibin);
+      const auto &result = differential->At(ibin);
+      EXPECT_EQ(expected.n(), result.n());
+      for (unsigned int h = 1; h <= 2; ++h) {
+        EXPECT_FLOAT_EQ(expected.x(h), result.x(h));
+        EXPECT_FLOAT_EQ(expected.y(h), result.y(h));
+      }
+    }
+  }
+  delete tree;
+}
+
+TEST(CorrectionUnitTest, SelectionMask) {
+  const std::size_t size = 130;
+  Qn::SelectionMask all;
+  all.Reset(size);
+  EXPECT_EQ(all.size(), size);
+  EXPECT_EQ(all.Count(), size);
+  Qn::SelectionMask even;
+  even.Fill(size, [](std::size_t i) { return i%2==0; });
+  Qn::SelectionMask low;
+  low.Fill(size, [](std::size_t i) { return i < 100; });
+  all &= even;
+  all &= low;
+  EXPECT_EQ(all.Count(), 50u);
+  std::size_t n = 0;
+  all.ForEachSelected([&n](std::size_t i) {
+    EXPECT_EQ(i, 2*n);
+    ++n;
+  });
+  EXPECT_EQ(n, 50u);
+  EXPECT_TRUE(all.Test(98));
+  EXPECT_FALSE(all.Test(99));
+  EXPECT_FALSE(all.Test(128));
+}
+
+TEST(CorrectionUnitTest, CutExpression) {
+  Qn::VariableManager manager;
+  manager.CreateVariable("Pt", 0, 1);
+  manager.CreateVariable("Eta", 1, 1);
+  auto values = manager.GetVariableContainer();
+  auto expression = Qn::MakeUniqueExpressionCut(manager, Qn::Within("Pt", 0.2, 2.) && !Qn::Below("Eta", 0.));
+  auto lambda = Qn::MakeUniqueNDimCut({manager.FindVariable("Pt"), manager.FindVariable("Eta")},
+                                      [](double &pt, double &eta) { return 0.2 < pt && pt < 2. && !(eta < 0.); });
+  EXPECT_EQ(expression->Name(), "(0.2<Pt<2&&!Eta<0)");
+  std::default_random_engine gen;
+  std::uniform_real_distribution<double> ptform(0, 3);
+  std::uniform_real_distribution<double> etaform(-1, 1);
+  const std::size_t ntracks = 200;
+  std::vector<double> pt(ntracks);
+  std::vector<double> eta(ntracks);
+  for (std::size_t i = 0; i < ntracks; ++i) {
+    pt[i] = values[0] = ptform(gen);
+    eta[i] = values[1] = etaform(gen);
+    EXPECT_EQ(lambda->Check(0), expression->Check(0));
+  }
+  Qn::VariableColumns columns(values);
+  columns.SetSize(ntracks);
+  columns.SetColumn(manager.FindVariable("Pt"), pt.data());
+  columns.SetColumn(manager.FindVariable("Eta"), eta.data());
+  Qn::SelectionMask expected;
+  Qn::SelectionMask result;
+  lambda->Check(columns, expected);
+  expression->Check(columns, result);
+  for (std::size_t i = 0; i < ntracks; ++i) {
+    EXPECT_EQ(expected.Test(i), result.Test(i));
+  }
+}
+
+TEST(CorrectionUnitTest, DerivedVariable) {
+  Qn::VariableManager manager;
+  manager.CreateVariable("Px", 0, 1);
+  manager.CreateVariable("Py", 1, 1);
+  manager.CreateVariable("Scale", 2, 1);
+  manager.CreateDerivedVariable("Pt", {"Px", "Py"}, [](double px, double py) { return std::sqrt(px*px + py*py); });
+  manager.CreateDerivedVariable("ScaledPt", {"Pt", "Scale"}, [](double pt, double scale) { return pt*scale; });
+  auto values = manager.GetVariableContainer();
+  auto pt = manager.FindVariable("Pt");
+  auto scaledpt = manager.FindVariable("ScaledPt");
+  values[0] = 3.;
+  values[1] = 4.;
+  values[2] = 2.;
+  manager.EvaluateDerivedVariables();
+  EXPECT_DOUBLE_EQ(*pt.begin(), 5.);
+  EXPECT_DOUBLE_EQ(*scaledpt.begin(), 10.);
+
+  std::vector<double> px = {1., 6., 0.};
+  std::vector<double> py = {0., 8., 2.};
+  Qn::VariableColumns columns(values);
+  columns.SetSize(px.size());
+  columns.SetColumn(manager.FindVariable("Px"), px.data());
+  columns.SetColumn(manager.FindVariable("Py"), py.data());
+  manager.EvaluateDerivedVariables(columns);
+  ASSERT_NE(columns.Column(scaledpt), nullptr);
+  EXPECT_DOUBLE_EQ(columns.Value(pt, 0), 1.);
+  EXPECT_DOUBLE_EQ(columns.Value(pt, 1), 10.);
+  EXPECT_DOUBLE_EQ(columns.Value(scaledpt, 1), 20.);
+  EXPECT_DOUBLE_EQ(columns.Value(scaledpt, 2), 4.);
+}
+
+namespace {
+enum TrackVariables {
+  kTrackCent,
+  kTrackPhi,
+  kTrackPt
+};
+
+/// Configures the variables, the recentered "Tracks" detector and the correction axis shared by the track tests.
+void ConfigureTracks(Qn::CorrectionManager &man) {
+  man.AddVariable("Cent", kTrackCent, 1);
+  man.AddVariable("Phi", kTrackPhi, 1);
+  man.AddVariable("Pt", kTrackPt, 1);
+  man.AddDetector("Tracks", Qn::DetectorType::TRACK, "Phi", "Ones", {{"Pt", 4, 0, 2}}, {1, 2});
+  man.SetCorrectionSteps("Tracks", [](Qn::DetectorConfiguration *config) {
+    config->SetNormalization(Qn::QVector::Normalization::M);
+    config->AddCorrectionOnQnVector(new Qn::Recentering());
+  });
+  man.AddCorrectionAxis({"Cent", 10, 0, 100});
+}
+
+/// Random events with the track variables stored as columns.
+struct TrackEvents {
+  TrackEvents(std::size_t nevents_, std::size_t ntracks_) :
+      nevents(nevents_), ntracks(ntracks_), cent(nevents), phi(nevents*ntracks), pt(nevents*ntracks) {
+    std::default_random_engine gen;
+    std::uniform_real_distribution<double> uniform(0, 100);
+    std::uniform_real_distribution<double> piform(0, 2*TMath::Pi());
+    std::uniform_real_distribution<double> ptform(0, 2);
+    for (std::size_t iev = 0; iev < nevents; ++iev) {
+      cent[iev] = uniform(gen);
+      for (std::size_t itrack = 0; itrack < ntracks; ++itrack) {
+        phi[iev*ntracks + itrack] = piform(gen);
+        pt[iev*ntracks + itrack] = ptform(gen);
+      }
+    }
+  }
+
+  /// Processes the events [first, last) with the columnar track input.
+  void Process(Qn::CorrectionManager &man, std::size_t first, std::size_t last) const {
+    auto values = man.GetVariableContainer();
+    for (std::size_t iev = first; iev < last; ++iev) {
+      man.Reset();
+      values[kTrackCent] = cent[iev];
+      man.ProcessEvent();
+      man.FillTrackingDetectors(ntracks, {{"Phi", &phi[iev*ntracks]}, {"Pt", &pt[iev*ntracks]}});
+      man.ProcessQnVectors();
+    }
+  }
+
+  std::size_t nevents;
+  std::size_t ntracks;
+  std::vector<double> cent;
+  std::vector<double> phi;
+  std::vector<double> pt;
+};
+
+void ExpectEqualBin(double expected, double result, const char *name) {
+  EXPECT_NEAR(expected, result, 1e-5*std::max(1., std::abs(expected))) << name;
+}
+
+void ExpectEqualHistograms(TList *expected, TList *result) {
+  ASSERT_NE(expected, nullptr);
+  ASSERT_NE(result, nullptr);
+  ASSERT_EQ(expected->GetEntries(), result->GetEntries());
+  TIter next(expected);
+  while (auto object = next()) {
+    auto other = result->FindObject(object->GetName());
+    ASSERT_NE(other, nullptr) << object->GetName();
+    if (object->InheritsFrom(TList::Class())) {
+      ExpectEqualHistograms(static_cast<TList *>(object), static_cast<TList *>(other));
+    } else if (object->InheritsFrom(THnBase::Class())) {
+      auto histogram = static_cast<THnBase *>(object);
+      auto other_histogram = static_cast<THnBase *>(other);
+      EXPECT_DOUBLE_EQ(histogram->GetEntries(), other_histogram->GetEntries()) << object->GetName();
+      ASSERT_EQ(histogram->GetNbins(), other_histogram->GetNbins()) << object->GetName();
+      for (Long64_t ibin = 0; ibin < histogram->GetNbins(); ++ibin) {
+        ExpectEqualBin(histogram->GetBinContent(ibin), other_histogram->GetBinContent(ibin), object->GetName());
+        ExpectEqualBin(histogram->GetBinError(ibin), other_histogram->GetBinError(ibin), object->GetName());
+      }
+    } else if (object->InheritsFrom(TH1::Class())) {
+      auto histogram = static_cast<TH1 *>(object);
+      auto other_histogram = static_cast<TH1 *>(other);
+      EXPECT_DOUBLE_EQ(histogram->GetEntries(), other_histogram->GetEntries()) << object->GetName();
+      ASSERT_EQ(histogram->GetNcells(), other_histogram->GetNcells()) << object->GetName();
+      for (Int_t ibin = 0; ibin < histogram->GetNcells(); ++ibin) {
+        ExpectEqualBin(histogram->GetBinContent(ibin), other_histogram->GetBinContent(ibin), object->GetName());
+        ExpectEqualBin(histogram->GetBinError(ibin), other_histogram->GetBinError(ibin), object->GetName());
+      }
+    }
+  }
+}
+}
+
+TEST(CorrectionUnitTest, ColumnarTrackInput) {
+  auto configure = [](Qn::CorrectionManager &man, TTree *tree) {
+    tree->SetDirectory(nullptr);
+    man.SetTree(tree);
+    ConfigureTracks(man);
+    man.AddCut("Tracks", {"Pt"}, [](double &pt) { return pt > 0.2; });
+    man.Initialize(nullptr);
+    man.SetProcessName("test");
+  };
+  Qn::CorrectionManager pertrack;
+  Qn::CorrectionManager batched;
+  auto pertracktree = new TTree("pertrack", "pertrack");
+  auto batchedtree = new TTree("batched", "batched");
+  configure(pertrack, pertracktree);
+  configure(batched, batchedtree);
+
+  const TrackEvents events(100, 50);
+  auto pertrackvalues = pertrack.GetVariableContainer();
+  for (std::size_t iev = 0; iev < events.nevents; ++iev) {
+    pertrack.Reset();
+    pertrackvalues[kTrackCent] = events.cent[iev];
+    pertrack.ProcessEvent();
+    for (std::size_t itrack = 0; itrack < events.ntracks; ++itrack) {
+      pertrackvalues[kTrackPhi] = events.phi[iev*events.ntracks + itrack];
+      pertrackvalues[kTrackPt] = events.pt[iev*events.ntracks + itrack];
+      pertrack.FillTrackingDetectors();
+    }
+    pertrack.ProcessQnVectors();
+  }
+  events.Process(batched, 0, events.nevents);
+
+  ASSERT_EQ(pertracktree->GetEntries(), batchedtree->GetEntries());
+  TTreeReader pertrackreader(pertracktree);
+  TTreeReader batchedreader(batchedtree);
+  TTreeReaderValue<Qn::DataContainerQVector> expected(pertrackreader, "Tracks");
+  TTreeReaderValue<Qn::DataContainerQVector> result(batchedreader, "Tracks");
+  while (pertrackreader.Next() && batchedreader.Next()) {
+    ASSERT_EQ(expected->size(), result->size());
+    for (std::size_t ibin = 0; ibin < expected->size(); ++ibin) {
+      EXPECT_EQ(expected->At(ibin).n(), result->At(ibin).n());
+      for (unsigned int h = 1; h <= 2; ++h) {
+        EXPECT_FLOAT_EQ(expected->At(ibin).x(h), result->At(ibin).x(h));
+        EXPECT_FLOAT_EQ(expected->At(ibin).y(h), result->At(ibin).y(h));
+      }
+    }
+  }
+  delete pertracktree;
+  delete batchedtree;
+}
+
+TEST(CorrectionUnitTest, ReplicaMerge) {
+  auto adddirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+  auto configure = [](Qn::CorrectionManager &man) {
+    ConfigureTracks(man);
+    man.AddCut("Tracks", Qn::Above("Pt", 0.2));
+    man.AddHisto1D("Tracks", {"Pt", 20, 0, 2});
+    man.AddEventHisto1D({"Cent", 10, 0, 100});
+    man.Initialize(nullptr);
+    man.SetProcessName("test");
+  };
+  const std::size_t nevents = 100;
+  const TrackEvents events(nevents, 50);
+
+  Qn::CorrectionManager serial;
+  configure(serial);
+  events.Process(serial, 0, nevents);
+  serial.Finalize();
+
+  const std::size_t nreplicas = 3;
+  std::vector<std::unique_ptr<Qn::CorrectionManager>> replicas;
+  std::vector<Qn::CorrectionManager *> replicaptrs;
+  for (std::size_t i = 0; i < nreplicas; ++i) {
+    replicas.emplace_back(new Qn::CorrectionManager());
+    configure(*replicas.back());
+    replicaptrs.push_back(replicas.back().get());
+  }
+  Qn::CorrectionManager::RunReplicas(replicaptrs, [&](Qn::CorrectionManager &man, std::size_t i) {
+    events.Process(man, i*nevents/nreplicas, (i + 1)*nevents/nreplicas);
+  });
+  TH1::AddDirectory(adddirectory);
+
+  ExpectEqualHistograms(serial.GetCalibrationList(), replicas.front()->GetCalibrationList());
+  ExpectEqualHistograms(serial.GetCalibrationQAList(), replicas.front()->GetCalibrationQAList());
+  ExpectEqualHistograms(serial.GetEventAndDetectorQAList(), replicas.front()->GetEventAndDetectorQAList());
+}
+
+TEST(CorrectionUnitTest, ProcessSwitchOnTheFly) {
+  auto adddirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+  const std::size_t nevents = 40;
+  const TrackEvents events(nevents, 20);
+
+  Qn::CorrectionManager reference;
+  ConfigureTracks(reference);
+  reference.Initialize(nullptr);
+  reference.SetProcessName("run2");
+  events.Process(reference, 0, nevents);
+  reference.Finalize();
+
+  Qn::CorrectionManager switched;
+  ConfigureTracks(switched);
+  switched.Initialize(nullptr);
+  switched.SetProcessName("run1");
+  events.Process(switched, 0, nevents/2);
+  /* the fills of run1 which are still pending need to survive the switch */
+  switched.SetProcessName("run2");
+  events.Process(switched, nevents/2, nevents);
+  switched.Finalize();
+  TH1::AddDirectory(adddirectory);
+
+  ExpectEqualHistograms(reference.GetCalibrationList(), switched.GetCalibrationList());
+}
+
+TEST(CorrectionUnitTest, CalibrationSnapshot) {
+  double centbins[] = {0., 5., 10., 20., 40., 80.};
+  Qn::EventClassVariable centrality(0, "Centrality", 5, centbins);
+  Qn::EventClassVariable vertex(1, "VtxZ", 8, -10., 10.);
+  Qn::EventClassVariablesSet set(2);
+  set.Add(&centrality);
+  set.Add(&vertex);
+  Qn::CorrectionProfileComponents calibration("profile", "profile", set);
+  TList histograms;
+  histograms.SetOwner(kTRUE);
+  calibration.CreateComponentsProfileHistograms(&histograms, 2);
+  std::default_random_engine gen;
+  std::uniform_real_distribution<double> centform(-5., 90.);
+  std::uniform_real_distribution<double> vtxform(-12., 12.);
+  std::normal_distribution<double> qform(0., 1.);
+  double values[2];
+  for (int i = 0; i < 2000; ++i) {
+    values[0] = centform(gen);
+    values[1] = vtxform(gen);
+    for (int h = 1; h <= 2; ++h) {
+      calibration.FillX(h, values, qform(gen));
+      calibration.FillY(h, values, qform(gen));
+    }
+  }
+  calibration.FlushFills();
+  Qn::CorrectionProfileComponents fromhistograms("profile", "profile", set);
+  ASSERT_TRUE(fromhistograms.AttachHistograms(&histograms));
+  TList snapshots;
+  snapshots.SetOwner(kTRUE);
+  ASSERT_TRUE(fromhistograms.ExportSnapshot(&snapshots));
+  Qn::CorrectionProfileComponents fromsnapshot("profile", "profile", set);
+  ASSERT_TRUE(fromsnapshot.AttachHistograms(&snapshots));
+  for (int i = 0; i < 1000; ++i) {
+    values[0] = centform(gen);
+    values[1] = vtxform(gen);
+    set.UpdateEventClassBin(values);
+    Long64_t bin = fromhistograms.GetBin(values);
+    EXPECT_EQ(bin, fromsnapshot.GetBin(values));
+    EXPECT_EQ(bin, fromsnapshot.GetBin(set.GetEventClassBin()));
+    EXPECT_EQ(fromhistograms.BinContentValidated(bin), fromsnapshot.BinContentValidated(bin));
+    for (int h = 1; h <= 2; ++h) {
+      EXPECT_FLOAT_EQ(fromhistograms.GetXBinContent(h, bin), fromsnapshot.GetXBinContent(h, bin));
+      EXPECT_FLOAT_EQ(fromhistograms.GetYBinContent(h, bin), fromsnapshot.GetYBinContent(h, bin));
+      EXPECT_NEAR(fromhistograms.GetXBinError(h, bin), fromsnapshot.GetXBinError(h, bin), 1e-6);
+      EXPECT_NEAR(fromhistograms.GetYBinError(h, bin), fromsnapshot.GetYBinError(h, bin), 1e-6);
+    }
+  }
+}
+
+TEST(CorrectionUnitTest, CalibrationCache) {
+  auto makelist = [](const char *name) {
+    auto list = new TList();
+    list->SetName(name);
+    list->SetOwner(kTRUE);
+    return list;
+  };
+  Qn::CorrectionCalibrationCache cache(2);
+  EXPECT_EQ(nullptr, cache.Acquire("run1"));
+  cache.Insert(makelist("run1"));
+  cache.Insert(makelist("run2"));
+  EXPECT_EQ(2, cache.GetNoOfEntries());
+  /* run1 stays in use so the least recently used run2 is evicted */
+  cache.Insert(makelist("run3"));
+  EXPECT_EQ(2, cache.GetNoOfEntries());
+  EXPECT_TRUE(cache.Contains("run1"));
+  EXPECT_FALSE(cache.Contains("run2"));
+  EXPECT_TRUE(cache.Contains("run3"));
+  /* background preparation, waited for by the acquisition */
+  cache.Prefetch("run4", [&makelist]() { return makelist("run4"); });
+  EXPECT_TRUE(cache.Contains("run4"));
+  TList *run4 = cache.Acquire("run4");
+  ASSERT_NE(nullptr, run4);
+  EXPECT_STREQ("run4", run4->GetName());
+  /* run1 was in use when the prepared run4 arrived so run3 was evicted */
+  EXPECT_TRUE(cache.Contains("run1"));
+  EXPECT_FALSE(cache.Contains("run3"));
+  cache.SetCapacity(1);
+  EXPECT_EQ(1, cache.GetNoOfEntries());
+  EXPECT_EQ(run4, cache.Acquire("run4"));
+}
@@ -96,4 +96,37 @@ TEST(CorrelationManagerTest, FullCorrelation) {
   auto end = std::chrono::steady_clock::now();
   std::cout << "Elapsed time: " << std::chrono::duration_cast<std::chrono::minutes>(end - begin).count() << " minutes"
             << std::endl;
-}
\ No newline at end of file
+}
+
+TEST(CorrelationManagerTest, ParallelIdenticalToSerial) {
+  using QVectors = Qn::QVectors;
+  auto constexpr kRef = Qn::kRef;
+  auto scalar = [](QVectors q) { return q[0].x(2)*q[1].x(2) + q[0].y(2)*q[1].y(2); };
+  auto configure = [scalar](Qn::CorrelationManager &man) {
+    man.AddEventAxis({"CentralityV0M", 70, 0., 70.});
+    man.AddEventCut({"Trigger", "CentralityV0M"}, [](float a, float c) { return a < 1. && c > 15 && c < 25; });
+    man.AddCorrelation("V0CV0A", {"V0A", "V0C"}, scalar, {kRef, kRef});
+    man.SetResampling(Qn::Sampler::Method::BOOTSTRAP, 10, 42);
+  };
+
+  auto input_file = TFile::Open("25testtree.root");
+  auto tree = dynamic_cast<TTree *>(input_file->Get("tree"));
+
+  Qn::CorrelationManager serial(tree);
+  configure(serial);
+  serial.Run();
+
+  Qn::CorrelationManager parallel(tree);
+  configure(parallel);
+  parallel.SetNumberOfThreads(4, 100);
+  parallel.Run();
+
+  auto serial_result = serial.GetResult("V0CV0A");
+  auto parallel_result = parallel.GetResult("V0CV0A");
+  ASSERT_EQ(serial_result.size(), parallel_result.size());
+  for (std::size_t i = 0; i < serial_result.size(); ++i) {
+    EXPECT_EQ(serial_result.At(i).Entries(), parallel_result.At(i).Entries());
+    EXPECT_EQ(serial_result.At(i).Mean(), parallel_result.At(i).Mean());
+    EXPECT_EQ(serial_result.At(i).BootstrapMean(), parallel_result.At(i).BootstrapMean());
+  }
+}
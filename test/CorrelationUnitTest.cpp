@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include "Correlation.h"
 #include "DataContainer.h"
+#include "ProjectionPlan.h"
 
 TEST(CorrelationTest, ConfigSameDetSameAxis) {
   auto lambda = [](const std::vector<Qn::QVectorPtr>& q) {return q[0].x(1) + q[1].x(1);};
@@ -68,4 +69,132 @@ TEST(CorrelationTest, ConfigDifferentAxes) {
   delete conta;
   delete contb;
   delete mappy;
-}
\ No newline at end of file
+}
+
+TEST(CorrelationTest, ProjectionPlan) {
+  auto function = [](Qn::QVector a, const Qn::QVector &b) {
+    a.CopyHarmonics(b);
+    auto norm = b.GetNorm();
+    return (a + b).Normal(norm);
+  };
+  Qn::DataContainerQVector input;
+  input.AddAxes({{"a", 3, 0, 3}, {"b", 4, 0, 4}});
+  float value = 1.;
+  for (auto &bin : input) {
+    bin = Qn::QVector(Qn::QVector::Normalization::M, 2, value, {{value, -value}, {0.5f*value, 2.f*value}});
+    value += 1.;
+  }
+  Qn::ProjectionPlan plan(input, {"b"});
+  Qn::ProjectionPlan integrated(input, {});
+  auto expected = input.Projection({"b"}, function);
+  auto expected_integrated = input.Projection({}, function);
+  auto output = expected;
+  auto output_integrated = expected_integrated;
+  for (int ievent = 0; ievent < 2; ++ievent) {
+    ASSERT_TRUE(plan.IsApplicable(input, output));
+    ASSERT_TRUE(integrated.IsApplicable(input, output_integrated));
+    plan.Fill(input, output);
+    integrated.Fill(input, output_integrated);
+    for (std::size_t ibin = 0; ibin < expected.size(); ++ibin) {
+      EXPECT_EQ(expected.At(ibin).n(), output.At(ibin).n());
+      EXPECT_EQ(expected.At(ibin).sumweights(), output.At(ibin).sumweights());
+      EXPECT_EQ(expected.At(ibin).x(1), output.At(ibin).x(1));
+      EXPECT_EQ(expected.At(ibin).y(1), output.At(ibin).y(1));
+      EXPECT_EQ(expected.At(ibin).x(0), output.At(ibin).x(0));
+    }
+    EXPECT_EQ(expected_integrated.At(0).sumweights(), output_integrated.At(0).sumweights());
+    EXPECT_EQ(expected_integrated.At(0).x(1), output_integrated.At(0).x(1));
+  }
+}
+
+TEST(CorrelationTest, QVectorArray) {
+  Qn::QVector qvector(Qn::QVector::Normalization::M, 3, 2.f, {{1.f, 2.f}, {3.f, 4.f}});
+  qvector.bits_.reset();
+  qvector.bits_.set(2);
+  qvector.bits_.set(4);
+  Qn::QVectorArray array(qvector);
+  Qn::QVectorPtr ptr(array);
+  EXPECT_EQ(qvector.x(2), ptr.x(2));
+  EXPECT_EQ(qvector.y(4), ptr.y(4));
+  EXPECT_FALSE(array.bits_.test(1));
+  EXPECT_EQ(3, ptr.n());
+  EXPECT_EQ(qvector.DeNormal().x(4), ptr.DeNormal().x(4));
+  auto copy = array.ToQVector();
+  EXPECT_EQ(qvector.bits_, copy.bits_);
+  EXPECT_EQ(qvector.y(2), copy.y(2));
+  EXPECT_EQ(qvector.x(4), copy.x(4));
+}
+
+TEST(CorrelationTest, FillOffsets) {
+  auto lambda = [](const std::vector<Qn::QVectorPtr> &q) { return q[0].x(1) + 10*q[1].x(1) + 100*q[2].x(1); };
+  Qn::Correlation correlation("test", {"A", "B", "C"}, lambda, {Qn::kObs, Qn::kRef, Qn::kRef});
+  std::map<std::string, Qn::DataContainerQVector *> qvectors;
+  Qn::DataContainerQVector a, b, c;
+  a.AddAxes({{"a1", 2, 0, 2}, {"a2", 3, 0, 3}});
+  c.AddAxes({{"c", 2, 0, 2}});
+  auto fill = [](Qn::DataContainerQVector &container, int n) {
+    for (std::size_t ibin = 0; ibin < container.size(); ++ibin) {
+      container.At(ibin) = Qn::QVector(Qn::QVector::Normalization::NONE, n, 1.f, {{0.f, 0.f}, {float(ibin), 0.f}});
+    }
+  };
+  fill(a, 1);
+  fill(b, 1);
+  fill(c, 1);
+  c.At(1).n_ = 0;
+  qvectors.emplace("A", &a);
+  qvectors.emplace("B", &b);
+  qvectors.emplace("C", &c);
+  correlation.Configure(&qvectors, {{"ev", 2, 0, 2}});
+  correlation.Fill({1});
+  auto result = correlation.GetResult();
+  EXPECT_EQ(2*2*3*2, result.size());
+  for (std::size_t ia1 = 0; ia1 < 2; ++ia1) {
+    for (std::size_t ia2 = 0; ia2 < 3; ++ia2) {
+      for (std::size_t ic = 0; ic < 2; ++ic) {
+        auto product = result.At({1, ia1, ia2, ic});
+        EXPECT_EQ(ic==0, product.validity);
+        if (ic==0) EXPECT_FLOAT_EQ(ia1*3 + ia2, product.result);
+        EXPECT_FALSE(result.At({0, ia1, ia2, ic}).validity);
+      }
+    }
+  }
+}
+
+TEST(CorrelationTest, Kernel) {
+  auto function = [](const std::vector<Qn::QVectorPtr> &q) { return q[0].x(1)*q[1].y(1) + q[0].y(2); };
+  auto kernel = [](const Qn::QVectorArray &a, const Qn::QVectorArray &b) { return a.x(1)*b.y(1) + a.y(2); };
+  static_assert(Qn::Details::IsCorrelationKernel<decltype(kernel), std::make_index_sequence<2>>::value, "");
+  static_assert(!Qn::Details::IsCorrelationKernel<decltype(function), std::make_index_sequence<2>>::value, "");
+  Qn::Correlation expected("expected", {"A", "B"}, function, {Qn::kObs, Qn::kObs});
+  Qn::Correlation correlation("kernel", {"A", "B"},
+                              std::make_shared<const Qn::CorrelationKernel<2, decltype(kernel)>>(kernel),
+                              {Qn::kObs, Qn::kObs});
+  std::map<std::string, Qn::DataContainerQVector *> qvectors;
+  Qn::DataContainerQVector a, b;
+  a.AddAxes({{"a", 3, 0, 3}});
+  b.AddAxes({{"b", 2, 0, 2}});
+  float value = 1.;
+  for (auto container : {&a, &b}) {
+    for (auto &bin : *container) {
+      bin = Qn::QVector(Qn::QVector::Normalization::NONE, 1, value, {{0.f, 0.f}, {value, -value}, {2*value, value}});
+      value += 1.;
+    }
+  }
+  b.At(1).n_ = 0;
+  qvectors.emplace("A", &a);
+  qvectors.emplace("B", &b);
+  expected.Configure(&qvectors, {{"ev", 2, 0, 2}});
+  correlation.Configure(&qvectors, {{"ev", 2, 0, 2}});
+  expected.Fill({1});
+  correlation.Fill({1});
+  ASSERT_EQ(expected.GetResult().size(), correlation.GetResult().size());
+  for (std::size_t ibin = 0; ibin < expected.GetResult().size(); ++ibin) {
+    const auto &e = *(expected.GetResult().begin() + ibin);
+    const auto &c = *(correlation.GetResult().begin() + ibin);
+    EXPECT_EQ(e.validity, c.validity);
+    if (e.validity) {
+      EXPECT_EQ(e.result, c.result);
+      EXPECT_EQ(e.weight, c.weight);
+    }
+  }
+}
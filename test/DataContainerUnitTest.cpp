@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 
 #include "DataContainer.h"
+#include "DataVectorArena.h"
 
 #include <TList.h>
 #include <TFile.h>
@@ -26,6 +27,38 @@ TEST(DataContainerTest, AddAxes) {
   EXPECT_EQ(100, container.size());
 }
 
+TEST(DataContainerTest, FindBin) {
+  Qn::DataContainer<float> container;
+  container.AddAxes({{"a1", 10, 0, 10}, {"a2", 5, 0, 10}});
+  EXPECT_EQ(0, container.FindBin({0.5, 0.5}));
+  EXPECT_EQ(5*3 + 2, container.FindBin({3.5, 4.5}));
+  EXPECT_EQ(container.GetIndex(5*3 + 2), (std::vector<std::size_t>{3, 2}));
+  EXPECT_EQ(-1, container.FindBin({-0.5, 4.5}));
+  EXPECT_EQ(-1, container.FindBin({3.5, 10.5}));
+  float coordinates[2] = {9.5, 9.5};
+  EXPECT_EQ(49, container.FindBin(coordinates));
+}
+
+TEST(DataContainerTest, DataVectorArena) {
+  Qn::DataVectorArena arena(3);
+  for (int ievent = 0; ievent < 2; ++ievent) {
+    arena.Clear();
+    arena.Add(2, 0.5, 1.);
+    arena.Add(0, 1.5, 2.);
+    arena.Add(2, 2.5, 3.);
+    arena.SortByBin();
+    EXPECT_EQ(3u, arena.size());
+    EXPECT_EQ(3u, arena.GetNumberOfEntries());
+    EXPECT_EQ(1u, arena.BinSize(0));
+    EXPECT_EQ(0u, arena.BinSize(1));
+    EXPECT_EQ(2u, arena.BinSize(2));
+    EXPECT_FLOAT_EQ(1.5, arena.Phi(0)[0]);
+    EXPECT_FLOAT_EQ(0.5, arena.Phi(2)[0]);
+    EXPECT_FLOAT_EQ(2.5, arena.Phi(2)[1]);
+    EXPECT_FLOAT_EQ(3., arena.Weight(2)[1]);
+  }
+}
+
 TEST(DataContainerTest, Filter) {
   Qn::DataContainer<float> container;
   container.AddAxes({{"a1", 10, 0, 10}, {"a2", 10, 0, 10}});
@@ -199,6 +232,43 @@ TEST(DataContainerTest, Select) {
   EXPECT_EQ(50, numberofbins);
 }
 //
+TEST(DataContainerTest, ProjectionRebinIndices) {
+  Qn::DataContainer<float> container;
+  container.AddAxes({{"a1", 4, 0, 4}, {"a2", 6, 0, 6}, {"a3", 3, 0, 3}});
+  float value = 0.;
+  for (auto &bin : container) {
+    bin = value;
+    value += 1.;
+  }
+  auto add = [](float a, float b) { return a + b; };
+  auto projection = container.Projection({"a1", "a3"}, add);
+  auto excluded = container.ProjectionExclude({"a1", "a3"}, add, {0, 7, 71});
+  auto rebin = container.Rebin({"a2", 3, 0, 6}, add);
+  auto select = container.Select({"a2", 2, 2, 4});
+  EXPECT_EQ(12, projection.size());
+  EXPECT_EQ(36, rebin.size());
+  EXPECT_EQ(24, select.size());
+  for (std::size_t i1 = 0; i1 < 4; ++i1) {
+    for (std::size_t i3 = 0; i3 < 3; ++i3) {
+      float sum = 0.;
+      float sumexcluded = 0.;
+      for (std::size_t i2 = 0; i2 < 6; ++i2) {
+        auto linearindex = i1*18 + i2*3 + i3;
+        sum += container.At({i1, i2, i3});
+        if (linearindex!=0 && linearindex!=7 && linearindex!=71) sumexcluded += container.At({i1, i2, i3});
+      }
+      EXPECT_FLOAT_EQ(sum, projection.At({i1, i3}));
+      EXPECT_FLOAT_EQ(sumexcluded, excluded.At({i1, i3}));
+      for (std::size_t i2 = 0; i2 < 3; ++i2) {
+        EXPECT_FLOAT_EQ(container.At({i1, 2*i2, i3}) + container.At({i1, 2*i2 + 1, i3}), rebin.At({i1, i2, i3}));
+      }
+      for (std::size_t i2 = 0; i2 < 2; ++i2) {
+        EXPECT_FLOAT_EQ(container.At({i1, i2 + 2, i3}), select.At({i1, i2, i3}));
+      }
+    }
+  }
+}
+//
 TEST(DataContainerTest, Addition) {
   Qn::DataContainer<float> container_a;
   container_a.AddAxes({{"a1", 10, 0, 10}, {"a2", 10, 0, 10}});
@@ -4,6 +4,7 @@
 
 #include "gtest/gtest.h"
 #include "Stats.h"
+#include "StatsAccumulator.h"
 #include "Sampler.h"
 #include "TH1F.h"
 #include "TCanvas.h"
@@ -399,4 +400,40 @@ TEST(StatsTest, GaussianAdditionWeightedRatio) {
   EXPECT_FLOAT_EQ(ratio_merged.Mean(),ratio_ab.Mean());
   EXPECT_FLOAT_EQ(ratio_merged.BootstrapMean(),ratio_ab.BootstrapMean());
   EXPECT_FLOAT_EQ(err_c,err_d);
-}
\ No newline at end of file
+}
+
+TEST(StatsTest, AccumulatorIdenticalToStats) {
+  std::mt19937 generator(1);
+  std::normal_distribution<double> gauss(2, 1);
+  std::uniform_real_distribution<double> uniform(0.5, 2.);
+  const int nsamples = 10;
+  const int nevents = 1000;
+  Qn::Sampler sampler(nevents, Qn::Sampler::Method::BOOTSTRAP, nsamples, 42);
+  sampler.CreateSamples();
+  Qn::DataContainerStats expected;
+  expected.AddAxes({{"a", 4, 0, 4}, {"b", 3, 0, 3}});
+  for (auto &bin : expected) { bin.SetNumberOfSubSamples(nsamples); }
+  Qn::StatsAccumulator accumulator(expected.GetAxes(), nsamples, Qn::Stats::Status::REFERENCE);
+  std::vector<Qn::Product> products(expected.size());
+  for (int i = 0; i < nevents; ++i) {
+    int ibin = 0;
+    for (auto &product : products) {
+      product = Qn::Product(gauss(generator), (i + ibin)%3!=0, uniform(generator));
+      ++ibin;
+    }
+    accumulator.Fill(products.data(), sampler.GetFillVector(i));
+    ibin = 0;
+    for (auto &bin : expected) {
+      bin.Fill(products[ibin], sampler.GetFillVector(i));
+      ++ibin;
+    }
+  }
+  auto result = accumulator.GetDataContainer();
+  ASSERT_EQ(expected.size(), result.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected.At(i).Entries(), result.At(i).Entries());
+    EXPECT_EQ(expected.At(i).Mean(), result.At(i).Mean());
+    EXPECT_EQ(expected.At(i).BootstrapMean(), result.At(i).BootstrapMean());
+    EXPECT_EQ(expected.At(i).Error(), result.At(i).Error());
+  }
+}